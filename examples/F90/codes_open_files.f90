@@ -0,0 +1,57 @@
+! (C) Copyright 2005- ECMWF.
+!
+! This software is licensed under the terms of the Apache Licence Version 2.0
+! which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+!
+! In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+! virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+!
+!
+! Open and close many files: the ids of closed files are reused
+! but a stale id must not refer to the file reopened in its place
+!
+program codes_open_files
+   use eccodes
+   implicit none
+
+   integer, parameter :: nfiles = 200, nloops = 50
+   integer, parameter :: slot_mask = 16777215  ! low 24 bits of an id
+   integer            :: ifiles(nfiles), first_ids(nfiles)
+   integer            :: i, k, ifile, iret
+   character(len=64)  :: fname
+
+   do k = 1, nloops
+      do i = 1, nfiles
+         write (fname, '(A,I0,A)') 'temp.eccodes_f_codes_open_files.', i, '.bin'
+         call codes_open_file(ifiles(i), fname, 'w')
+      end do
+
+      if (k == 1) then
+         first_ids = ifiles
+      else
+         do i = 1, nfiles
+            ! Same slot, new id
+            if (iand(ifiles(i), slot_mask) /= iand(first_ids(i), slot_mask) .or. ifiles(i) == first_ids(i)) then
+               print *, 'File id not reused: ', ifiles(i), first_ids(i)
+               stop 1
+            end if
+         end do
+      end if
+
+      do i = nfiles, 1, -1
+         call codes_close_file(ifiles(i))
+      end do
+   end do
+
+   ! A stale id cannot be closed twice
+   call codes_open_file(ifile, 'temp.eccodes_f_codes_open_files.1.bin', 'r')
+   call codes_close_file(first_ids(1), iret)
+   if (iret /= CODES_INVALID_FILE) then
+      call codes_check(iret, 'codes_close_file', 'Closing a stale file id should have failed')
+      stop 1
+   end if
+   call codes_close_file(ifile)
+
+   print *, 'Opened and closed ', nfiles*nloops, ' files'
+
+end program
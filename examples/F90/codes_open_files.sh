@@ -0,0 +1,18 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+
+. ./include.ctest.sh
+
+label='eccodes_f_codes_open_files'
+temp=temp.$label.txt
+
+${examples_dir}/eccodes_f_codes_open_files > $temp
+grep -q "Opened and closed *10000 *files" $temp
+
+rm -f $temp temp.$label.*.bin
@@ -41,6 +41,7 @@ static pthread_mutex_t read_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t multi_handle_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t iterator_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t keys_iterator_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t file_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 static void init(void) {
     pthread_mutexattr_t attr;
@@ -53,6 +54,7 @@ static void init(void) {
     pthread_mutex_init(&multi_handle_mutex,&attr);
     pthread_mutex_init(&iterator_mutex,&attr);
     pthread_mutex_init(&keys_iterator_mutex,&attr);
+    pthread_mutex_init(&file_mutex,&attr);
     pthread_mutexattr_destroy(&attr);
 }
 #elif GRIB_OMP_THREADS
@@ -63,6 +65,7 @@ static omp_nest_lock_t read_mutex;
 static omp_nest_lock_t multi_handle_mutex;
 static omp_nest_lock_t iterator_mutex;
 static omp_nest_lock_t keys_iterator_mutex;
+static omp_nest_lock_t file_mutex;
 
 static void init()
 {
@@ -75,6 +78,7 @@ static void init()
             omp_init_nest_lock(&multi_handle_mutex);
             omp_init_nest_lock(&iterator_mutex);
             omp_init_nest_lock(&keys_iterator_mutex);
+            omp_init_nest_lock(&file_mutex);
             once = 1;
         }
     }
@@ -95,55 +99,7 @@ typedef struct l_grib_file l_grib_file;
 struct l_grib_file {
     FILE* f;
     char* buffer;
-    int id;
     FileMode mode;
-    l_grib_file* next;
-};
-
-typedef struct l_grib_handle l_grib_handle;
-
-struct l_grib_handle {
-    int id;
-    grib_handle* h;
-    l_grib_handle* next;
-};
-
-typedef struct l_grib_index l_grib_index;
-
-struct l_grib_index {
-    int id;
-    grib_index* h;
-    l_grib_index* next;
-};
-
-typedef struct l_grib_multi_handle l_grib_multi_handle;
-
-struct l_grib_multi_handle {
-    int id;
-    grib_multi_handle* h;
-    l_grib_multi_handle* next;
-};
-
-typedef struct l_grib_iterator l_grib_iterator;
-
-struct l_grib_iterator {
-    int id;
-    grib_iterator* i;
-    l_grib_iterator* next;
-};
-
-typedef struct l_grib_keys_iterator l_grib_keys_iterator;
-struct l_grib_keys_iterator {
-    int id;
-    grib_keys_iterator* i;
-    l_grib_keys_iterator* next;
-};
-
-typedef struct l_bufr_keys_iterator l_bufr_keys_iterator;
-struct l_bufr_keys_iterator {
-    int id;
-    bufr_keys_iterator* i;
-    l_bufr_keys_iterator* next;
 };
 
 typedef struct l_binary_message l_binary_message;
@@ -158,16 +114,6 @@ struct l_message_info {
     size_t size;
 };
 
-static l_grib_handle* handle_set = NULL;
-static l_grib_index* index_set = NULL;
-static l_grib_multi_handle* multi_handle_set = NULL;
-static l_grib_file*   file_set   = NULL;
-/*static l_grib_iterator* iterator_set = NULL;*/
-static l_grib_keys_iterator* keys_iterator_set = NULL;
-static l_bufr_keys_iterator* bufr_keys_iterator_set = NULL;
-static grib_oarray* binary_messages = NULL;
-static grib_oarray* info_messages = NULL;
-
 /* Convert from Fortran string to C string - chop at first space character */
 static char* cast_char(char* buf, char* fortstr, int len)
 {
@@ -224,232 +170,165 @@ static void fort_char_clean(char* str,int len)
 }
 
 /* Note: the open_mode argument will be all lowercase. See grib_f_open_file_ */
-static int push_file(FILE* f, const char* open_mode, char* buffer)
-{
-    l_grib_file* current  = file_set;
-    l_grib_file* previous = file_set;
-    l_grib_file* the_new      = NULL;
-    int myindex = MIN_FILE_ID;
-    FileMode fmode = FILE_MODE_READ;
+/* Objects handed out to Fortran are kept in tables of slots indexed by their id.
+ * The low bits of an id are the slot (offset by the first id of the table) and
+ * the high bits a generation which changes every time the slot is released, so
+ * that a stale id does not resolve to another object reusing the slot.
+ * Slots are allocated in blocks which never move: lookups are lock-free while
+ * push and clear are done under the mutex of the table.
+ */
+#define ID_SLOT_BITS    24
+#define ID_SLOT_MASK    ((1 << ID_SLOT_BITS) - 1)
+#define ID_GENERATIONS  128
+#define BLOCK_BITS      10
+#define BLOCK_SIZE      (1 << BLOCK_BITS)
+#define MAX_BLOCKS      1024
+
+typedef struct l_slot l_slot;
+struct l_slot {
+    std::atomic<int> id;     /* id of the object, 0 when the slot is free */
+    std::atomic<void*> obj;
+    int index;
+    int generation;
+    int next_free;
+};
 
-    if (strcmp(open_mode, "w") == 0) fmode = FILE_MODE_WRITE;
-    else if (strcmp(open_mode, "a") == 0) fmode = FILE_MODE_APPEND;
+typedef struct l_table l_table;
+struct l_table {
+    std::atomic<l_slot*> blocks[MAX_BLOCKS];
+    int first_id;  /* id of the first slot in its first generation */
+    int size;      /* number of slots in use or in the free list */
+    int free_slot; /* head of the free list, -1 if empty */
+};
 
-    if(!file_set){
-        file_set = (l_grib_file*)malloc(sizeof(l_grib_file));
-        ECCODES_ASSERT(file_set);
-        file_set->id     = myindex;
-        file_set->f      = f;
-        file_set->mode   = fmode;
-        file_set->buffer = buffer;
-        file_set->next   = NULL;
-        return myindex;
-    }
-
-    while(current){
-        if(current->id < 0){
-            current->id = -(current->id);
-            current->f      = f;
-            current->mode   = fmode;
-            current->buffer = buffer;
-            return current->id ;
-        } else{
-            myindex++;
-            previous = current;
-            current = current->next;
-        }
-    }
+static l_table handle_table       = { {}, 1, 0, -1 };
+static l_table index_table        = { {}, 1, 0, -1 };
+static l_table multi_handle_table = { {}, 1, 0, -1 };
+static l_table file_table         = { {}, MIN_FILE_ID, 0, -1 };
+#ifdef FORTRAN_GEOITERATOR_SUPPORT
+static l_table iterator_table     = { {}, 1, 0, -1 };
+#endif
+static l_table keys_iterator_table      = { {}, 1, 0, -1 };
+static l_table bufr_keys_iterator_table = { {}, 1, 0, -1 };
+static grib_oarray* binary_messages = NULL;
+static grib_oarray* info_messages = NULL;
 
-    the_new = (l_grib_file*)malloc(sizeof(l_grib_file));
-    ECCODES_ASSERT(the_new);
-    the_new->id     = myindex;
-    the_new->f      = f;
-    the_new->mode   = fmode;
-    the_new->buffer = buffer;
-    the_new->next   = current;
-    previous->next  = the_new;
-    return myindex;
+static l_slot* table_slot(l_table* t, int index)
+{
+    l_slot* block = NULL;
+    if (index < 0 || index >= MAX_BLOCKS * BLOCK_SIZE) return NULL;
+    block = t->blocks[index >> BLOCK_BITS].load(std::memory_order_acquire);
+    return block ? &block[index & (BLOCK_SIZE - 1)] : NULL;
 }
 
-static void _push_handle(grib_handle *h,int *gid)
+/* Get a free slot. To be called with the mutex of the table held */
+static l_slot* table_new_slot(l_table* t)
 {
-    l_grib_handle* current= NULL;
-    l_grib_handle* previous= handle_set;
-    l_grib_handle* the_new= NULL;
-    int myindex= 1;
-
-    /*
-  if (*gid > 0 ) {
-    while(current) {
-      if(current->id == *gid) break;
-      current = current->next;
-    }
-    if (current) {
-      grib_handle_delete(current->h);
-      current->h=h;
-      return;
-    }
-  }
-     */
+    l_slot* s = NULL;
 
-    if(!handle_set){
-        handle_set = (l_grib_handle*)malloc(sizeof(l_grib_handle));
-        ECCODES_ASSERT(handle_set);
-        handle_set->id   = myindex;
-        handle_set->h    = h;
-        handle_set->next = NULL;
-        *gid=myindex;
-        return;
+    if (t->free_slot >= 0) {
+        s            = table_slot(t, t->free_slot);
+        t->free_slot = s->next_free;
+        return s;
     }
 
-    current= handle_set;
-
-    while(current){
-        if(current->id < 0){
-            current->id = -(current->id);
-            current->h  = h;
-            *gid=current->id;
-            return;
-        }
-        else{
-            myindex++;
-            previous = current;
-            current = current->next;
+    if (t->size == MAX_BLOCKS * BLOCK_SIZE) return NULL;
+    if ((t->size & (BLOCK_SIZE - 1)) == 0) {
+        l_slot* block = new l_slot[BLOCK_SIZE];
+        for (int i = 0; i < BLOCK_SIZE; i++) {
+            block[i].id.store(0, std::memory_order_relaxed);
+            block[i].obj.store(NULL, std::memory_order_relaxed);
+            block[i].index      = t->size + i;
+            block[i].generation = 0;
+            block[i].next_free  = -1;
         }
+        t->blocks[t->size >> BLOCK_BITS].store(block, std::memory_order_release);
     }
-
-    the_new = (l_grib_handle*)malloc(sizeof(l_grib_handle));
-    ECCODES_ASSERT(the_new);
-    the_new->id   = myindex;
-    the_new->h    = h;
-    the_new->next = current;
-    previous->next = the_new;
-
-    *gid=myindex;
-    return;
+    s = table_slot(t, t->size++);
+    return s;
 }
 
-static void _push_index(grib_index *h,int *gid)
+/* Make the object of a slot visible under its new id */
+static int table_publish(l_table* t, l_slot* s, void* obj)
 {
-    l_grib_index* current= NULL;
-    l_grib_index* previous= index_set;
-    l_grib_index* the_new= NULL;
-    int myindex= 1;
-
-    /*
-    if (*gid > 0 ) {
-      while(current) {
-        if(current->id == *gid) break;
-        current = current->next;
-      }
-      if (current) {
-        grib_index_delete(current->h);
-        current->h=h;
-        return;
-      }
-    }
-    */
-
-    if(!index_set){
-        index_set = (l_grib_index*)malloc(sizeof(l_grib_index));
-        ECCODES_ASSERT(index_set);
-        index_set->id   = myindex;
-        index_set->h    = h;
-        index_set->next = NULL;
-        *gid=myindex;
-        return;
-    }
-
-    current= index_set;
-
-    while(current){
-        if(current->id < 0){
-            current->id = -(current->id);
-            current->h  = h;
-            *gid=current->id;
-            return;
-        }
-        else{
-            myindex++;
-            previous = current;
-            current = current->next;
-        }
-    }
-
-    the_new = (l_grib_index*)malloc(sizeof(l_grib_index));
-    ECCODES_ASSERT(the_new);
-    the_new->id   = myindex;
-    the_new->h    = h;
-    the_new->next = current;
-    previous->next = the_new;
-
-    *gid=myindex;
-    return;
+    const int id = (s->generation << ID_SLOT_BITS) | (t->first_id + s->index);
+    s->obj.store(obj, std::memory_order_release);
+    s->id.store(id, std::memory_order_release);
+    return id;
 }
 
-static void _push_multi_handle(grib_multi_handle *h,int *gid)
+static int table_push(l_table* t, void* obj)
 {
-    l_grib_multi_handle* current= NULL;
-    l_grib_multi_handle* previous= multi_handle_set;
-    l_grib_multi_handle* the_new= NULL;
-    int myindex= 1;
+    l_slot* s = table_new_slot(t);
+    if (!s) return -1;
+    return table_publish(t, s, obj);
+}
 
-    /*
-    if (*gid > 0 ) {
-        while(current) {
-          if(current->id == *gid) break;
-          current = current->next;
-        }
-        if (current) {
-          grib_multi_handle_delete(current->h);
-          current->h=h;
-          return;
-        }
-    }
-    */
+/* Slot of a live id, NULL if the id is unknown or has been cleared */
+static l_slot* table_find(l_table* t, int id)
+{
+    l_slot* s = NULL;
+    if (id <= 0) return NULL;
+    s = table_slot(t, (id & ID_SLOT_MASK) - t->first_id);
+    if (!s || s->id.load(std::memory_order_acquire) != id) return NULL;
+    return s;
+}
 
-    if(!multi_handle_set){
-        multi_handle_set = (l_grib_multi_handle*)malloc(sizeof(l_grib_multi_handle));
-        ECCODES_ASSERT(multi_handle_set);
-        multi_handle_set->id   = myindex;
-        multi_handle_set->h    = h;
-        multi_handle_set->next = NULL;
-        *gid=myindex;
-        return;
-    }
+static void* table_get(l_table* t, int id)
+{
+    l_slot* s = table_find(t, id);
+    void* obj = NULL;
+    if (!s) return NULL;
+    obj = s->obj.load(std::memory_order_acquire);
+    /* The slot may have been released meanwhile */
+    if (s->id.load(std::memory_order_acquire) != id) return NULL;
+    return obj;
+}
 
-    current= multi_handle_set;
+/* Give a slot back to the free list. To be called with the mutex of the table held */
+static void table_release(l_table* t, l_slot* s)
+{
+    s->id.store(0, std::memory_order_release);
+    s->generation = (s->generation + 1) % ID_GENERATIONS;
+    s->next_free  = t->free_slot;
+    t->free_slot  = s->index;
+}
 
-    while(current){
-        if(current->id < 0){
-            current->id = -(current->id);
-            current->h  = h;
-            *gid=current->id;
-            return;
-        }
-        else{
-            myindex++;
-            previous = current;
-            current = current->next;
-        }
-    }
+static int push_file(FILE* f, const char* open_mode, char* buffer, int* fid)
+{
+    l_slot* s = NULL;
+    l_grib_file* file = NULL;
+    FileMode fmode = FILE_MODE_READ;
 
-    the_new = (l_grib_multi_handle*)malloc(sizeof(l_grib_multi_handle));
-    ECCODES_ASSERT(the_new);
-    the_new->id   = myindex;
-    the_new->h    = h;
-    the_new->next = current;
-    previous->next = the_new;
+    if (strcmp(open_mode, "w") == 0) fmode = FILE_MODE_WRITE;
+    else if (strcmp(open_mode, "a") == 0) fmode = FILE_MODE_APPEND;
 
-    *gid=myindex;
-    return;
+    GRIB_MUTEX_INIT_ONCE(&once,&init);
+    GRIB_MUTEX_LOCK(&file_mutex);
+    s = table_new_slot(&file_table);
+    if (!s) {
+        GRIB_MUTEX_UNLOCK(&file_mutex);
+        return GRIB_OUT_OF_MEMORY;
+    }
+    /* The file structure stays with its slot, lookups may still be reading it */
+    file = (l_grib_file*)s->obj.load(std::memory_order_relaxed);
+    if (!file) {
+        file = (l_grib_file*)malloc(sizeof(l_grib_file));
+        ECCODES_ASSERT(file);
+    }
+    file->f      = f;
+    file->mode   = fmode;
+    file->buffer = buffer;
+    *fid = table_publish(&file_table, s, file);
+    GRIB_MUTEX_UNLOCK(&file_mutex);
+    return GRIB_SUCCESS;
 }
 
 static void push_handle(grib_handle *h,int *gid)
 {
     GRIB_MUTEX_INIT_ONCE(&once,&init);
     GRIB_MUTEX_LOCK(&handle_mutex);
-    _push_handle(h,gid);
+    *gid = table_push(&handle_table, h);
     GRIB_MUTEX_UNLOCK(&handle_mutex);
     return;
 }
@@ -458,7 +337,7 @@ static void push_index(grib_index *h,int *gid)
 {
     GRIB_MUTEX_INIT_ONCE(&once,&init);
     GRIB_MUTEX_LOCK(&index_mutex);
-    _push_index(h,gid);
+    *gid = table_push(&index_table, h);
     GRIB_MUTEX_UNLOCK(&index_mutex);
     return;
 }
@@ -467,303 +346,124 @@ static void push_multi_handle(grib_multi_handle *h,int *gid)
 {
     GRIB_MUTEX_INIT_ONCE(&once,&init);
     GRIB_MUTEX_LOCK(&multi_handle_mutex);
-    _push_multi_handle(h,gid);
+    *gid = table_push(&multi_handle_table, h);
     GRIB_MUTEX_UNLOCK(&multi_handle_mutex);
     return;
 }
 
-static int _push_keys_iterator(grib_keys_iterator *i)
-{
-    l_grib_keys_iterator* current  = keys_iterator_set;
-    l_grib_keys_iterator* previous = keys_iterator_set;
-    l_grib_keys_iterator* the_new      = NULL;
-    int myindex = 1;
-
-    if(!keys_iterator_set){
-        keys_iterator_set = (l_grib_keys_iterator*)malloc(sizeof(l_grib_keys_iterator));
-        ECCODES_ASSERT(keys_iterator_set);
-        keys_iterator_set->id   = myindex;
-        keys_iterator_set->i    = i;
-        keys_iterator_set->next = NULL;
-        return myindex;
-    }
-
-    while(current){
-        if(current->id < 0){
-            current->id = -(current->id);
-            current->i  = i;
-            return current->id;
-        }
-        else{
-            myindex++;
-            previous = current;
-            current = current->next;
-        }
-    }
-    if(!previous) return -1;
-
-    the_new = (l_grib_keys_iterator*)malloc(sizeof(l_grib_keys_iterator));
-    ECCODES_ASSERT(the_new);
-    the_new->id   = myindex;
-    the_new->i    = i;
-    the_new->next = current;
-    previous->next = the_new;
-
-    return myindex;
-}
-
 static int push_keys_iterator(grib_keys_iterator *i)
 {
     int ret=0;
     GRIB_MUTEX_INIT_ONCE(&once,&init);
     GRIB_MUTEX_LOCK(&keys_iterator_mutex);
-    ret=_push_keys_iterator(i);
+    ret = table_push(&keys_iterator_table, i);
     GRIB_MUTEX_UNLOCK(&keys_iterator_mutex);
     return ret;
 }
 
 /* BUFR Keys iterator */
-static int _push_bufr_keys_iterator(bufr_keys_iterator *i)
-{
-    l_bufr_keys_iterator* current  = bufr_keys_iterator_set;
-    l_bufr_keys_iterator* previous = bufr_keys_iterator_set;
-    l_bufr_keys_iterator* the_new  = NULL;
-    int myindex = 1;
-
-    if(!bufr_keys_iterator_set){
-        bufr_keys_iterator_set = (l_bufr_keys_iterator*)malloc(sizeof(l_bufr_keys_iterator));
-        ECCODES_ASSERT(bufr_keys_iterator_set);
-        bufr_keys_iterator_set->id   = myindex;
-        bufr_keys_iterator_set->i    = i;
-        bufr_keys_iterator_set->next = NULL;
-        return myindex;
-    }
-
-    while(current){
-        if(current->id < 0){
-            current->id = -(current->id);
-            current->i  = i;
-            return current->id;
-        }
-        else{
-            myindex++;
-            previous = current;
-            current = current->next;
-        }
-    }
-    if(!previous) return -1;
-
-    the_new = (l_bufr_keys_iterator*)malloc(sizeof(l_bufr_keys_iterator));
-    ECCODES_ASSERT(the_new);
-    the_new->id    = myindex;
-    the_new->i     = i;
-    the_new->next  = current;
-    previous->next = the_new;
-
-    return myindex;
-}
 static int push_bufr_keys_iterator(bufr_keys_iterator *i)
 {
     int ret=0;
     GRIB_MUTEX_INIT_ONCE(&once,&init);
     GRIB_MUTEX_LOCK(&keys_iterator_mutex);
-    ret=_push_bufr_keys_iterator(i);
+    ret = table_push(&bufr_keys_iterator_table, i);
     GRIB_MUTEX_UNLOCK(&keys_iterator_mutex);
     return ret;
 }
 
-
-static grib_handle* _get_handle(int handle_id)
-{
-    l_grib_handle* current= handle_set;
-
-    while(current){
-        if(current->id == handle_id) return current->h;
-        current = current->next;
-    }
-    return NULL;
-}
-
-static grib_index* _get_index(int index_id)
-{
-    l_grib_index* current= index_set;
-
-    while(current){
-        if(current->id == index_id) return current->h;
-        current = current->next;
-    }
-    return NULL;
-}
-
-static grib_multi_handle* _get_multi_handle(int multi_handle_id)
-{
-    l_grib_multi_handle* current= multi_handle_set;
-
-    while(current){
-        if(current->id == multi_handle_id) return current->h;
-        current = current->next;
-    }
-    return NULL;
-}
-
 static grib_handle* get_handle(int handle_id)
 {
-    grib_handle* h=NULL;
-    GRIB_MUTEX_INIT_ONCE(&once,&init);
-    GRIB_MUTEX_LOCK(&handle_mutex);
-    h=_get_handle(handle_id);
-    GRIB_MUTEX_UNLOCK(&handle_mutex);
-    return h;
+    return (grib_handle*)table_get(&handle_table, handle_id);
 }
 
 static grib_index* get_index(int index_id)
 {
-    grib_index* h=NULL;
-    GRIB_MUTEX_INIT_ONCE(&once,&init);
-    GRIB_MUTEX_LOCK(&index_mutex);
-    h=_get_index(index_id);
-    GRIB_MUTEX_UNLOCK(&index_mutex);
-    return h;
+    return (grib_index*)table_get(&index_table, index_id);
 }
 
 static grib_multi_handle* get_multi_handle(int multi_handle_id)
 {
-    grib_multi_handle* h=NULL;
-    GRIB_MUTEX_INIT_ONCE(&once,&init);
-    GRIB_MUTEX_LOCK(&multi_handle_mutex);
-    h=_get_multi_handle(multi_handle_id);
-    GRIB_MUTEX_UNLOCK(&multi_handle_mutex);
-    return h;
+    return (grib_multi_handle*)table_get(&multi_handle_table, multi_handle_id);
 }
 
 static FILE* get_file(int file_id)
 {
-    l_grib_file* current  = file_set;
+    l_grib_file* file = NULL;
 
-    if ( file_id < MIN_FILE_ID ) return NULL;
+    if ( (file_id & ID_SLOT_MASK) < MIN_FILE_ID ) return NULL;
 
-    while(current){
-        if(current->id == file_id) return current->f;
-        current = current->next;
-    }
-    return NULL;
+    file = (l_grib_file*)table_get(&file_table, file_id);
+    return file ? file->f : NULL;
 }
 
-static grib_keys_iterator* _get_keys_iterator(int keys_iterator_id)
-{
-    l_grib_keys_iterator* current  = keys_iterator_set;
-
-    while(current){
-        if(current->id == keys_iterator_id) return current->i;
-        current = current->next;
-    }
-    return NULL;
-}
 static grib_keys_iterator* get_keys_iterator(int keys_iterator_id)
 {
-    grib_keys_iterator* i=NULL;
-    GRIB_MUTEX_INIT_ONCE(&once,&init);
-    GRIB_MUTEX_LOCK(&keys_iterator_mutex);
-    i=_get_keys_iterator(keys_iterator_id);
-    GRIB_MUTEX_UNLOCK(&keys_iterator_mutex);
-    return i;
+    return (grib_keys_iterator*)table_get(&keys_iterator_table, keys_iterator_id);
 }
 
 /* BUFR */
-static bufr_keys_iterator* _get_bufr_keys_iterator(int keys_iterator_id)
-{
-    l_bufr_keys_iterator* current  = bufr_keys_iterator_set;
-
-    while(current){
-        if(current->id == keys_iterator_id) return current->i;
-        current = current->next;
-    }
-    return NULL;
-}
 static bufr_keys_iterator* get_bufr_keys_iterator(int keys_iterator_id)
 {
-    bufr_keys_iterator* i=NULL;
-    GRIB_MUTEX_INIT_ONCE(&once,&init);
-    GRIB_MUTEX_LOCK(&keys_iterator_mutex);
-    i=_get_bufr_keys_iterator(keys_iterator_id);
-    GRIB_MUTEX_UNLOCK(&keys_iterator_mutex);
-    return i;
+    return (bufr_keys_iterator*)table_get(&bufr_keys_iterator_table, keys_iterator_id);
 }
 
-
 static int clear_file(int file_id)
 {
     int err = 0;
-    l_grib_file* current = file_set;
-    while(current){
-        if(current->id == file_id){
-            current->id = -(current->id);
-            if (current->f) {
-                if (current->mode == FILE_MODE_WRITE || current->mode == FILE_MODE_APPEND)
-                    err = codes_flush_sync_close_file(current->f);
-                else
-                    err = fclose(current->f);
-                if (err) {
-                    int ioerr = errno;
-                    grib_context* c = grib_context_get_default();
-                    grib_context_log(c,(GRIB_LOG_ERROR)|(GRIB_LOG_PERROR),"IO ERROR: %s",strerror(ioerr));
-                    return GRIB_IO_PROBLEM;
-                }
-            }
-            if (current->buffer) free(current->buffer);
-            return GRIB_SUCCESS;
-        }
-        current = current->next;
+    l_slot* s = NULL;
+    l_grib_file* current = NULL;
+
+    GRIB_MUTEX_INIT_ONCE(&once,&init);
+    GRIB_MUTEX_LOCK(&file_mutex);
+    s = table_find(&file_table, file_id);
+    if (!s) {
+        GRIB_MUTEX_UNLOCK(&file_mutex);
+        return GRIB_INVALID_FILE;
     }
-    return GRIB_INVALID_FILE;
-}
 
-static int _clear_handle(int handle_id)
-{
-    l_grib_handle* current  = handle_set;
-    if (handle_id<0) return 0;
-    while(current){
-        if(current->id == handle_id){
-            current->id = -(current->id);
-            if(current->h) return grib_handle_delete(current->h);
-        }
-        current = current->next;
+    /* Close before the slot, and the file structure with it, can be reused */
+    current = (l_grib_file*)s->obj.load(std::memory_order_relaxed);
+    if (current->f) {
+        if (current->mode == FILE_MODE_WRITE || current->mode == FILE_MODE_APPEND)
+            err = codes_flush_sync_close_file(current->f);
+        else
+            err = fclose(current->f);
+    }
+    if (!err && current->buffer) free(current->buffer);
+    table_release(&file_table, s);
+    GRIB_MUTEX_UNLOCK(&file_mutex);
+
+    if (err) {
+        int ioerr = errno;
+        grib_context* c = grib_context_get_default();
+        grib_context_log(c,(GRIB_LOG_ERROR)|(GRIB_LOG_PERROR),"IO ERROR: %s",strerror(ioerr));
+        return GRIB_IO_PROBLEM;
     }
     return GRIB_SUCCESS;
 }
 
-static int _clear_index(int index_id)
+static int _clear_handle(int handle_id)
 {
-    l_grib_index* current  = index_set;
-
-    while(current){
-        if(current->id == index_id){
-            current->id = -(current->id);
-            if (current->h) {
-                grib_index_delete(current->h);
-                return GRIB_SUCCESS;
-            }
-        }
-        current = current->next;
-    }
+    l_slot* s = table_find(&handle_table, handle_id);
+    grib_handle* h = NULL;
+    if (!s) return GRIB_SUCCESS;
+    h = (grib_handle*)s->obj.load(std::memory_order_relaxed);
+    table_release(&handle_table, s);
+    if (h) return grib_handle_delete(h);
     return GRIB_SUCCESS;
 }
 
-#if 0
-static int _clear_multi_handle(int multi_handle_id)
+static int _clear_index(int index_id)
 {
-    l_grib_multi_handle* current  = multi_handle_set;
-
-    while(current){
-        if(current->id == multi_handle_id){
-            current->id = -(current->id);
-            if(current->h) return grib_multi_handle_delete(current->h);
-        }
-        current = current->next;
-    }
+    l_slot* s = table_find(&index_table, index_id);
+    grib_index* h = NULL;
+    if (!s) return GRIB_SUCCESS;
+    h = (grib_index*)s->obj.load(std::memory_order_relaxed);
+    table_release(&index_table, s);
+    if (h) grib_index_delete(h);
     return GRIB_SUCCESS;
 }
-#endif
 
 static int clear_handle(int handle_id)
 {
@@ -785,30 +485,14 @@ static int clear_index(int index_id)
     return ret;
 }
 
-#if 0
-static int clear_multi_handle(int multi_handle_id)
-{
-    int ret=0;
-    GRIB_MUTEX_INIT_ONCE(&once,&init);
-    GRIB_MUTEX_LOCK(&multi_handle_mutex);
-    ret=_clear_multi_handle(multi_handle_id);
-    GRIB_MUTEX_UNLOCK(&multi_handle_mutex);
-    return ret;
-}
-#endif
-
 static int _clear_keys_iterator(int keys_iterator_id)
 {
-    l_grib_keys_iterator* current  = keys_iterator_set;
-
-    while(current){
-        if(current->id == keys_iterator_id){
-            current->id = -(current->id);
-            return grib_keys_iterator_delete(current->i);
-        }
-        current = current->next;
-    }
-    return GRIB_INVALID_KEYS_ITERATOR;
+    l_slot* s = table_find(&keys_iterator_table, keys_iterator_id);
+    grib_keys_iterator* i = NULL;
+    if (!s) return GRIB_INVALID_KEYS_ITERATOR;
+    i = (grib_keys_iterator*)s->obj.load(std::memory_order_relaxed);
+    table_release(&keys_iterator_table, s);
+    return grib_keys_iterator_delete(i);
 }
 static int clear_keys_iterator(int keys_iterator_id)
 {
@@ -823,16 +507,12 @@ static int clear_keys_iterator(int keys_iterator_id)
 /* BUFR */
 static int _clear_bufr_keys_iterator(int keys_iterator_id)
 {
-    l_bufr_keys_iterator* current  = bufr_keys_iterator_set;
-
-    while(current){
-        if(current->id == keys_iterator_id){
-            current->id = -(current->id);
-            return codes_bufr_keys_iterator_delete(current->i);
-        }
-        current = current->next;
-    }
-    return GRIB_INVALID_KEYS_ITERATOR;
+    l_slot* s = table_find(&bufr_keys_iterator_table, keys_iterator_id);
+    bufr_keys_iterator* i = NULL;
+    if (!s) return GRIB_INVALID_KEYS_ITERATOR;
+    i = (bufr_keys_iterator*)s->obj.load(std::memory_order_relaxed);
+    table_release(&bufr_keys_iterator_table, s);
+    return codes_bufr_keys_iterator_delete(i);
 }
 static int clear_bufr_keys_iterator(int keys_iterator_id)
 {
@@ -843,7 +523,6 @@ static int clear_bufr_keys_iterator(int keys_iterator_id)
     GRIB_MUTEX_UNLOCK(&keys_iterator_mutex);
     return ret;
 }
-
 /*****************************************************************************/
 #if 0
 int grib_f_read_any_headers_only_from_file_(int* fid, char* buffer, size_t* nbytes)
@@ -958,8 +637,13 @@ int grib_f_open_file_(int* fid, char* name , char* op, int lname, int lop)
 #endif
             setvbuf(f,iobuf,_IOFBF,context->io_buffer_size);
         }
-        *fid = push_file(f, oper, iobuf);
-        ret=GRIB_SUCCESS;
+        ret = push_file(f, oper, iobuf, fid);
+        if (ret != GRIB_SUCCESS) {
+            grib_context_log(context,GRIB_LOG_ERROR,"grib_f_open_file_: Too many open files (%s)",trimmed);
+            fclose(f);
+            if (iobuf) free(iobuf);
+            *fid = -1;
+        }
     }
     return ret;
 }
@@ -1011,84 +695,27 @@ int grib_f_multi_support_off_(void)
 
 /*****************************************************************************/
 #ifdef FORTRAN_GEOITERATOR_SUPPORT
-static int _push_iterator(grib_iterator *i)
-{
-    l_grib_iterator* current  = iterator_set;
-    l_grib_iterator* previous = iterator_set;
-    l_grib_iterator* the_new      = NULL;
-    int myindex = 1;
-
-    if(!iterator_set){
-        iterator_set = (l_grib_iterator*)malloc(sizeof(l_grib_iterator));
-        ECCODES_ASSERT(iterator_set);
-        iterator_set->id   = myindex;
-        iterator_set->i    = i;
-        iterator_set->next = NULL;
-        return myindex;
-    }
-
-    while(current){
-        if(current->id < 0){
-            current->id = -(current->id);
-            current->i  = i;
-            return current->id;
-        }
-        else{
-            myindex++;
-            previous = current;
-            current = current->next;
-        }
-    }
-
-    the_new = (l_grib_iterator*)malloc(sizeof(l_grib_iterator));
-    ECCODES_ASSERT(the_new);
-    the_new->id   = myindex;
-    the_new->i    = i;
-    the_new->next = current;
-    previous->next = the_new;
-
-    return myindex;
-}
 static int push_iterator(grib_iterator *i)
 {
     int ret=0;
     GRIB_MUTEX_INIT_ONCE(&once,&init);
     GRIB_MUTEX_LOCK(&iterator_mutex);
-    ret=_push_iterator(i);
+    ret = table_push(&iterator_table, i);
     GRIB_MUTEX_UNLOCK(&iterator_mutex);
     return ret;
 }
-static grib_iterator* _get_iterator(int iterator_id)
-{
-    l_grib_iterator* current  = iterator_set;
-
-    while(current){
-        if(current->id == iterator_id) return current->i;
-        current = current->next;
-    }
-    return NULL;
-}
 static grib_iterator* get_iterator(int iterator_id)
 {
-    grib_iterator* i=NULL;
-    GRIB_MUTEX_INIT_ONCE(&once,&init);
-    GRIB_MUTEX_LOCK(&iterator_mutex);
-    i=_get_iterator(iterator_id);
-    GRIB_MUTEX_UNLOCK(&iterator_mutex);
-    return i;
+    return (grib_iterator*)table_get(&iterator_table, iterator_id);
 }
 static int _clear_iterator(int iterator_id)
 {
-    l_grib_iterator* current  = iterator_set;
-
-    while(current){
-        if(current->id == iterator_id){
-            current->id = -(current->id);
-            return grib_iterator_delete(current->i);
-        }
-        current = current->next;
-    }
-    return GRIB_INVALID_ITERATOR;
+    l_slot* s = table_find(&iterator_table, iterator_id);
+    grib_iterator* i = NULL;
+    if (!s) return GRIB_INVALID_ITERATOR;
+    i = (grib_iterator*)s->obj.load(std::memory_order_relaxed);
+    table_release(&iterator_table, s);
+    return grib_iterator_delete(i);
 }
 static int clear_iterator(int iterator_id)
 {
@@ -13,6 +13,7 @@
  ***************************************************************************/
 
 #include "grib_accessor.h"
+#include <new>
 
 // Note: A fast cut-down version of strcmp which does NOT return -1
 // 0 means input strings are equal and 1 means not equal
@@ -27,6 +28,20 @@ GRIB_INLINE static int grib_inline_strcmp(const char* a, const char* b)
     return (*a == 0 && *b == 0) ? 0 : 1;
 }
 
+// The arena is set by grib_accessor_factory. Other accessors (e.g. the builders) are allocated with malloc
+void* grib_accessor::operator new(size_t size)
+{
+    void* p = grib_arena_malloc(grib_arena_current(), size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void grib_accessor::operator delete(void* p)
+{
+    grib_arena_free(p);
+}
+
 int grib_accessor::compare_accessors(grib_accessor* a2, int compare_flags)
 {
     int ret           = 0;
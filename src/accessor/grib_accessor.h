@@ -63,6 +63,10 @@ public:
         parent_as_attribute_(nullptr) {}
   virtual ~grib_accessor() {}
 
+  // Accessors created by grib_accessor_factory live in the arena of their handle
+  static void *operator new(size_t size);
+  static void operator delete(void *p);
+
   virtual void init_accessor(const long, grib_arguments *) = 0;
   virtual void dump(eccodes::Dumper *f) = 0;
   virtual int pack_missing() = 0;
@@ -154,4 +158,6 @@ public:
       0,
   }; // attributes are accessors
   grib_accessor *parent_as_attribute_ = nullptr;
+  grib_dependency *observers_ = nullptr; // dependencies on this accessor, see grib_dependency.cc
+  grib_dependency *observing_ = nullptr; // dependencies of this accessor on others
 };
@@ -9,6 +9,7 @@
  */
 
 #include "grib_scaling.h"
+#include "grib_bits_any_endian_simple.h"
 #include "grib_accessor_class_bufr_data_array.h"
 #include "grib_accessor_class_expanded_descriptors.h"
 #include "grib_accessor_class_bufr_data_element.h"
@@ -305,14 +306,16 @@ long grib_accessor_bufr_data_array_t::next_offset()
 
 int grib_accessor_bufr_data_array_t::pack_long(const long* val, size_t* len)
 {
-    do_decode_ = 1;
+    do_decode_      = 1;
+    values_decoded_ = 0;
 
     return GRIB_NOT_IMPLEMENTED;
 }
 
 int grib_accessor_bufr_data_array_t::pack_double(const double* val, size_t* len)
 {
-    do_decode_ = 1;
+    do_decode_      = 1;
+    values_decoded_ = 0;
     return process_elements(PROCESS_ENCODE, 0, 0, 0);
 }
 
@@ -464,16 +467,21 @@ grib_darray* grib_accessor_bufr_data_array_t::decode_double_array(grib_context*
             *err = 0;
             return ret;
         }
-        for (j = 0; j < numberOfSubsets_; j++) {
-            lval = grib_decode_size_t(data, pos, localWidth);
-            if (canBeMissing && grib_is_all_bits_one(lval, localWidth)) {
-                dval = GRIB_MISSING_DOUBLE;
-            }
-            else {
-                dval = ((long)lval + localReference) * modifiedFactor;
-            }
-            grib_darray_push(ret, dval);
+        /* Same width and reference for the increments of all the subsets: decode the whole column at once */
+        const unsigned long missing = BIT_MASK1(localWidth);
+        double* v                   = ret->v;
+        if (canBeMissing) {
+            grib_decode_each(data, *pos, localWidth, numberOfSubsets_, [=](size_t i, unsigned long x) {
+                v[i] = x == missing ? GRIB_MISSING_DOUBLE : ((long)x + localReference) * modifiedFactor;
+            });
         }
+        else {
+            grib_decode_each(data, *pos, localWidth, numberOfSubsets_, [=](size_t i, unsigned long x) {
+                v[i] = ((long)x + localReference) * modifiedFactor;
+            });
+        }
+        ret->n = numberOfSubsets_;
+        *pos += localWidth * numberOfSubsets_;
     }
     else {
         /* ECC-428 */
@@ -1688,6 +1696,20 @@ grib_accessor* grib_accessor_bufr_data_array_t::create_attribute_variable(const
     return a;
 }
 
+/* The key names and codes of the data accessors live as long as the accessors, in the arena of the handle */
+static char* temp_string_new(grib_accessor* a, const char* s)
+{
+    return grib_arena_strdup(grib_handle_arena(grib_handle_of_accessor(a)), s);
+}
+
+static void temp_strings_delete(grib_sarray* v)
+{
+    for (size_t i = 0; i < v->n; i++)
+        grib_arena_free(v->v[i]);
+    v->n = 0;
+    grib_sarray_delete(v);
+}
+
 static void set_creator_name(grib_action* creator, int code)
 {
     switch (code) {
@@ -1811,7 +1833,7 @@ grib_accessor* grib_accessor_bufr_data_array_t::create_accessor_from_descriptor(
     switch (expanded_->v[idx]->F) {
         case 0:
         case 1:
-            creator.name = grib_context_strdup(context_, expanded_->v[idx]->shortName);
+            creator.name = temp_string_new(this, expanded_->v[idx]->shortName);
 
             /* ECC-325: store alloc'd string (due to strdup) for clean up later */
             grib_sarray_push(tempStrings_, creator.name);
@@ -1849,7 +1871,7 @@ grib_accessor* grib_accessor_bufr_data_array_t::create_accessor_from_descriptor(
             accessor->add_attribute(attribute, 0);
 
             snprintf(code, sizeof(code), "%06ld", expanded_->v[idx]->code);
-            temp_str  = grib_context_strdup(context_, code);
+            temp_str  = temp_string_new(this, code);
             attribute = create_attribute_variable("code", section, GRIB_TYPE_STRING, temp_str, 0, 0, flags);
             if (!attribute)
                 return NULL;
@@ -2313,8 +2335,7 @@ int grib_accessor_bufr_data_array_t::create_keys(long onlySubset, long startSubs
     dataAccessorsTrie_ = grib_trie_with_rank_new(c);
 
     if (tempStrings_) {
-        grib_sarray_delete_content(tempStrings_);
-        grib_sarray_delete(tempStrings_);
+        temp_strings_delete(tempStrings_);
         tempStrings_ = NULL;
     }
     tempStrings_ = numberOfSubsets_ ? grib_sarray_new(numberOfSubsets_, 500) : NULL;
@@ -2520,7 +2541,7 @@ int grib_accessor_bufr_data_array_t::create_keys(long onlySubset, long startSubs
             associatedFieldAccessor = NULL;
             if (elementFromBitmap && unpackMode_ == CODES_BUFR_UNPACK_STRUCTURE) {
                 if (descriptor->code != 33007 && descriptor->code != 223255) {
-                    char* aname                = grib_context_strdup(c, elementFromBitmap->name_);
+                    char* aname                = temp_string_new(this, elementFromBitmap->name_);
                     grib_accessor* newAccessor = elementAccessor->clone(section, &err);
                     newAccessor->parent_       = groupSection;
                     newAccessor->name_         = aname;
@@ -2707,7 +2728,8 @@ int grib_accessor_bufr_data_array_t::process_elements(int flag, long onlySubset,
         case PROCESS_DECODE:
             if (!do_decode_)
                 return 0;
-            do_decode_   = 0;
+            do_decode_      = 0;
+            values_decoded_ = 0;
             buffer       = h->buffer;
             decoding     = 1;
             do_clean     = 1;
@@ -2719,6 +2741,7 @@ int grib_accessor_bufr_data_array_t::process_elements(int flag, long onlySubset,
             codec_replication = &decode_replication;
             break;
         case PROCESS_NEW_DATA:
+            values_decoded_                 = 0;
             buffer                          = grib_create_growable_buffer(c);
             decoding                        = 0;
             do_clean                        = 1;
@@ -3206,7 +3229,8 @@ int grib_accessor_bufr_data_array_t::process_elements(int flag, long onlySubset,
     /*grib_viarray_print("DBG process_elements: elementsDescriptorsIndex", elementsDescriptorsIndex_ );*/
 
     if (decoding) {
-        err            = create_keys(0, 0, 0);
+        if (!decode_values_only_)
+            err = create_keys(0, 0, 0);
         bitsToEndData_ = totalSize;
     }
     else {
@@ -3308,6 +3332,89 @@ int grib_accessor_bufr_data_array_t::unpack_double(double* val, size_t* len)
     return GRIB_SUCCESS;
 }
 
+/* Copy the values of the elements with the given descriptors (e.g. 5001 for latitude) into one array
+ * per descriptor, subset by subset and in order of occurrence within a subset.
+ * The data section is decoded without creating the data keys (which are made by the next unpack).
+ * On input lengths[i] is the size of columns[i], on output the number of values of that descriptor.
+ * If columns is NULL, only the lengths are returned */
+int grib_accessor_bufr_data_array_t::decode_columns(const long* codes, size_t num_codes, double** columns, size_t* lengths)
+{
+    grib_context* c = context_;
+    int err         = 0;
+    int* column_of  = NULL;
+    size_t* count   = NULL;
+    long numberOfDescriptors, iss, ide;
+    size_t i;
+
+    if (do_decode_ && !values_decoded_) {
+        decode_values_only_ = 1;
+        err                 = process_elements(PROCESS_DECODE, 0, 0, 0);
+        decode_values_only_ = 0;
+        do_decode_          = 1;
+        if (err)
+            return err;
+        values_decoded_ = 1;
+    }
+
+    /* Column receiving each of the expanded descriptors, -1 if none */
+    numberOfDescriptors = grib_bufr_descriptors_array_used_size(expanded_);
+    column_of           = (int*)grib_context_malloc(c, numberOfDescriptors * sizeof(int));
+    count               = (size_t*)grib_context_malloc_clear(c, num_codes * sizeof(size_t));
+    if (!column_of || !count) {
+        err = GRIB_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+    for (ide = 0; ide < numberOfDescriptors; ide++) {
+        const bufr_descriptor* bd = expanded_->v[ide];
+        column_of[ide]            = -1;
+        if (bd->F != 0 || bd->nokey)
+            continue;
+        for (i = 0; i < num_codes; i++) {
+            if (codes[i] == bd->code) {
+                if (bd->type == BUFR_DESCRIPTOR_TYPE_STRING) {
+                    grib_context_log(c, GRIB_LOG_ERROR, "%s: Descriptor %06ld is a string", __func__, bd->code);
+                    err = GRIB_WRONG_TYPE;
+                    goto cleanup;
+                }
+                column_of[ide] = i;
+                break;
+            }
+        }
+    }
+
+    for (iss = 0; iss < numberOfSubsets_; iss++) {
+        const grib_iarray* index = elementsDescriptorsIndex_->v[compressedData_ ? 0 : iss];
+        for (ide = 0; ide < (long)index->n; ide++) {
+            const int col = column_of[index->v[ide]];
+            if (col < 0)
+                continue;
+            if (columns && count[col] < lengths[col]) {
+                double val;
+                if (compressedData_) {
+                    const grib_darray* values = numericValues_->v[ide];
+                    val                       = values->n == 1 ? values->v[0] : values->v[iss];
+                }
+                else {
+                    val = numericValues_->v[iss]->v[ide];
+                }
+                columns[col][count[col]] = val;
+            }
+            count[col]++;
+        }
+    }
+
+    for (i = 0; i < num_codes; i++) {
+        if (columns && count[i] > lengths[i])
+            err = GRIB_ARRAY_TOO_SMALL;
+        lengths[i] = count[i];
+    }
+
+cleanup:
+    grib_context_free(c, column_of);
+    grib_context_free(c, count);
+    return err;
+}
+
 void grib_accessor_bufr_data_array_t::destroy(grib_context* c)
 {
     self_clear();
@@ -3318,8 +3425,7 @@ void grib_accessor_bufr_data_array_t::destroy(grib_context* c)
         dataAccessorsTrie_ = NULL;
     }
     if (tempStrings_) {
-        grib_sarray_delete_content(tempStrings_);
-        grib_sarray_delete(tempStrings_);
+        temp_strings_delete(tempStrings_);
     }
     if (tempDoubleValues_) {
         /* ECC-1172: Clean up to avoid memory leaks */
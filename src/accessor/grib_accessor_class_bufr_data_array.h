@@ -45,6 +45,7 @@ public:
     grib_accessors_list* accessor_bufr_data_array_get_dataAccessors();
     grib_trie_with_rank* accessor_bufr_data_array_get_dataAccessorsTrie();
     grib_vsarray* accessor_bufr_data_array_get_stringValues();
+    int decode_columns(const long* codes, size_t num_codes, double** columns, size_t* lengths);
 
 private:
     const char* bufrDataEncodedName_ = nullptr;
@@ -94,6 +95,8 @@ private:
     long refValIndex_ = 0;
     bufr_tableb_override* tableb_override_ = nullptr;
     int set_to_missing_if_out_of_range_ = 0;
+    int decode_values_only_ = 0;  // Decode without creating the data keys. See decode_columns
+    int values_decoded_ = 0;      // numericValues_ is current although do_decode_ is set (no keys yet)
 
     void restart_bitmap();
     void cancel_bitmap();
@@ -39,6 +39,36 @@ static void init_mutex()
 }
 #endif
 
+/* Table B of a dictionary, loaded once and then shared read-only by all the handles.
+ * The elements are indexed by the X and Y of their descriptor code 0XXYYY */
+#define BUFR_ELEMENTS_TABLE_SIZE (64 * 256)
+
+struct bufr_element
+{
+    char shortName[128];
+    char units[64];
+    int type;
+    long scale;
+    double factor;
+    long reference;
+    long width;
+};
+
+struct bufr_elements_table
+{
+    bufr_element* elements[BUFR_ELEMENTS_TABLE_SIZE];
+};
+
+static int element_index(long code)
+{
+    const long F = code / 100000;
+    const long X = (code / 1000) % 100;
+    const long Y = code % 1000;
+    if (F != 0 || X > 63 || Y > 255)
+        return -1;
+    return X * 256 + Y;
+}
+
 grib_accessor_bufr_elements_table_t _grib_accessor_bufr_elements_table{};
 grib_accessor* grib_accessor_bufr_elements_table = &_grib_accessor_bufr_elements_table;
 
@@ -55,7 +85,94 @@ void grib_accessor_bufr_elements_table_t::init(const long len, grib_arguments* p
     flags_ |= GRIB_ACCESSOR_FLAG_READ_ONLY;
 }
 
-grib_trie* grib_accessor_bufr_elements_table_t::load_bufr_elements_table(int* err)
+static int convert_type(const char* stype)
+{
+    int ret = BUFR_DESCRIPTOR_TYPE_UNKNOWN;
+    switch (stype[0]) {
+        case 's':
+            if (!strcmp(stype, "string"))
+                ret = BUFR_DESCRIPTOR_TYPE_STRING;
+            break;
+        case 'l':
+            if (!strcmp(stype, "long"))
+                ret = BUFR_DESCRIPTOR_TYPE_LONG;
+            break;
+        case 'd':
+            if (!strcmp(stype, "double"))
+                ret = BUFR_DESCRIPTOR_TYPE_DOUBLE;
+            break;
+        case 't':
+            if (!strcmp(stype, "table"))
+                ret = BUFR_DESCRIPTOR_TYPE_TABLE;
+            break;
+        case 'f':
+            if (!strcmp(stype, "flag"))
+                ret = BUFR_DESCRIPTOR_TYPE_FLAG;
+            break;
+        default:
+            ret = BUFR_DESCRIPTOR_TYPE_UNKNOWN;
+    }
+
+    return ret;
+}
+
+static long atol_fast(const char* input)
+{
+    if (strcmp(input, "0") == 0)
+        return 0;
+    return atol(input);
+}
+
+/* The numeric attributes are converted here once, not every time a descriptor is created */
+static void read_elements(grib_context* c, FILE* f, char* line, size_t size, bufr_elements_table* table)
+{
+    while (fgets(line, size - 1, f)) {
+        char** list = NULL;
+        int index = 0, n = 0;
+        DEBUG_ASSERT(strlen(line) > 0);
+        if (line[0] == '#') continue; /* Ignore first line with column titles */
+        list  = string_split(line, "|");
+        for (n = 0; list[n] != NULL; ++n) {}
+        index = n > 7 ? element_index(atol(list[0])) : -1;
+        if (index < 0) {
+            grib_context_log(c, GRIB_LOG_DEBUG, "bufr_elements_table: Ignoring invalid element %s", n ? list[0] : "");
+        }
+        else {
+            bufr_element* e = table->elements[index];
+            if (!e) {
+                e = (bufr_element*)grib_context_malloc_clear_persistent(c, sizeof(bufr_element));
+                table->elements[index] = e;
+            }
+#ifdef DEBUG
+            /* ECC-1137: check descriptor key name and unit lengths */
+            ECCODES_ASSERT(strlen(list[1]) < sizeof(e->shortName));
+            ECCODES_ASSERT(strlen(list[4]) < sizeof(e->units));
+#endif
+            strcpy(e->shortName, list[1]);
+            e->type = convert_type(list[2]);
+            /* e->name=grib_context_strdup(c,list[3]);  See ECC-489 */
+            strcpy(e->units, list[4]);
+
+            /* ECC-985: Scale and reference are often 0 so we can reduce calls to atol */
+            e->scale     = atol_fast(list[5]);
+            e->factor    = codes_power<double>(-e->scale, 10);
+            e->reference = atol_fast(list[6]);
+            e->width     = atol(list[7]);
+        }
+        for (int i = 0; i < n; ++i)
+            free(list[i]);
+        free(list);
+    }
+}
+
+static void free_elements(grib_context* c, bufr_elements_table* table)
+{
+    for (int i = 0; i < BUFR_ELEMENTS_TABLE_SIZE; ++i)
+        grib_context_free_persistent(c, table->elements[i]);
+    grib_context_free_persistent(c, table);
+}
+
+const bufr_elements_table* grib_accessor_bufr_elements_table_t::load_bufr_elements_table(int* err)
 {
     char* filename = NULL;
     char line[1024] = {0,};
@@ -64,14 +181,12 @@ grib_trie* grib_accessor_bufr_elements_table_t::load_bufr_elements_table(int* er
     char dictName[1024] = {0,};
     char masterRecomposed[1024] = {0,};  // e.g. bufr/tables/0/wmo/36/element.table
     char localRecomposed[1024] = {0,};   // e.g. bufr/tables/0/local/0/98/0/element.table
-    char* localFilename   = 0;
-    char** list           = 0;
-    char** cached_list    = 0;
-    size_t len            = 1024;
-    grib_trie* dictionary = NULL;
-    FILE* f               = NULL;
-    grib_handle* h        = grib_handle_of_accessor(this);
-    grib_context* c       = context_;
+    char* localFilename             = 0;
+    size_t len                      = 1024;
+    bufr_elements_table* dictionary = NULL;
+    FILE* f                         = NULL;
+    grib_handle* h                  = grib_handle_of_accessor(this);
+    grib_context* c                 = context_;
 
     *err = GRIB_SUCCESS;
 
@@ -82,9 +197,6 @@ grib_trie* grib_accessor_bufr_elements_table_t::load_bufr_elements_table(int* er
     if (localDir_ != NULL)
         grib_get_string(h, localDir_, localDir, &len);
 
-    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
-    GRIB_MUTEX_LOCK(&mutex1);
-
     if (*masterDir != 0) {
         char name[4096] = {0,};
         snprintf(name, 4096, "%s/%s", masterDir, dictionary_);
@@ -110,12 +222,19 @@ grib_trie* grib_accessor_bufr_elements_table_t::load_bufr_elements_table(int* er
         grib_context_log(c, GRIB_LOG_ERROR, "Unable to find definition file %s", dictionary_);
         if (strlen(masterRecomposed) > 0) grib_context_log(c, GRIB_LOG_DEBUG, "master path=%s", masterRecomposed);
         if (strlen(localRecomposed) > 0) grib_context_log(c, GRIB_LOG_DEBUG, "local path=%s", localRecomposed);
-        *err       = GRIB_FILE_NOT_FOUND;
-        dictionary = NULL;
-        goto the_end;
+        *err = GRIB_FILE_NOT_FOUND;
+        return NULL;
     }
 
-    dictionary = (grib_trie*)grib_trie_get(c->lists, dictName);
+    /* Dictionaries are complete when inserted in the list: look up without locking */
+    dictionary = (bufr_elements_table*)grib_trie_get(c->lists, dictName);
+    if (dictionary)
+        return dictionary;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex1);
+
+    dictionary = (bufr_elements_table*)grib_trie_get(c->lists, dictName);
     if (dictionary) {
         /*grib_context_log(c,GRIB_LOG_DEBUG,"using dictionary %s from cache",a->dictionary_ );*/
         goto the_end;
@@ -131,40 +250,21 @@ grib_trie* grib_accessor_bufr_elements_table_t::load_bufr_elements_table(int* er
         goto the_end;
     }
 
-    dictionary = grib_trie_new(c);
-
-    while (fgets(line, sizeof(line) - 1, f)) {
-        DEBUG_ASSERT(strlen(line) > 0);
-        if (line[0] == '#') continue; /* Ignore first line with column titles */
-        list = string_split(line, "|");
-        grib_trie_insert(dictionary, list[0], list);
-    }
-
+    dictionary = (bufr_elements_table*)grib_context_malloc_clear_persistent(c, sizeof(bufr_elements_table));
+    read_elements(c, f, line, sizeof(line), dictionary);
     fclose(f);
 
     if (localFilename != 0) {
         f = codes_fopen(localFilename, "r");
         if (!f) {
+            free_elements(c, dictionary);
             *err       = GRIB_IO_PROBLEM;
             dictionary = NULL;
             goto the_end;
         }
 
-        while (fgets(line, sizeof(line) - 1, f)) {
-            DEBUG_ASSERT(strlen(line) > 0);
-            if (line[0] == '#') continue; /* Ignore first line with column titles */
-            list = string_split(line, "|");
-            /* Look for the descriptor code in the trie. It might be there from before */
-            cached_list = (char**)grib_trie_get(dictionary, list[0]);
-            if (cached_list) { /* If found, we are about to overwrite it. So free memory */
-                int i;
-                for (i = 0; cached_list[i] != NULL; ++i)
-                    free(cached_list[i]);
-                free(cached_list);
-            }
-            grib_trie_insert(dictionary, list[0], list);
-        }
-
+        /* Local elements override the master ones with the same code */
+        read_elements(c, f, line, sizeof(line), dictionary);
         fclose(f);
     }
     grib_trie_insert(c->lists, dictName, dictionary);
@@ -174,82 +274,34 @@ the_end:
     return dictionary;
 }
 
-static int convert_type(const char* stype)
-{
-    int ret = BUFR_DESCRIPTOR_TYPE_UNKNOWN;
-    switch (stype[0]) {
-        case 's':
-            if (!strcmp(stype, "string"))
-                ret = BUFR_DESCRIPTOR_TYPE_STRING;
-            break;
-        case 'l':
-            if (!strcmp(stype, "long"))
-                ret = BUFR_DESCRIPTOR_TYPE_LONG;
-            break;
-        case 'd':
-            if (!strcmp(stype, "double"))
-                ret = BUFR_DESCRIPTOR_TYPE_DOUBLE;
-            break;
-        case 't':
-            if (!strcmp(stype, "table"))
-                ret = BUFR_DESCRIPTOR_TYPE_TABLE;
-            break;
-        case 'f':
-            if (!strcmp(stype, "flag"))
-                ret = BUFR_DESCRIPTOR_TYPE_FLAG;
-            break;
-        default:
-            ret = BUFR_DESCRIPTOR_TYPE_UNKNOWN;
-    }
-
-    return ret;
-}
-
-static long atol_fast(const char* input)
-{
-    if (strcmp(input, "0") == 0)
-        return 0;
-    return atol(input);
-}
-
 int grib_accessor_bufr_elements_table_t::bufr_get_from_table(bufr_descriptor* v)
 {
-    int ret              = 0;
-    char** list          = 0;
-    char code[7]         = { 0 };
-    const size_t codeLen = sizeof(code);
-
-    grib_trie* table = load_bufr_elements_table(&ret);
-    if (ret)
-        return ret;
-
-    snprintf(code, codeLen, "%06ld", v->code);
-
-    list = (char**)grib_trie_get(table, code);
-    if (!list)
-        return GRIB_NOT_FOUND;
-
-#ifdef DEBUG
-    {
-        /* ECC-1137: check descriptor key name and unit lengths */
-        const size_t maxlen_shortName = sizeof(v->shortName);
-        const size_t maxlen_units     = sizeof(v->units);
-        ECCODES_ASSERT(strlen(list[1]) < maxlen_shortName);
-        ECCODES_ASSERT(strlen(list[4]) < maxlen_units);
+    int ret                          = 0;
+    const bufr_elements_table* table = table_;
+    const bufr_element* e            = NULL;
+    const int index                  = element_index(v->code);
+    grib_handle* h                   = grib_handle_of_accessor(this);
+
+    // The table depends on the tables version keys: it is looked up again only after a key has changed.
+    const bool cacheable = grib_handle_change_count_valid(h);
+    if (!cacheable || !table || table_change_count_ != h->change_count) {
+        table = load_bufr_elements_table(&ret);
+        if (ret)
+            return ret;
+        table_              = cacheable ? table : nullptr;
+        table_change_count_ = h->change_count;
     }
-#endif
-
-    strcpy(v->shortName, list[1]);
-    v->type = convert_type(list[2]);
-    /* v->name=grib_context_strdup(c,list[3]);  See ECC-489 */
-    strcpy(v->units, list[4]);
 
-    /* ECC-985: Scale and reference are often 0 so we can reduce calls to atol */
-    v->scale  = atol_fast(list[5]);
-    v->factor = codes_power<double>(-v->scale, 10);
+    if (index < 0 || (e = table->elements[index]) == NULL)
+        return GRIB_NOT_FOUND;
 
-    v->reference = atol_fast(list[6]);
-    v->width     = atol(list[7]);
+    strcpy(v->shortName, e->shortName);
+    strcpy(v->units, e->units);
+    v->type      = e->type;
+    v->scale     = e->scale;
+    v->factor    = e->factor;
+    v->reference = e->reference;
+    v->width     = e->width;
 
     return GRIB_SUCCESS;
 }
@@ -12,6 +12,8 @@
 
 #include "grib_accessor_class_gen.h"
 
+struct bufr_elements_table;
+
 class grib_accessor_bufr_elements_table_t : public grib_accessor_gen_t
 {
 public:
@@ -29,8 +31,10 @@ private:
     const char* dictionary_ = nullptr;
     const char* masterDir_ = nullptr;
     const char* localDir_ = nullptr;
+    const bufr_elements_table* table_ = nullptr;
+    unsigned long table_change_count_ = 0;
 
-    grib_trie* load_bufr_elements_table(int* err);
+    const bufr_elements_table* load_bufr_elements_table(int* err);
     int bufr_get_from_table(bufr_descriptor* v);
 
     friend bufr_descriptor* accessor_bufr_elements_table_get_descriptor(grib_accessor* a, int code, int* err);
@@ -164,6 +164,13 @@ static void dump_codetable(grib_codetable* atable)
 }
 #endif
 
+static bool codetable_matches(const grib_codetable* t, const char* filename, const char* localFilename)
+{
+    return (filename && t->filename[0] && grib_inline_strcmp(filename, t->filename[0]) == 0) &&
+           ((localFilename == 0 && t->filename[1] == NULL) ||
+            ((localFilename != 0 && t->filename[1] != NULL) && grib_inline_strcmp(localFilename, t->filename[1]) == 0));
+}
+
 grib_codetable* grib_accessor_codetable_t::load_table()
 {
     size_t size                     = 0;
@@ -177,6 +184,7 @@ grib_codetable* grib_accessor_codetable_t::load_table()
     char* localFilename  = 0;
     char masterDir[1024] = {0,};
     char localDir[1024] = {0,};
+    char key[4096] = {0,};
     size_t len = 1024;
 
     if (masterDir_ != NULL)
@@ -204,6 +212,17 @@ grib_codetable* grib_accessor_codetable_t::load_table()
         localFilename = grib_context_full_defs_path(c, localRecomposed);
     }
 
+    /* Tables are only indexed once loaded: look up without locking */
+    if (filename) {
+        snprintf(key, sizeof(key), "%s:%s", filename, localFilename ? localFilename : "");
+        if (c->codetable_index) {
+            t = (grib_codetable*)grib_trie_get(c->codetable_index, key);
+            if (t && codetable_matches(t, filename, localFilename))
+                return t;
+            t = NULL;
+        }
+    }
+
     GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
     GRIB_MUTEX_LOCK(&mutex1); /* GRIB-930 */
 
@@ -214,9 +233,7 @@ grib_codetable* grib_accessor_codetable_t::load_table()
     }
     next = c->codetable;
     while (next) {
-        if ((filename && next->filename[0] && grib_inline_strcmp(filename, next->filename[0]) == 0) &&
-            ((localFilename == 0 && next->filename[1] == NULL) ||
-             ((localFilename != 0 && next->filename[1] != NULL) && grib_inline_strcmp(localFilename, next->filename[1]) == 0))) {
+        if (codetable_matches(next, filename, localFilename)) {
             t = next;
             goto the_end;
         }
@@ -259,6 +276,11 @@ grib_codetable* grib_accessor_codetable_t::load_table()
     }
 
 the_end:
+    if (t && filename && codetable_matches(t, filename, localFilename)) {
+        if (!c->codetable_index)
+            c->codetable_index = grib_trie_new(c);
+        grib_trie_insert(c->codetable_index, key, t);
+    }
     GRIB_MUTEX_UNLOCK(&mutex1);
 
     return t;
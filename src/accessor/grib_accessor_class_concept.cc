@@ -154,9 +154,26 @@ static int concept_condition_true(
         return concept_condition_expression_true(h, c, memo);
 }
 
+// Return 1 (=True) if all the conditions of the concept value are met, setting cnt to their number
+static int concept_value_true(
+    grib_handle* h, grib_concept_value* c, int* cnt,
+    std::unordered_map<std::string_view, long>& memo)
+{
+    grib_concept_condition* e = c->conditions;
+    *cnt = 0;
+    while (e) {
+        if (!concept_condition_true(h, e, memo))
+            return FALSE;
+        e = e->next;
+        (*cnt)++;
+    }
+    return TRUE;
+}
+
 static const char* concept_evaluate(grib_accessor* a)
 {
     int match        = 0;
+    int cnt          = 0;
     const char* best = 0;
     //const char* prev = 0;
     grib_concept_value* c = action_concept_get_concept(a);
@@ -164,18 +181,29 @@ static const char* concept_evaluate(grib_accessor* a)
 
     std::unordered_map<std::string_view, long> memo; // See ECC-1905
 
-    while (c) {
-        // printf("DEBUG: %s concept=%s while loop c->name=%s\n", __func__, a->name_, c->name);
-        grib_concept_condition* e = c->conditions;
-        int cnt = 0;
-        while (e) {
-            if (!concept_condition_true(h, e, memo))
-                break;
-            e = e->next;
-            cnt++;
+    if (c && c->match_index) {
+        // Only the entries in the bucket of the values of the index keys can match
+        const char* keys[MAX_CONCEPT_INDEX_KEYS];
+        long values[MAX_CONCEPT_INDEX_KEYS];
+        const size_t nkeys = grib_concept_match_index_keys(c->match_index, keys);
+        bool found         = true;
+        size_t count       = 0;
+        for (size_t i = 0; i < nkeys && found; i++)
+            found = grib_get_long_memoize(h, keys[i], &values[i], memo) == GRIB_SUCCESS;
+
+        grib_concept_value* const* candidates = grib_concept_match_index_candidates(c->match_index, found ? values : NULL, &count);
+        for (size_t i = 0; i < count; i++) {
+            if (concept_value_true(h, candidates[i], &cnt, memo) && cnt >= match) {
+                match = cnt;
+                best  = candidates[i]->name;
+            }
         }
+        return best;
+    }
 
-        if (e == NULL) {
+    while (c) {
+        // printf("DEBUG: %s concept=%s while loop c->name=%s\n", __func__, a->name_, c->name);
+        if (concept_value_true(h, c, &cnt, memo)) {
             if (cnt >= match) {
                 // prev  = (cnt > match) ? NULL : best;
                 match = cnt;
@@ -191,6 +219,21 @@ static const char* concept_evaluate(grib_accessor* a)
     return best;
 }
 
+// The result is kept until a key of the handle changes
+const char* grib_accessor_concept_t::evaluate()
+{
+    const grib_handle* h = grib_handle_of_accessor(this);
+    if (!grib_handle_change_count_valid(h))
+        return concept_evaluate(this);
+
+    if (!cached_ || cached_change_count_ != h->change_count) {
+        cached_value_        = concept_evaluate(this);
+        cached_change_count_ = h->change_count;
+        cached_              = true;
+    }
+    return cached_value_;
+}
+
 #define MAX_NUM_CONCEPT_VALUES 40
 static int concept_conditions_expression_apply(grib_handle* h, grib_concept_condition* e, grib_values* values, grib_sarray* sa, int* n)
 {
@@ -488,7 +531,7 @@ int grib_accessor_concept_t::unpack_double(double* val, size_t* len)
         }
     }
     else if (flags_ & GRIB_ACCESSOR_FLAG_DOUBLE_TYPE) {
-        const char* p = concept_evaluate(this);
+        const char* p = evaluate();
 
         if (!p) {
             grib_handle* h = grib_handle_of_accessor(this);
@@ -505,7 +548,7 @@ int grib_accessor_concept_t::unpack_double(double* val, size_t* len)
 
 int grib_accessor_concept_t::unpack_long(long* val, size_t* len)
 {
-    const char* p = concept_evaluate(this);
+    const char* p = evaluate();
 
     if (!p) {
         grib_handle* h = grib_handle_of_accessor(this);
@@ -558,7 +601,7 @@ void grib_accessor_concept_t::destroy(grib_context* c)
 int grib_accessor_concept_t::unpack_string(char* val, size_t* len)
 {
     size_t slen;
-    const char* p = concept_evaluate(this);
+    const char* p = evaluate();
 
     if (!p) {
         grib_handle* h = grib_handle_of_accessor(this);
@@ -591,6 +634,7 @@ int grib_accessor_concept_t::unpack_string(char* val, size_t* len)
 
 int grib_accessor_concept_t::pack_string(const char* val, size_t* len)
 {
+    cached_ = false; // Applying the conditions may fail half way
     return grib_concept_apply(this, val);
 }
 
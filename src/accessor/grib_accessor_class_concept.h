@@ -31,4 +31,12 @@ public:
     void dump(eccodes::Dumper*) override;
     void init(const long, grib_arguments*) override;
     int compare(grib_accessor*) override;
+
+    const char* evaluate();
+
+private:
+    // Result of the last evaluation and the handle change count it is valid for
+    const char* cached_value_          = nullptr;
+    unsigned long cached_change_count_ = 0;
+    bool cached_                       = false;
 };
@@ -9,6 +9,8 @@
  */
 
 #include "grib_accessor_class_data_apply_bitmap.h"
+#include <algorithm>
+#include <bitset>
 
 grib_accessor_data_apply_bitmap_t _grib_accessor_data_apply_bitmap{};
 grib_accessor* grib_accessor_data_apply_bitmap = &_grib_accessor_data_apply_bitmap;
@@ -47,66 +49,94 @@ int grib_accessor_data_apply_bitmap_t::value_count(long* count)
     return ret;
 }
 
-int grib_accessor_data_apply_bitmap_t::unpack_double_element(size_t idx, double* val)
+int grib_accessor_data_apply_bitmap_t::build_bitmap_index()
 {
     grib_handle* gh = grib_handle_of_accessor(this);
-    size_t i = 0, cidx = 0;
-    double missing_value = 0;
-    double* bvals        = NULL;
-    size_t n_vals        = 0;
-    long nn              = 0;
+    double* bvals   = NULL;
+    size_t n_vals   = 0;
+    size_t rank     = 0;
+    long nn         = 0;
+
+    const bool cacheable = grib_handle_change_count_valid(gh);
+    if (cacheable && bitmap_index_valid_ && bitmap_change_count_ == gh->change_count)
+        return GRIB_SUCCESS;
+    bitmap_index_valid_ = false;
 
     int err = value_count(&nn);
     n_vals  = nn;
     if (err)
         return err;
 
-    if (!grib_find_accessor(gh, bitmap_))
-        return grib_get_double_element_internal(gh, coded_values_, idx, val);
-
-    if ((err = grib_get_double_internal(gh, missing_value_, &missing_value)) != GRIB_SUCCESS)
-        return err;
+    bvals = (double*)grib_context_malloc(context_, n_vals * sizeof(double));
+    if (n_vals && bvals == NULL)
+        return GRIB_OUT_OF_MEMORY;
 
-    if ((err = grib_get_double_element_internal(gh, bitmap_, idx, val)) != GRIB_SUCCESS)
+    if ((err = grib_get_double_array_internal(gh, bitmap_, bvals, &n_vals)) != GRIB_SUCCESS) {
+        grib_context_free(context_, bvals);
         return err;
+    }
 
-    if (*val == 0) {
-        *val = missing_value;
-        return GRIB_SUCCESS;
+    bitmap_size_ = n_vals;
+    bitmap_words_.assign((n_vals + 63) / 64, 0);
+    bitmap_ranks_.resize(bitmap_words_.size());
+    for (size_t w = 0; w < bitmap_words_.size(); w++) {
+        const size_t end = std::min(n_vals, (w + 1) * 64);
+        uint64_t word    = 0;
+        for (size_t i = w * 64; i < end; i++) {
+            if (bvals[i] != 0)
+                word |= (uint64_t)1 << (i & 63);
+        }
+        bitmap_words_[w] = word;
+        bitmap_ranks_[w] = rank;
+        rank += std::bitset<64>(word).count();
     }
+    grib_context_free(context_, bvals);
 
-    bvals = (double*)grib_context_malloc(context_, n_vals * sizeof(double));
-    if (bvals == NULL)
-        return GRIB_OUT_OF_MEMORY;
+    bitmap_change_count_ = gh->change_count;
+    bitmap_index_valid_  = cacheable;
+    return GRIB_SUCCESS;
+}
+
+// Is the grid point idx present in the bitmap? If so, cidx is its index into the coded values
+static bool bitmap_lookup(const std::vector<uint64_t>& words, const std::vector<size_t>& ranks, size_t idx, size_t* cidx)
+{
+    const uint64_t word = words[idx >> 6];
+    const uint64_t bit  = (uint64_t)1 << (idx & 63);
+    if (!(word & bit))
+        return false;
+    *cidx = ranks[idx >> 6] + std::bitset<64>(word & (bit - 1)).count();
+    return true;
+}
+
+int grib_accessor_data_apply_bitmap_t::unpack_double_element(size_t idx, double* val)
+{
+    grib_handle* gh = grib_handle_of_accessor(this);
+    size_t cidx     = 0;
+    int err         = 0;
+
+    if (!grib_find_accessor(gh, bitmap_))
+        return grib_get_double_element_internal(gh, coded_values_, idx, val);
 
-    if ((err = grib_get_double_array_internal(gh, bitmap_, bvals, &n_vals)) != GRIB_SUCCESS)
+    if ((err = build_bitmap_index()) != GRIB_SUCCESS)
         return err;
+    if (idx >= bitmap_size_)
+        return GRIB_INVALID_ARGUMENT;
 
-    cidx = 0;
-    for (i = 0; i < idx; i++) {
-        cidx += bvals[i];
+    if (!bitmap_lookup(bitmap_words_, bitmap_ranks_, idx, &cidx)) {
+        return grib_get_double_internal(gh, missing_value_, val);
     }
 
-    grib_context_free(context_, bvals);
-
     return grib_get_double_element_internal(gh, coded_values_, cidx, val);
 }
 
 int grib_accessor_data_apply_bitmap_t::unpack_double_element_set(const size_t* index_array, size_t len, double* val_array)
 {
-    grib_handle* gh = grib_handle_of_accessor(this);
-    int err = 0, all_missing = 1;
-    size_t cidx          = 0;    /* index into the coded_values array */
+    grib_handle* gh      = grib_handle_of_accessor(this);
+    int err              = 0;
     size_t* cidx_array   = NULL; /* array of indexes into the coded_values */
     double* cval_array   = NULL; /* array of values of the coded_values */
     double missing_value = 0;
-    double* bvals        = NULL;
-    size_t n_vals = 0, i = 0, j = 0, idx = 0, count_1s = 0, ci = 0;
-    long nn = 0;
-
-    err    = value_count(&nn);
-    n_vals = nn;
-    if (err) return err;
+    size_t i = 0, count_1s = 0, ci = 0;
 
     if (!grib_find_accessor(gh, bitmap_))
         return grib_get_double_element_set_internal(gh, coded_values_, index_array, len, val_array);
@@ -114,62 +144,50 @@ int grib_accessor_data_apply_bitmap_t::unpack_double_element_set(const size_t* i
     if ((err = grib_get_double_internal(gh, missing_value_, &missing_value)) != GRIB_SUCCESS)
         return err;
 
-    err = grib_get_double_element_set_internal(gh, bitmap_, index_array, len, val_array);
-    if (err) return err;
+    if ((err = build_bitmap_index()) != GRIB_SUCCESS)
+        return err;
+
+    cidx_array = (size_t*)grib_context_malloc(context_, len * sizeof(size_t));
+    if (len && !cidx_array)
+        return GRIB_OUT_OF_MEMORY;
+
     for (i = 0; i < len; i++) {
-        if (val_array[i] == 0) {
-            val_array[i] = missing_value;
+        if (index_array[i] >= bitmap_size_) {
+            grib_context_free(context_, cidx_array);
+            return GRIB_INVALID_ARGUMENT;
         }
-        else {
-            all_missing = 0;
+        if (bitmap_lookup(bitmap_words_, bitmap_ranks_, index_array[i], &cidx_array[count_1s]))
             count_1s++;
-        }
+        else
+            val_array[i] = missing_value;
     }
 
-    if (all_missing) {
+    if (count_1s == 0) {
+        grib_context_free(context_, cidx_array);
         return GRIB_SUCCESS;
     }
 
-    /* At this point val_array contains entries which are either missing_value or 1 */
     /* Now we need to dig into the codes values with index array of count_1s */
-
-    bvals = (double*)grib_context_malloc(context_, n_vals * sizeof(double));
-    if (!bvals) return GRIB_OUT_OF_MEMORY;
-
-    if ((err = grib_get_double_array_internal(gh, bitmap_, bvals, &n_vals)) != GRIB_SUCCESS)
-        return err;
-
-    cidx_array = (size_t*)grib_context_malloc(context_, count_1s * sizeof(size_t));
     cval_array = (double*)grib_context_malloc(context_, count_1s * sizeof(double));
-
-    ci = 0;
-    for (i = 0; i < len; i++) {
-        if (val_array[i] == 1) {
-            idx  = index_array[i];
-            cidx = 0;
-            for (j = 0; j < idx; j++) {
-                cidx += bvals[j];
-            }
-            ECCODES_ASSERT(ci < count_1s);
-            cidx_array[ci++] = cidx;
-        }
+    if (!cval_array) {
+        grib_context_free(context_, cidx_array);
+        return GRIB_OUT_OF_MEMORY;
     }
-    err = grib_get_double_element_set_internal(gh, coded_values_, cidx_array, count_1s, cval_array);
-    if (err) return err;
 
-    /* Transfer from cval_array to our result val_array */
-    ci = 0;
-    for (i = 0; i < len; i++) {
-        if (val_array[i] == 1) {
-            val_array[i] = cval_array[ci++];
+    err = grib_get_double_element_set_internal(gh, coded_values_, cidx_array, count_1s, cval_array);
+    if (!err) {
+        /* Transfer from cval_array to our result val_array */
+        for (i = 0; i < len; i++) {
+            size_t cidx = 0;
+            if (bitmap_lookup(bitmap_words_, bitmap_ranks_, index_array[i], &cidx))
+                val_array[i] = cval_array[ci++];
         }
     }
 
-    grib_context_free(context_, bvals);
     grib_context_free(context_, cidx_array);
     grib_context_free(context_, cval_array);
 
-    return GRIB_SUCCESS;
+    return err;
 }
 
 int grib_accessor_data_apply_bitmap_t::pack_double(const double* val, size_t* len)
@@ -187,6 +205,8 @@ int grib_accessor_data_apply_bitmap_t::pack_double(const double* val, size_t* le
     if (*len == 0)
         return GRIB_NO_VALUES;
 
+    bitmap_index_valid_ = false;
+
     if (!grib_find_accessor(hand, bitmap_)) {
         /*printf("SETTING TOTAL number_of_data_points %s %ld\n",number_of_data_points_ ,*len);*/
         if (number_of_data_points_)
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "grib_accessor_class_gen.h"
+#include <vector>
 
 class grib_accessor_data_apply_bitmap_t : public grib_accessor_gen_t
 {
@@ -29,6 +30,9 @@ public:
     int unpack_double_element(size_t i, double* val) override;
     int unpack_double_element_set(const size_t* index_array, size_t len, double* val_array) override;
 
+    // Name of the key holding the values actually coded, i.e. without the missing ones
+    const char* coded_values() const { return coded_values_; }
+
 private:
     const char* coded_values_ = nullptr;
     const char* bitmap_ = nullptr;
@@ -37,5 +41,14 @@ private:
     const char* number_of_values_ = nullptr;
     const char* binary_scale_factor_ = nullptr;
 
+    // Rank index over the bitmap: its bits packed in words of 64 grid points and the number of
+    // set bits before each word. Built on the first element access, valid until a key of the handle changes
+    std::vector<uint64_t> bitmap_words_;
+    std::vector<size_t> bitmap_ranks_;
+    size_t bitmap_size_ = 0;
+    unsigned long bitmap_change_count_ = 0;
+    bool bitmap_index_valid_ = false;
+
     template <typename T> int unpack(T* val, size_t* len);
+    int build_bitmap_index();
 };
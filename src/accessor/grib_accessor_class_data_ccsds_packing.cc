@@ -9,6 +9,7 @@
  */
 
 #include "grib_accessor_class_data_ccsds_packing.h"
+#include <algorithm>
 
 #if defined(HAVE_LIBAEC) || defined(HAVE_AEC)
     #include <libaec.h>
@@ -111,7 +112,8 @@ int grib_accessor_data_ccsds_packing_t::pack_double(const double* val, size_t* l
 
     struct aec_stream strm;
 
-    dirty_ = 1;
+    dirty_            = 1;
+    rsi_offsets_data_ = nullptr;
 
     n_vals = *len;
 
@@ -142,14 +144,7 @@ int grib_accessor_data_ccsds_packing_t::pack_double(const double* val, size_t* l
         return GRIB_SUCCESS;
     }
 
-    max = val[0];
-    min = max;
-    for (i = 1; i < n_vals; i++) {
-        if (val[i] > max)
-            max = val[i];
-        else if (val[i] < min)
-            min = val[i];
-    }
+    grib_get_min_max(val, n_vals, &min, &max);
 
     if ((err = grib_check_data_values_minmax(hand, min, max)) != GRIB_SUCCESS) {
         return err;
@@ -522,50 +517,153 @@ int grib_accessor_data_ccsds_packing_t::unpack_float(float* val, size_t* len)
     return unpack<float>(val, len);
 }
 
-int grib_accessor_data_ccsds_packing_t::unpack_double_element(size_t idx, double* val)
+// Random access to the packed values
+//
+// The stream is made of reference sample intervals (RSI) of ccsds_rsi blocks which are coded
+// independently of each other. The bit offset of each interval is found once by walking the
+// block headers (see CCSDS 121.0-B), after which an element is decoded from its interval alone.
+
+#define CCSDS_ROS 5  // Zero-block count meaning "to the end of the segment or interval"
+
+typedef struct ccsds_bit_reader
 {
-    // The index idx relates to codedValues NOT values!
-    grib_handle* hand      = grib_handle_of_accessor(this);
-    int err                = 0;
-    size_t size            = 0;
-    long bits_per_value    = 0;
-    double reference_value = 0;
-    double* values         = NULL;
+    const unsigned char* data;
+    size_t nbits;
+    size_t pos;
+} ccsds_bit_reader;
 
-    if ((err = grib_get_long_internal(hand, bits_per_value_, &bits_per_value)) != GRIB_SUCCESS)
-        return err;
-    if ((err = grib_get_double_internal(hand, reference_value_, &reference_value)) != GRIB_SUCCESS)
-        return err;
+static bool ccsds_skip_bits(ccsds_bit_reader* r, size_t n)
+{
+    if (r->nbits - r->pos < n)
+        return false;
+    r->pos += n;
+    return true;
+}
 
-    // Special case of constant field
-    if (bits_per_value == 0) {
-        *val = reference_value;
-        return GRIB_SUCCESS;
-    }
+static bool ccsds_read_bits(ccsds_bit_reader* r, int n, unsigned* val)
+{
+    if (r->nbits - r->pos < (size_t)n)
+        return false;
+    *val = 0;
+    for (int i = 0; i < n; i++, r->pos++)
+        *val = (*val << 1) | ((r->data[r->pos >> 3] >> (7 - (r->pos & 7))) & 1);
+    return true;
+}
 
-    err = grib_get_size(hand, "codedValues", &size);
-    if (err) return err;
-    if (idx > size) return GRIB_INVALID_ARGUMENT;
+// Fundamental sequence: the number of 0 bits before the next 1 bit
+static bool ccsds_read_fs(ccsds_bit_reader* r, unsigned* fs)
+{
+    *fs = 0;
+    while (r->pos < r->nbits) {
+        const unsigned byte = (r->data[r->pos >> 3] << (r->pos & 7)) & 0xff;
+        if (byte == 0) {
+            const size_t n = 8 - (r->pos & 7);
+            *fs += n;
+            r->pos += n;
+            continue;
+        }
+        unsigned mask = 0x80;
+        while (!(byte & mask)) {
+            mask >>= 1;
+            (*fs)++;
+            r->pos++;
+        }
+        r->pos++;
+        return r->pos <= r->nbits;
+    }
+    return false;
+}
 
-    values = (double*)grib_context_malloc_clear(context_, size * sizeof(double));
-    err    = grib_get_double_array(hand, "codedValues", values, &size);
-    if (err) {
-        grib_context_free(context_, values);
-        return err;
+// Bit offsets of the intervals holding n_vals samples. Fails unless the block headers account for
+// the whole stream, in which case the data is decoded in full instead
+static bool ccsds_rsi_offsets(const unsigned char* buf, size_t buflen, long bits_per_value, long flags,
+                              long block_size, long rsi, size_t n_vals, std::vector<size_t>& offsets)
+{
+    ccsds_bit_reader r = { buf, buflen * 8, 0 };
+    const size_t rsi_samples = rsi * block_size;
+    const size_t nrsi        = (n_vals + rsi_samples - 1) / rsi_samples;
+    const bool preprocess    = flags & AEC_DATA_PREPROCESS;
+    int id_len               = 3;
+    unsigned id = 0, fs = 0;
+
+    if (block_size <= 0 || block_size % 2 || rsi <= 0 || bits_per_value <= 0 || bits_per_value > MAX_BITS_PER_VALUE)
+        return false;
+    if (bits_per_value > 16)
+        id_len = 5;
+    else if (bits_per_value > 8)
+        id_len = 4;
+    else if (flags & AEC_RESTRICTED)
+        id_len = bits_per_value <= 2 ? 1 : 2;
+    const unsigned id_uncompressed = (1u << id_len) - 1;
+
+    offsets.resize(nrsi);
+    for (size_t n = 0; n < nrsi; n++) {
+        if (flags & AEC_PAD_RSI)
+            r.pos = (r.pos + 7) & ~(size_t)7;
+        offsets[n] = r.pos;
+
+        const size_t samples = std::min(rsi_samples, n_vals - n * rsi_samples);
+        const long nblocks   = (samples + block_size - 1) / block_size;
+        long b               = 0;
+        while (b < nblocks) {
+            const int ref = preprocess && b == 0;
+            if (!ccsds_read_bits(&r, id_len, &id))
+                return false;
+            if (id == 0) {
+                unsigned second_extension = 0;
+                if (!ccsds_read_bits(&r, 1, &second_extension) || (ref && !ccsds_skip_bits(&r, bits_per_value)))
+                    return false;
+                if (second_extension) {
+                    for (long i = 0; i < block_size / 2; i++)
+                        if (!ccsds_read_fs(&r, &fs))
+                            return false;
+                }
+                else {
+                    if (!ccsds_read_fs(&r, &fs))
+                        return false;
+                    long zero_blocks = fs + 1;
+                    if (zero_blocks == CCSDS_ROS)
+                        zero_blocks = std::min(rsi - b, 64 - (b % 64));
+                    else if (zero_blocks > CCSDS_ROS)
+                        zero_blocks--;
+                    b += zero_blocks;
+                    continue;
+                }
+            }
+            else if (id == id_uncompressed) {
+                if (!ccsds_skip_bits(&r, block_size * bits_per_value))
+                    return false;
+            }
+            else {
+                const long k = id - 1;
+                if (ref && !ccsds_skip_bits(&r, bits_per_value))
+                    return false;
+                for (long i = ref; i < block_size; i++)
+                    if (!ccsds_read_fs(&r, &fs))
+                        return false;
+                if (!ccsds_skip_bits(&r, (block_size - ref) * k))
+                    return false;
+            }
+            b++;
+        }
     }
-    *val = values[idx];
-    grib_context_free(context_, values);
-    return GRIB_SUCCESS;
+
+    // The stream ends with at most a few bytes of padding
+    const size_t used = (r.pos + 7) / 8;
+    return used <= buflen && buflen - used < 8;
 }
 
-int grib_accessor_data_ccsds_packing_t::unpack_double_element_set(const size_t* index_array, size_t len, double* val_array)
+int grib_accessor_data_ccsds_packing_t::unpack_elements(const size_t* index_array, size_t len, double* val_array)
 {
-    grib_handle* hand = grib_handle_of_accessor(this);
-    size_t size = 0, i = 0;
-    double* values         = NULL;
-    int err                = 0;
-    long bits_per_value    = 0;
-    double reference_value = 0;
+    // The indexes relate to codedValues NOT values!
+    grib_handle* hand         = grib_handle_of_accessor(this);
+    int err                   = 0;
+    long nn                   = 0;
+    long bits_per_value       = 0;
+    long binary_scale_factor  = 0;
+    long decimal_scale_factor = 0;
+    double reference_value    = 0;
+    long ccsds_flags = 0, ccsds_block_size = 0, ccsds_rsi = 0;
 
     if ((err = grib_get_long_internal(hand, bits_per_value_, &bits_per_value)) != GRIB_SUCCESS)
         return err;
@@ -574,35 +672,137 @@ int grib_accessor_data_ccsds_packing_t::unpack_double_element_set(const size_t*
 
     // Special case of constant field
     if (bits_per_value == 0) {
-        for (i = 0; i < len; i++) {
+        for (size_t i = 0; i < len; i++)
             val_array[i] = reference_value;
-        }
         return GRIB_SUCCESS;
     }
 
-    // GRIB-564: The indexes in index_array relate to codedValues NOT values!
-    err = grib_get_size(grib_handle_of_accessor(this), "codedValues", &size);
-    if (err)
+    if ((err = value_count(&nn)) != GRIB_SUCCESS)
         return err;
+    const size_t n_vals = nn;
+    for (size_t i = 0; i < len; i++) {
+        if (index_array[i] >= n_vals) return GRIB_INVALID_ARGUMENT;
+    }
 
-    for (i = 0; i < len; i++) {
-        if (index_array[i] > size) return GRIB_INVALID_ARGUMENT;
+    if ((err = grib_get_long_internal(hand, binary_scale_factor_, &binary_scale_factor)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(hand, decimal_scale_factor_, &decimal_scale_factor)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long(hand, ccsds_flags_, &ccsds_flags)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(hand, ccsds_block_size_, &ccsds_block_size)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(hand, ccsds_rsi_, &ccsds_rsi)) != GRIB_SUCCESS)
+        return err;
+    modify_aec_flags(&ccsds_flags);
+
+    const unsigned char* buf = hand->buffer->data + byte_offset();
+    const size_t buflen      = byte_count();
+    const std::array<long, 4> params = { bits_per_value, ccsds_flags, ccsds_block_size, ccsds_rsi };
+    if (rsi_offsets_data_ != buf || rsi_offsets_length_ != buflen || rsi_offsets_params_ != params) {
+        if (!ccsds_rsi_offsets(buf, buflen, bits_per_value, ccsds_flags, ccsds_block_size, ccsds_rsi, n_vals, rsi_offsets_))
+            rsi_offsets_.clear();
+        rsi_offsets_data_   = buf;
+        rsi_offsets_length_ = buflen;
+        rsi_offsets_params_ = params;
     }
 
-    values = (double*)grib_context_malloc_clear(context_, size * sizeof(double));
-    err    = grib_get_double_array(grib_handle_of_accessor(this), "codedValues", values, &size);
-    if (err) {
+    // Visit the elements by interval
+    const size_t rsi_samples = ccsds_rsi * ccsds_block_size;
+    std::vector<size_t> order(len);
+    for (size_t i = 0; i < len; i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [index_array](size_t a, size_t b) { return index_array[a] < index_array[b]; });
+    size_t nrsi_used = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (i == 0 || index_array[order[i]] / rsi_samples != index_array[order[i - 1]] / rsi_samples)
+            nrsi_used++;
+    }
+
+    // Decode in full when the intervals cannot be located or most of them are needed
+    if (rsi_offsets_.empty() || nrsi_used > rsi_offsets_.size() / 2) {
+        size_t size    = n_vals;
+        double* values = (double*)grib_context_malloc(context_, size * sizeof(double));
+        if (!values)
+            return GRIB_OUT_OF_MEMORY;
+        err = unpack<double>(values, &size);
+        if (err == GRIB_SUCCESS) {
+            for (size_t i = 0; i < len; i++)
+                val_array[i] = values[index_array[i]];
+        }
         grib_context_free(context_, values);
         return err;
     }
-    for (i = 0; i < len; i++) {
-        val_array[i] = values[index_array[i]];
+
+    const double bscale = codes_power<double>(binary_scale_factor, 2);
+    const double dscale = codes_power<double>(-decimal_scale_factor, 10);
+    size_t nbytes       = (bits_per_value + 7) / 8;
+    if (nbytes == 3)
+        nbytes = 4;
+
+    std::vector<unsigned char> decoded(rsi_samples * nbytes);
+    std::vector<unsigned char> input;
+    size_t current = (size_t)-1;
+    for (size_t i = 0; i < len; i++) {
+        const size_t idx = index_array[order[i]];
+        const size_t n   = idx / rsi_samples;
+        if (n != current) {
+            // Copy the interval so that it starts on a byte boundary
+            const size_t start = rsi_offsets_[n];
+            const size_t end   = n + 1 < rsi_offsets_.size() ? rsi_offsets_[n + 1] : buflen * 8;
+            const size_t first = start / 8;
+            const size_t last  = std::min((end + 7) / 8, buflen);
+            const int shift    = start % 8;
+            input.assign(last - first + 1, 0);
+            for (size_t j = first; j < last; j++)
+                input[j - first] = (unsigned char)((buf[j] << shift) | (j + 1 < buflen && shift ? buf[j + 1] >> (8 - shift) : 0));
+
+            struct aec_stream strm;
+            strm.flags           = ccsds_flags;
+            strm.bits_per_sample = bits_per_value;
+            strm.block_size      = ccsds_block_size;
+            strm.rsi             = ccsds_rsi;
+            strm.next_in         = input.data();
+            strm.avail_in        = input.size();
+            strm.next_out        = decoded.data();
+            strm.avail_out       = std::min(rsi_samples, n_vals - n * rsi_samples) * nbytes;
+            if ((err = aec_buffer_decode(&strm)) != AEC_OK) {
+                grib_context_log(context_, GRIB_LOG_ERROR, "%s %s: aec_buffer_decode error %d (%s)",
+                                 class_name_, __func__, err, aec_get_error_message(err));
+                return GRIB_DECODING_ERROR;
+            }
+            current = n;
+        }
+
+        const size_t k = idx - current * rsi_samples;
+        double x       = 0;
+        switch (nbytes) {
+            case 1:
+                x = reinterpret_cast<uint8_t*>(decoded.data())[k];
+                break;
+            case 2:
+                x = reinterpret_cast<uint16_t*>(decoded.data())[k];
+                break;
+            case 4:
+                x = reinterpret_cast<uint32_t*>(decoded.data())[k];
+                break;
+        }
+        val_array[order[i]] = (x * bscale + reference_value) * dscale;
     }
 
-    grib_context_free(context_, values);
     return GRIB_SUCCESS;
 }
 
+int grib_accessor_data_ccsds_packing_t::unpack_double_element(size_t idx, double* val)
+{
+    return unpack_elements(&idx, 1, val);
+}
+
+int grib_accessor_data_ccsds_packing_t::unpack_double_element_set(const size_t* index_array, size_t len, double* val_array)
+{
+    return unpack_elements(index_array, len, val_array);
+}
+
 #else
 
 static void print_error_feature_not_enabled(grib_context* c)
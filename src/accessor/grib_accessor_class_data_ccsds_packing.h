@@ -12,6 +12,8 @@
 
 #include "grib_accessor_class_values.h"
 #include "grib_scaling.h"
+#include <array>
+#include <vector>
 
 class grib_accessor_data_ccsds_packing_t : public grib_accessor_values_t
 {
@@ -39,5 +41,13 @@ private:
     const char* ccsds_block_size_ = nullptr;
     const char* ccsds_rsi_ = nullptr;
 
+    // Bit offsets of the reference sample intervals of the packed data, built on the first
+    // element access. Valid for the data and the parameters (bitsPerValue, flags, block size, rsi) below
+    std::vector<size_t> rsi_offsets_;
+    const unsigned char* rsi_offsets_data_ = nullptr;
+    size_t rsi_offsets_length_ = 0;
+    std::array<long, 4> rsi_offsets_params_ = {};
+
     template <typename T> int unpack(T* val, size_t* len);
+    int unpack_elements(const size_t* index_array, size_t len, double* val_array);
 };
@@ -10,6 +10,7 @@
 
 #include "grib_accessor_class_data_g1second_order_general_extended_packing.h"
 #include "grib_scaling.h"
+#include <algorithm>
 
 grib_accessor_data_g1second_order_general_extended_packing_t _grib_accessor_data_g1second_order_general_extended_packing{};
 grib_accessor* grib_accessor_data_g1second_order_general_extended_packing = &_grib_accessor_data_g1second_order_general_extended_packing;
@@ -89,6 +90,27 @@ void grib_accessor_data_g1second_order_general_extended_packing_t::init(const lo
     flags_ |= GRIB_ACCESSOR_FLAG_DATA;
 }
 
+// One step of the undoing of the spatial differencing, as done in unpack.
+// spd holds y (order 1), y and z (order 2) or y, z and w (order 3)
+static long spd_step(long spd[3], long orderOfSPD, long bias, long x)
+{
+    switch (orderOfSPD) {
+        case 1:
+            spd[0] += x + bias;
+            return spd[0];
+        case 2:
+            spd[0] += x + bias;
+            spd[1] += spd[0];
+            return spd[1];
+        case 3:
+            spd[1] += x + bias;
+            spd[0] += spd[1];
+            spd[2] += spd[0];
+            return spd[2];
+    }
+    return x;
+}
+
 int grib_accessor_data_g1second_order_general_extended_packing_t::value_count(long* count)
 {
     long numberOfCodedValues = 0;
@@ -125,58 +147,215 @@ int grib_accessor_data_g1second_order_general_extended_packing_t::value_count(lo
     return err;
 }
 
-int grib_accessor_data_g1second_order_general_extended_packing_t::unpack_double_element(size_t idx, double* val)
+int grib_accessor_data_g1second_order_general_extended_packing_t::build_group_index()
 {
-    size_t size;
-    double* values;
-    int err = 0;
+    grib_handle* handle                = grib_handle_of_accessor(this);
+    g1second_order_group_index& gi     = group_index_;
+    const unsigned char* buf           = (unsigned char*)handle->buffer->data + byte_offset();
+    long *groupWidths = NULL, *groupLengths = NULL, *firstOrderValues = NULL;
+    long numberOfGroups = 0, binary_scale_factor = 0, decimal_scale_factor = 0;
+    long numberOfValues = 0, orderOfSPD = 0, pos = 0;
+    double reference_value = 0;
+    size_t ngroups = 0;
+    int ret        = 0;
+
+    const bool cacheable = grib_handle_change_count_valid(handle);
+    if (cacheable && gi.valid && gi.change_count == handle->change_count)
+        return GRIB_SUCCESS;
+    gi.valid = false;
+    gi.groups.clear();
+
+    if ((ret = value_count(&numberOfValues)) != GRIB_SUCCESS)
+        return ret;
+    if ((ret = grib_get_long_internal(handle, numberOfGroups_, &numberOfGroups)) != GRIB_SUCCESS)
+        return ret;
+    if ((ret = grib_get_long_internal(handle, binary_scale_factor_, &binary_scale_factor)) != GRIB_SUCCESS)
+        return ret;
+    if ((ret = grib_get_long_internal(handle, decimal_scale_factor_, &decimal_scale_factor)) != GRIB_SUCCESS)
+        return ret;
+    if ((ret = grib_get_double_internal(handle, reference_value_, &reference_value)) != GRIB_SUCCESS)
+        return ret;
+    if ((ret = grib_get_long_internal(handle, orderOfSPD_, &orderOfSPD)) != GRIB_SUCCESS)
+        return ret;
+    if (orderOfSPD < 0 || orderOfSPD > 3)
+        return GRIB_DECODING_ERROR;
 
-    /* GRIB-564: The index idx relates to codedValues NOT values! */
-    err = grib_get_size(grib_handle_of_accessor(this), "codedValues", &size);
-    if (err)
-        return err;
-    if (idx >= size)
-        return GRIB_INVALID_ARGUMENT;
+    gi.numberOfValues  = numberOfValues;
+    gi.orderOfSPD      = orderOfSPD;
+    gi.reference_value = reference_value;
+    gi.s               = codes_power<double>(binary_scale_factor, 2);
+    gi.d               = codes_power<double>(-decimal_scale_factor, 10);
 
-    values = (double*)grib_context_malloc_clear(context_, size * sizeof(double));
-    err    = grib_get_double_array(grib_handle_of_accessor(this), "codedValues", values, &size);
-    if (err) {
-        grib_context_free(context_, values);
-        return err;
+    if (orderOfSPD) {
+        long SPD[4]  = { 0, 0, 0, 0 };
+        size_t nSPD = orderOfSPD + 1;
+        if ((ret = grib_get_long_array(handle, SPD_, SPD, &nSPD)) != GRIB_SUCCESS)
+            return ret;
+        for (long i = 0; i < orderOfSPD; i++)
+            gi.SPD[i] = SPD[i];
+        gi.bias = SPD[orderOfSPD];
+    }
+
+    if (numberOfGroups > 0) {
+        ngroups          = numberOfGroups;
+        groupWidths      = (long*)grib_context_malloc_clear(context_, sizeof(long) * numberOfGroups);
+        groupLengths     = (long*)grib_context_malloc_clear(context_, sizeof(long) * numberOfGroups);
+        firstOrderValues = (long*)grib_context_malloc_clear(context_, sizeof(long) * numberOfGroups);
+        if (!groupWidths || !groupLengths || !firstOrderValues)
+            ret = GRIB_OUT_OF_MEMORY;
+        if (!ret)
+            ret = grib_get_long_array(handle, groupWidths_, groupWidths, &ngroups);
+        if (!ret)
+            ret = grib_get_long_array(handle, groupLengths_, groupLengths, &ngroups);
+        if (!ret)
+            ret = grib_get_long_array(handle, firstOrderValues_, firstOrderValues, &ngroups);
+    }
+
+    // The state of the spatial differencing at the start of each group needs all values before it
+    long spd[3] = { 0, 0, 0 };
+    switch (orderOfSPD) {
+        case 1:
+            spd[0] = gi.SPD[0];
+            break;
+        case 2:
+            spd[0] = gi.SPD[1] - gi.SPD[0];
+            spd[1] = gi.SPD[1];
+            break;
+        case 3:
+            spd[0] = gi.SPD[2] - gi.SPD[1];
+            spd[1] = spd[0] - (gi.SPD[1] - gi.SPD[0]);
+            spd[2] = gi.SPD[2];
+            break;
     }
-    *val = values[idx];
-    grib_context_free(context_, values);
+
+    std::vector<long> X;
+    long n = orderOfSPD;
+    for (long i = 0; !ret && i < numberOfGroups; i++) {
+        g1second_order_group g = { n, pos, firstOrderValues[i], groupWidths[i], { spd[0], spd[1], spd[2] } };
+        gi.groups.push_back(g);
+
+        if (orderOfSPD) {
+            X.assign(groupLengths[i], 0);
+            if (groupWidths[i] > 0) {
+                long p = pos;
+                grib_decode_long_array(buf, &p, groupWidths[i], groupLengths[i], X.data());
+            }
+            for (long j = 0; j < groupLengths[i]; j++)
+                spd_step(spd, orderOfSPD, gi.bias, X[j] + firstOrderValues[i]);
+        }
+        if (groupWidths[i] > 0)
+            pos += groupWidths[i] * groupLengths[i];
+        n += groupLengths[i];
+    }
+    if (!ret && n != numberOfValues)
+        ret = GRIB_DECODING_ERROR;
+
+    grib_context_free(context_, groupWidths);
+    grib_context_free(context_, groupLengths);
+    grib_context_free(context_, firstOrderValues);
+    if (ret) {
+        gi.groups.clear();
+        return ret;
+    }
+
+    gi.change_count = handle->change_count;
+    gi.valid        = cacheable;
     return GRIB_SUCCESS;
 }
 
-int grib_accessor_data_g1second_order_general_extended_packing_t::unpack_double_element_set(const size_t* index_array, size_t len, double* val_array)
+static bool group_first_less(long idx, const g1second_order_group& g)
 {
-    size_t size = 0, i = 0;
-    double* values;
-    int err = 0;
+    return idx < g.first;
+}
 
+int grib_accessor_data_g1second_order_general_extended_packing_t::unpack_elements(const size_t* index_array, size_t len, double* val_array)
+{
     /* GRIB-564: The indexes in index_array relate to codedValues NOT values! */
-    err = grib_get_size(grib_handle_of_accessor(this), "codedValues", &size);
-    if (err)
+    grib_handle* handle                  = grib_handle_of_accessor(this);
+    const g1second_order_group_index& gi = group_index_;
+    size_t i                             = 0;
+    int err                              = 0;
+
+    /* Values already decoded in full */
+    if (!double_dirty_ && dvalues_) {
+        for (i = 0; i < len; i++) {
+            if (index_array[i] >= size_) return GRIB_INVALID_ARGUMENT;
+        }
+        for (i = 0; i < len; i++)
+            val_array[i] = dvalues_[index_array[i]];
+        return GRIB_SUCCESS;
+    }
+
+    if ((err = build_group_index()) != GRIB_SUCCESS)
         return err;
 
     for (i = 0; i < len; i++) {
-        if (index_array[i] > size) return GRIB_INVALID_ARGUMENT;
+        if (index_array[i] >= (size_t)gi.numberOfValues) return GRIB_INVALID_ARGUMENT;
     }
 
-    values = (double*)grib_context_malloc_clear(context_, size * sizeof(double));
-    err    = grib_get_double_array(grib_handle_of_accessor(this), "codedValues", values, &size);
-    if (err) {
+    /* Decoding the whole field is cheaper when many values are wanted. They are then kept in dvalues_ */
+    if (len > (size_t)gi.numberOfValues / 32) {
+        size_t size    = gi.numberOfValues;
+        double* values = (double*)grib_context_malloc_clear(context_, size * sizeof(double));
+        if (!values)
+            return GRIB_OUT_OF_MEMORY;
+        err = unpack_double(values, &size);
+        if (!err) {
+            for (i = 0; i < len; i++)
+                val_array[i] = values[index_array[i]];
+        }
         grib_context_free(context_, values);
         return err;
     }
+
+    const unsigned char* buf = (unsigned char*)handle->buffer->data + byte_offset();
+    std::vector<long> X;
     for (i = 0; i < len; i++) {
-        val_array[i] = values[index_array[i]];
+        const long idx = index_array[i];
+        long value     = 0;
+
+        if (idx < gi.orderOfSPD) {
+            value = gi.SPD[idx];
+        }
+        else {
+            const g1second_order_group& g = *(std::upper_bound(gi.groups.begin(), gi.groups.end(), idx, group_first_less) - 1);
+            const long k                  = idx - g.first;
+            long pos                      = g.pos;
+
+            if (gi.orderOfSPD == 0) {
+                /* Jump straight to the value */
+                if (g.width > 0) {
+                    pos += k * g.width;
+                    grib_decode_long_array(buf, &pos, g.width, 1, &value);
+                }
+                value += g.first_order_value;
+            }
+            else {
+                /* Restore the values of the group up to the one wanted */
+                long spd[3] = { g.spd[0], g.spd[1], g.spd[2] };
+                X.assign(k + 1, 0);
+                if (g.width > 0)
+                    grib_decode_long_array(buf, &pos, g.width, k + 1, X.data());
+                for (long j = 0; j <= k; j++)
+                    value = spd_step(spd, gi.orderOfSPD, gi.bias, X[j] + g.first_order_value);
+            }
+        }
+        val_array[i] = (double)(((value * gi.s) + gi.reference_value) * gi.d);
     }
-    grib_context_free(context_, values);
+
     return GRIB_SUCCESS;
 }
 
+int grib_accessor_data_g1second_order_general_extended_packing_t::unpack_double_element(size_t idx, double* val)
+{
+    return unpack_elements(&idx, 1, val);
+}
+
+int grib_accessor_data_g1second_order_general_extended_packing_t::unpack_double_element_set(const size_t* index_array, size_t len, double* val_array)
+{
+    return unpack_elements(index_array, len, val_array);
+}
+
 int grib_accessor_data_g1second_order_general_extended_packing_t::unpack(double* dvalues, float* fvalues, size_t* len)
 {
     int ret = 0;
@@ -605,7 +784,8 @@ int grib_accessor_data_g1second_order_general_extended_packing_t::pack_double(co
         return ret;
 
     // ECC-1986: Make sure we set the dirty flag after calling get_bits_per_value
-    double_dirty_ = 1;
+    double_dirty_      = 1;
+    group_index_.valid = false;
 
     if (optimize_scaling_factor) {
         const int compat_gribex = handle->context->gribex_mode_on && edition_ == 1;
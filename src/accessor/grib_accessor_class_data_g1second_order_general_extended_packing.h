@@ -11,6 +11,31 @@
 #pragma once
 
 #include "grib_accessor_class_data_simple_packing.h"
+#include <vector>
+
+struct g1second_order_group
+{
+    long first;  // Index of the first value of the group
+    long pos;    // Bit offset of the values of the group
+    long first_order_value;
+    long width;
+    long spd[3]; // State of the undoing of the spatial differencing before the first value of the group
+};
+
+// Where each group of the packed data starts, so that an element is decoded from its group alone
+struct g1second_order_group_index
+{
+    std::vector<g1second_order_group> groups;
+    bool valid = false;
+    unsigned long change_count = 0;
+    long numberOfValues = 0;
+    long orderOfSPD = 0;
+    long bias = 0;
+    long SPD[3] = { 0, 0, 0 };
+    double reference_value = 0;
+    double s = 0;
+    double d = 0;
+};
 
 class grib_accessor_data_g1second_order_general_extended_packing_t : public grib_accessor_data_simple_packing_t
 {
@@ -29,6 +54,8 @@ public:
 
 private:
     int unpack(double*, float*, size_t*);
+    int build_group_index();
+    int unpack_elements(const size_t* index_array, size_t len, double* val_array);
 
 private:
     const char* half_byte_ = nullptr;
@@ -58,4 +85,7 @@ private:
     int double_dirty_ = 0;
     int float_dirty_ = 0;
     size_t size_ = 0;
+
+    // Built on the first element access, valid until a key of the handle changes
+    g1second_order_group_index group_index_;
 };
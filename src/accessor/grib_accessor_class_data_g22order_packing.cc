@@ -9,6 +9,7 @@
  */
 
 #include "grib_accessor_class_data_g22order_packing.h"
+#include <algorithm>
 
 grib_accessor_data_g22order_packing_t _grib_accessor_data_g22order_packing{};
 grib_accessor* grib_accessor_data_g22order_packing = &_grib_accessor_data_g22order_packing;
@@ -302,65 +303,115 @@ static int min_max_array(double* data, unsigned int n, double* min, double* max)
 //     return bms;
 // }
 
+// Undo the spatial differencing one value at a time. The state is kept between calls so
+// that the values can also be restored from the start of any group (see build_group_index)
+static void spatial_step(long* val, g22order_spatial_state* st, long order, long bias, const unsigned long extras[2])
+{
+    if (*val == LONG_MAX)
+        return;
+
+    if (st->seen < order) {
+        *val = extras[st->seen++];
+    }
+    else if (order == 1) {
+        *val += st->last + bias;
+        st->last = *val;
+    }
+    else {
+        *val            = *val + bias + st->last + st->last - st->penultimate;
+        st->penultimate = st->last;
+        st->last        = *val;
+    }
+}
+
+static void spatial_state_init(g22order_spatial_state* st, long order, const unsigned long extras[2])
+{
+    st->seen        = 0;
+    st->penultimate = order == 2 ? extras[0] : 0;
+    st->last        = order == 2 ? extras[1] : extras[0];
+}
+
 static int post_process(grib_context* c, long* vals, long len, long order, long bias, const unsigned long extras[2])
 {
-    unsigned long last, penultimate = 0, j = 0;
+    g22order_spatial_state st;
     ECCODES_ASSERT(order > 0);
     ECCODES_ASSERT(order <= 3);
     if (!vals)
         return GRIB_INTERNAL_ERROR;
 
-    if (order == 1) {
-        last = extras[0];
-        while (j < len) {
-            if (vals[j] == LONG_MAX) {
-                j++;
-            }
-            else {
-                vals[j++] = extras[0];
-                break;
-            }
-        }
-        while (j < len) {
-            if (vals[j] == LONG_MAX) {
-                j++;
-            }
-            else {
-                vals[j] += last + bias;
-                last = vals[j++];
-            }
-        }
+    if (order == 1 || order == 2) {
+        spatial_state_init(&st, order, extras);
+        for (long j = 0; j < len; j++)
+            spatial_step(&vals[j], &st, order, bias, extras);
     }
-    else if (order == 2) {
-        penultimate = extras[0];
-        last        = extras[1];
-        while (j < len) {
-            if (vals[j] == LONG_MAX) {
-                j++;
+    return GRIB_SUCCESS;
+}
+
+// Decode n values of a group, LONG_MAX standing for a missing value
+static void decode_group(const unsigned char* buf_vals, long* vals_p, long group_ref_val, long nbits_per_group_val,
+                         long n, long missingValueManagementUsed, long bits_per_value, long* out)
+{
+    long j = 0;
+    if (missingValueManagementUsed == 0) {
+        // No explicit missing values included within data values
+        for (j = 0; j < n; j++) {
+            out[j] = group_ref_val + grib_decode_unsigned_long(buf_vals, vals_p, nbits_per_group_val);
+        }
+    }
+    else if (missingValueManagementUsed == 1) {
+        // Primary missing values included within data values
+        long maxn = 0;  // (1 << bits_per_value) - 1;
+        for (j = 0; j < n; j++) {
+            if (nbits_per_group_val == 0) {
+                maxn = (1 << bits_per_value) - 1;
+                if (group_ref_val == maxn) {
+                    out[j] = LONG_MAX;  // missing value
+                }
+                else {
+                    long temp = grib_decode_unsigned_long(buf_vals, vals_p, nbits_per_group_val);
+                    out[j]    = group_ref_val + temp;
+                }
             }
             else {
-                vals[j++] = extras[0];
-                break;
+                long temp = grib_decode_unsigned_long(buf_vals, vals_p, nbits_per_group_val);
+                maxn      = (1 << nbits_per_group_val) - 1;
+                if (temp == maxn) {
+                    out[j] = LONG_MAX;  // missing value
+                }
+                else {
+                    out[j] = group_ref_val + temp;
+                }
             }
         }
-        while (j < len) {
-            if (vals[j] == LONG_MAX) {
-                j++;
+    }
+    else if (missingValueManagementUsed == 2) {
+        // Primary and secondary missing values included within data values
+        long maxn  = (1 << bits_per_value) - 1;
+        long maxn2 = 0;  // maxn - 1
+        for (j = 0; j < n; j++) {
+            if (nbits_per_group_val == 0) {
+                maxn2 = maxn - 1;
+                if (group_ref_val == maxn || group_ref_val == maxn2) {
+                    out[j] = LONG_MAX;  // missing value
+                }
+                else {
+                    long temp = grib_decode_unsigned_long(buf_vals, vals_p, nbits_per_group_val);
+                    out[j]    = group_ref_val + temp;
+                }
             }
             else {
-                vals[j++] = extras[1];
-                break;
-            }
-        }
-        for (; j < len; j++) {
-            if (vals[j] != LONG_MAX) {
-                vals[j]     = vals[j] + bias + last + last - penultimate;
-                penultimate = last;
-                last        = vals[j];
+                long temp = grib_decode_unsigned_long(buf_vals, vals_p, nbits_per_group_val);
+                maxn      = (1 << nbits_per_group_val) - 1;
+                maxn2     = maxn - 1;
+                if (temp == maxn || temp == maxn2) {
+                    out[j] = LONG_MAX;  // missing value
+                }
+                else {
+                    out[j] = group_ref_val + temp;
+                }
             }
         }
     }
-    return GRIB_SUCCESS;
 }
 
 static int find_nbits(unsigned int i)
@@ -803,6 +854,8 @@ int grib_accessor_data_g22order_packing_t::pack_double(const double* val, size_t
     int LEN_SEC_MAX = 127;
     int LEN_BITS    = 7;
 
+    group_index_.valid = false;
+
     if (*len == 0)
         return GRIB_NO_VALUES;
 
@@ -1615,69 +1668,8 @@ int grib_accessor_data_g22order_packing_t::unpack(T* val, size_t* len)
             return GRIB_DECODING_ERROR;
         }
 
-        // grib_decode_long_array(buf_vals, &vals_p, nbits_per_group_val, nvals_per_group, &sec_val[vcount]);
-        if (missingValueManagementUsed == 0) {
-            // No explicit missing values included within data values
-            for (j = 0; j < nvals_per_group; j++) {
-                DEBUG_ASSERT_ACCESS(sec_val, (long)(vcount + j), n_vals);
-                sec_val[vcount + j] = group_ref_val + grib_decode_unsigned_long(buf_vals, &vals_p, nbits_per_group_val);
-                // printf("sec_val[%ld]=%ld\n", vcount+j, sec_val[vcount+j]);
-            }
-        }
-        else if (missingValueManagementUsed == 1) {
-            // Primary missing values included within data values
-            long maxn = 0;  // (1 << bits_per_value) - 1;
-            for (j = 0; j < nvals_per_group; j++) {
-                if (nbits_per_group_val == 0) {
-                    maxn = (1 << bits_per_value) - 1;
-                    if (group_ref_val == maxn) {
-                        sec_val[vcount + j] = LONG_MAX;  // missing value
-                    }
-                    else {
-                        long temp           = grib_decode_unsigned_long(buf_vals, &vals_p, nbits_per_group_val);
-                        sec_val[vcount + j] = group_ref_val + temp;
-                    }
-                }
-                else {
-                    long temp = grib_decode_unsigned_long(buf_vals, &vals_p, nbits_per_group_val);
-                    maxn      = (1 << nbits_per_group_val) - 1;
-                    if (temp == maxn) {
-                        sec_val[vcount + j] = LONG_MAX;  // missing value
-                    }
-                    else {
-                        sec_val[vcount + j] = group_ref_val + temp;
-                    }
-                }
-            }
-        }
-        else if (missingValueManagementUsed == 2) {
-            // Primary and secondary missing values included within data values
-            long maxn  = (1 << bits_per_value) - 1;
-            long maxn2 = 0;  // maxn - 1
-            for (j = 0; j < nvals_per_group; j++) {
-                if (nbits_per_group_val == 0) {
-                    maxn2 = maxn - 1;
-                    if (group_ref_val == maxn || group_ref_val == maxn2) {
-                        sec_val[vcount + j] = LONG_MAX;  // missing value
-                    }
-                    else {
-                        long temp           = grib_decode_unsigned_long(buf_vals, &vals_p, nbits_per_group_val);
-                        sec_val[vcount + j] = group_ref_val + temp;
-                    }
-                }
-                else {
-                    long temp = grib_decode_unsigned_long(buf_vals, &vals_p, nbits_per_group_val);
-                    maxn      = (1 << nbits_per_group_val) - 1;
-                    maxn2     = maxn - 1;
-                    if (temp == maxn || temp == maxn2) {
-                        sec_val[vcount + j] = LONG_MAX;  // missing value
-                    }
-                    else {
-                        sec_val[vcount + j] = group_ref_val + temp;
-                    }
-                }
-            }
-        }
+        decode_group(buf_vals, &vals_p, group_ref_val, nbits_per_group_val, nvals_per_group,
+                     missingValueManagementUsed, bits_per_value, &sec_val[vcount]);
 
         vcount += nvals_per_group;
     }
@@ -1733,55 +1725,237 @@ int grib_accessor_data_g22order_packing_t::unpack_float(float* val, size_t* len)
     return unpack<float>(val, len);
 }
 
-int grib_accessor_data_g22order_packing_t::unpack_double_element(size_t idx, double* val)
+int grib_accessor_data_g22order_packing_t::build_group_index()
 {
-    size_t size    = 0;
-    double* values = NULL;
-    int err        = grib_get_size(grib_handle_of_accessor(this), "codedValues", &size);
-    if (err)
-        return err;
-    if (idx > size)
-        return GRIB_INVALID_ARGUMENT;
+    grib_handle* gh          = grib_handle_of_accessor(this);
+    g22order_group_index& gi = group_index_;
+    int err                  = GRIB_SUCCESS;
+    long n_vals              = 0;
+
+    long bits_per_value             = 0;
+    double reference_value          = 0;
+    long binary_scale_factor        = 0;
+    long decimal_scale_factor       = 0;
+    long missingValueManagementUsed = 0;
+    long numberOfGroupsOfDataValues = 0;
+    long referenceForGroupWidths    = 0;
+    long numberOfBitsUsedForTheGroupWidths        = 0;
+    long referenceForGroupLengths                 = 0;
+    long lengthIncrementForTheGroupLengths        = 0;
+    long trueLengthOfLastGroup                    = 0;
+    long numberOfBitsUsedForTheScaledGroupLengths = 0;
+    long orderOfSpatialDifferencing               = 0;
+    long numberOfOctetsExtraDescriptors           = 0;
+    double missingValue                           = 0;
+
+    const bool cacheable = grib_handle_change_count_valid(gh);
+    if (cacheable && gi.valid && gi.change_count == gh->change_count)
+        return GRIB_SUCCESS;
+    gi.valid  = false;
+    gi.usable = false;
+    gi.groups.clear();
 
-    values = reinterpret_cast<double*>(grib_context_malloc_clear(context_, size * sizeof(double)));
-    err    = grib_get_double_array(grib_handle_of_accessor(this), "codedValues", values, &size);
-    if (err) {
-        grib_context_free(context_, values);
+    if ((err = value_count(&n_vals)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, bits_per_value_, &bits_per_value)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_double_internal(gh, reference_value_, &reference_value)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, binary_scale_factor_, &binary_scale_factor)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, decimal_scale_factor_, &decimal_scale_factor)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, missingValueManagementUsed_, &missingValueManagementUsed)) != GRIB_SUCCESS)
         return err;
+    if ((err = grib_get_long_internal(gh, numberOfGroupsOfDataValues_, &numberOfGroupsOfDataValues)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, referenceForGroupWidths_, &referenceForGroupWidths)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, numberOfBitsUsedForTheGroupWidths_, &numberOfBitsUsedForTheGroupWidths)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, referenceForGroupLengths_, &referenceForGroupLengths)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, lengthIncrementForTheGroupLengths_, &lengthIncrementForTheGroupLengths)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, trueLengthOfLastGroup_, &trueLengthOfLastGroup)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, numberOfBitsUsedForTheScaledGroupLengths_, &numberOfBitsUsedForTheScaledGroupLengths)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, orderOfSpatialDifferencing_, &orderOfSpatialDifferencing)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_long_internal(gh, numberOfOctetsExtraDescriptors_, &numberOfOctetsExtraDescriptors)) != GRIB_SUCCESS)
+        return err;
+    if ((err = grib_get_double_internal(gh, "missingValue", &missingValue)) != GRIB_SUCCESS)
+        return err;
+
+    gi.n_vals                     = n_vals;
+    gi.bits_per_value             = bits_per_value;
+    gi.missingValueManagementUsed = missingValueManagementUsed;
+    gi.order                      = orderOfSpatialDifferencing;
+    gi.reference_value            = reference_value;
+    gi.binary_s                   = codes_power<double>(binary_scale_factor, 2);
+    gi.decimal_s                  = codes_power<double>(-decimal_scale_factor, 10);
+    gi.missingValue               = missingValue;
+    gi.change_count               = gh->change_count;
+    gi.valid                      = cacheable;
+
+    // Constant field, or a layout which is left to unpack
+    if (bits_per_value == 0) {
+        gi.usable = true;
+        return GRIB_SUCCESS;
+    }
+    if (orderOfSpatialDifferencing != 0 && orderOfSpatialDifferencing != 1 && orderOfSpatialDifferencing != 2)
+        return GRIB_SUCCESS;
+
+    // Same layout as in unpack
+    unsigned char* buf_ref    = reinterpret_cast<unsigned char*>(gh->buffer->data) + offset_;
+    long ref_p                = numberOfGroupsOfDataValues * bits_per_value;
+    if (orderOfSpatialDifferencing)
+        ref_p += (1 + orderOfSpatialDifferencing) * (numberOfOctetsExtraDescriptors * 8);
+    unsigned char* buf_width  = buf_ref + (ref_p / 8) + ((ref_p % 8) ? 1 : 0);
+    long width_p              = numberOfGroupsOfDataValues * numberOfBitsUsedForTheGroupWidths;
+    unsigned char* buf_length = buf_width + (width_p / 8) + ((width_p % 8) ? 1 : 0);
+    long length_p             = numberOfGroupsOfDataValues * numberOfBitsUsedForTheScaledGroupLengths;
+    unsigned char* buf_vals   = buf_length + (length_p / 8) + ((length_p % 8) ? 1 : 0);
+
+    g22order_spatial_state state = { 0, 0, 0 };
+    if (orderOfSpatialDifferencing) {
+        ref_p = 0;
+        for (long i = 0; i < orderOfSpatialDifferencing; i++)
+            gi.extras[i] = grib_decode_unsigned_long(buf_ref, &ref_p, numberOfOctetsExtraDescriptors * 8);
+        gi.bias = grib_decode_signed_longb(buf_ref, &ref_p, numberOfOctetsExtraDescriptors * 8);
+        spatial_state_init(&state, orderOfSpatialDifferencing, gi.extras);
     }
-    *val = values[idx];
-    grib_context_free(context_, values);
+
+    gi.vals_offset = buf_vals - reinterpret_cast<unsigned char*>(gh->buffer->data);
+    gi.groups.resize(numberOfGroupsOfDataValues);
+
+    std::vector<long> sec_val;
+    size_t vcount = 0;
+    long vals_p   = 0;
+    ref_p         = orderOfSpatialDifferencing ? (orderOfSpatialDifferencing + 1) * (numberOfOctetsExtraDescriptors * 8) : 0;
+    width_p       = 0;
+    length_p      = 0;
+    for (long i = 0; i < numberOfGroupsOfDataValues; i++) {
+        g22order_group& g    = gi.groups[i];
+        long nvals_per_group = 0;
+
+        g.ref           = grib_decode_unsigned_long(buf_ref, &ref_p, bits_per_value);
+        nvals_per_group = grib_decode_unsigned_long(buf_length, &length_p, numberOfBitsUsedForTheScaledGroupLengths);
+        g.nbits         = grib_decode_unsigned_long(buf_width, &width_p, numberOfBitsUsedForTheGroupWidths);
+
+        nvals_per_group *= lengthIncrementForTheGroupLengths;
+        nvals_per_group += referenceForGroupLengths;
+        g.nbits += referenceForGroupWidths;
+        if (i == numberOfGroupsOfDataValues - 1)
+            nvals_per_group = trueLengthOfLastGroup;
+        if (nvals_per_group < 0 || n_vals - vcount < (size_t)nvals_per_group)
+            return GRIB_SUCCESS;
+
+        g.first  = vcount;
+        g.vals_p = vals_p;
+        g.state  = state;
+
+        if (orderOfSpatialDifferencing) {
+            // The state after the group needs its values
+            sec_val.resize(nvals_per_group);
+            decode_group(buf_vals, &vals_p, g.ref, g.nbits, nvals_per_group,
+                         missingValueManagementUsed, bits_per_value, sec_val.data());
+            for (long j = 0; j < nvals_per_group; j++)
+                spatial_step(&sec_val[j], &state, orderOfSpatialDifferencing, gi.bias, gi.extras);
+        }
+        else {
+            vals_p += nvals_per_group * g.nbits;
+        }
+        vcount += nvals_per_group;
+    }
+
+    gi.usable = (vcount == (size_t)n_vals);
     return GRIB_SUCCESS;
 }
 
-int grib_accessor_data_g22order_packing_t::unpack_double_element_set(const size_t* index_array, size_t len, double* val_array)
+static bool group_first_less(size_t idx, const g22order_group& g)
 {
-    size_t size = 0, i = 0;
-    double* values;
-    int err = 0;
+    return idx < g.first;
+}
 
+int grib_accessor_data_g22order_packing_t::unpack_elements(const size_t* index_array, size_t len, double* val_array)
+{
     // GRIB-564: The indexes in index_array relate to codedValues NOT values!
-    err = grib_get_size(grib_handle_of_accessor(this), "codedValues", &size);
+    grib_handle* gh                = grib_handle_of_accessor(this);
+    const g22order_group_index& gi = group_index_;
+    int err                        = build_group_index();
     if (err)
         return err;
 
-    for (i = 0; i < len; i++) {
-        if (index_array[i] > size) return GRIB_INVALID_ARGUMENT;
+    for (size_t i = 0; i < len; i++) {
+        if (index_array[i] >= gi.n_vals) return GRIB_INVALID_ARGUMENT;
     }
 
-    values = reinterpret_cast<double*>(grib_context_malloc_clear(context_, size * sizeof(double)));
-    err    = grib_get_double_array(grib_handle_of_accessor(this), "codedValues", values, &size);
-    if (err) {
+    // Decoding the whole field is cheaper when many values are wanted
+    if (!gi.usable || len > gi.n_vals / 32) {
+        size_t size    = gi.n_vals;
+        double* values = reinterpret_cast<double*>(grib_context_malloc_clear(context_, size * sizeof(double)));
+        if (!values)
+            return GRIB_OUT_OF_MEMORY;
+        err = unpack_double(values, &size);
+        if (!err) {
+            for (size_t i = 0; i < len; i++)
+                val_array[i] = values[index_array[i]];
+        }
         grib_context_free(context_, values);
         return err;
     }
-    for (i = 0; i < len; i++) {
-        val_array[i] = values[index_array[i]];
+
+    if (gi.bits_per_value == 0) {
+        for (size_t i = 0; i < len; i++)
+            val_array[i] = gi.reference_value;
+        return GRIB_SUCCESS;
     }
-    grib_context_free(context_, values);
+
+    const unsigned char* buf_vals = reinterpret_cast<unsigned char*>(gh->buffer->data) + gi.vals_offset;
+    std::vector<long> sec_val;
+    for (size_t i = 0; i < len; i++) {
+        const size_t idx         = index_array[i];
+        const g22order_group& g  = *(std::upper_bound(gi.groups.begin(), gi.groups.end(), idx, group_first_less) - 1);
+        const long k             = idx - g.first;
+        long vals_p              = g.vals_p;
+        long value               = 0;
+
+        if (gi.order == 0) {
+            // Jump straight to the value
+            vals_p += k * g.nbits;
+            decode_group(buf_vals, &vals_p, g.ref, g.nbits, 1, gi.missingValueManagementUsed, gi.bits_per_value, &value);
+        }
+        else {
+            // Restore the values of the group up to the one wanted
+            g22order_spatial_state state = g.state;
+            sec_val.resize(k + 1);
+            decode_group(buf_vals, &vals_p, g.ref, g.nbits, k + 1, gi.missingValueManagementUsed, gi.bits_per_value, sec_val.data());
+            for (long j = 0; j <= k; j++)
+                spatial_step(&sec_val[j], &state, gi.order, gi.bias, gi.extras);
+            value = sec_val[k];
+        }
+
+        if (value == LONG_MAX)
+            val_array[i] = gi.missingValue;
+        else
+            val_array[i] = ((((double)value) * gi.binary_s) + gi.reference_value) * gi.decimal_s;
+    }
+
     return GRIB_SUCCESS;
 }
 
+int grib_accessor_data_g22order_packing_t::unpack_double_element(size_t idx, double* val)
+{
+    return unpack_elements(&idx, 1, val);
+}
+
+int grib_accessor_data_g22order_packing_t::unpack_double_element_set(const size_t* index_array, size_t len, double* val_array)
+{
+    return unpack_elements(index_array, len, val_array);
+}
+
 int grib_accessor_data_g22order_packing_t::value_count(long* count)
 {
     *count = 0;
@@ -12,6 +12,45 @@
 
 #include "grib_accessor_class_values.h"
 #include "grib_scaling.h"
+#include <vector>
+
+// State of the undoing of the spatial differencing: the number of values restored
+// so far (up to the order) and the last two of them
+struct g22order_spatial_state
+{
+    long seen;
+    unsigned long last;
+    unsigned long penultimate;
+};
+
+struct g22order_group
+{
+    size_t first;                 // Index of the first value of the group
+    long vals_p;                  // Bit offset of the values of the group
+    long ref;                     // Group reference
+    long nbits;                   // Group width
+    g22order_spatial_state state; // State before the first value of the group
+};
+
+// Where each group of the packed data starts, so that an element is decoded from its group alone
+struct g22order_group_index
+{
+    std::vector<g22order_group> groups;
+    bool valid = false;
+    bool usable = false; // False if the data is not laid out as expected, the values are then fully decoded
+    unsigned long change_count = 0;
+    size_t n_vals = 0;
+    long vals_offset = 0;
+    long bits_per_value = 0;
+    long missingValueManagementUsed = 0;
+    long order = 0;
+    long bias = 0;
+    unsigned long extras[2] = { 0, 0 };
+    double reference_value = 0;
+    double binary_s = 0;
+    double decimal_s = 0;
+    double missingValue = 0;
+};
 
 class grib_accessor_data_g22order_packing_t : public grib_accessor_values_t
 {
@@ -49,5 +88,10 @@ private:
     const char* orderOfSpatialDifferencing_ = nullptr;
     const char* numberOfOctetsExtraDescriptors_ = nullptr;
 
+    // Built on the first element access, valid until a key of the handle changes
+    g22order_group_index group_index_;
+
     template <typename T> int unpack(T* val, size_t* len);
+    int build_group_index();
+    int unpack_elements(const size_t* index_array, size_t len, double* val_array);
 };
@@ -371,14 +371,7 @@ int grib_accessor_data_png_packing_t::pack_double(const double* val, size_t* len
 
     d = codes_power<double>(decimal_scale_factor, 10);
 
-    max = val[0];
-    min = max;
-    for (i = 1; i < n_vals; i++) {
-        if (val[i] > max)
-            max = val[i];
-        else if (val[i] < min)
-            min = val[i];
-    }
+    grib_get_min_max(val, n_vals, &min, &max);
     min *= d;
     max *= d;
 
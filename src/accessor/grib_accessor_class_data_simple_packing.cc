@@ -499,14 +499,7 @@ int grib_accessor_data_simple_packing_t::pack_double(const double* val, size_t*
 
     dirty_ = 1;
 
-    max = val[0];
-    min = max;
-    for (i = 1; i < n_vals; i++) {
-        if (val[i] > max)
-            max = val[i];
-        else if (val[i] < min)
-            min = val[i];
-    }
+    grib_get_min_max(val, n_vals, &min, &max);
 
     if ((err = grib_check_data_values_minmax(gh, min, max)) != GRIB_SUCCESS) {
         return err;
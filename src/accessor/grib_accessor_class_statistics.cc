@@ -9,6 +9,8 @@
  */
 
 #include "grib_accessor_class_statistics.h"
+#include "grib_accessor_class_data_apply_bitmap.h"
+#include <float.h>
 
 grib_accessor_statistics_t _grib_accessor_statistics{};
 grib_accessor* grib_accessor_statistics = &_grib_accessor_statistics;
@@ -32,124 +34,183 @@ void grib_accessor_statistics_t::init(const long l, grib_arguments* c)
     dirty_  = 1;
 }
 
+// The values are taken in blocks small enough to stay in cache. The moments of a block are computed
+// about its own mean and merged into the running ones (Chan et al., Pebay), so that all the
+// statistics come out of a single pass over the data
+#define STATISTICS_BLOCK_SIZE 1024
+
+namespace
+{
+struct statistics_moments
+{
+    double n    = 0;
+    double mean = 0;
+    double m2   = 0;  // Sums of the 2nd, 3rd and 4th powers of the deviations from the mean
+    double m3   = 0;
+    double m4   = 0;
+};
+}  // namespace
+
+static void statistics_add_block(statistics_moments& s, const double* x, size_t n, double* sum, double* min, double* max)
+{
+    double bsum = 0, bmin = x[0], bmax = x[0], total = *sum;
+    for (size_t i = 0; i < n; i++) {
+        const double v = x[i];
+        if (v < bmin) bmin = v;
+        if (v > bmax) bmax = v;
+        bsum += v;
+        total += v;  // in order, as the average is taken from it
+    }
+    *sum = total;
+    if (bmin < *min) *min = bmin;
+    if (bmax > *max) *max = bmax;
+
+    // Independent partial sums, so that the loop is not bound by the latency of the additions
+    const double nb = n, mb = bsum / nb;
+    double p2[4] = { 0 }, p3[4] = { 0 }, p4[4] = { 0 };
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (int k = 0; k < 4; k++) {
+            const double v = x[i + k] - mb, v2 = v * v;
+            p2[k] += v2;
+            p3[k] += v * v2;
+            p4[k] += v2 * v2;
+        }
+    }
+    for (; i < n; i++) {
+        const double v = x[i] - mb, v2 = v * v;
+        p2[0] += v2;
+        p3[0] += v * v2;
+        p4[0] += v2 * v2;
+    }
+    const double m2 = (p2[0] + p2[1]) + (p2[2] + p2[3]);
+    const double m3 = (p3[0] + p3[1]) + (p3[2] + p3[3]);
+    const double m4 = (p4[0] + p4[1]) + (p4[2] + p4[3]);
+
+    if (s.n == 0) {
+        s.n    = nb;
+        s.mean = mb;
+        s.m2   = m2;
+        s.m3   = m3;
+        s.m4   = m4;
+        return;
+    }
+
+    const double na = s.n, nt = na + nb;
+    const double delta = mb - s.mean, delta_n = delta / nt, delta_n2 = delta_n * delta_n;
+    const double term  = delta * delta_n * na * nb;
+
+    s.m4 += m4 + term * delta_n2 * (na * na - na * nb + nb * nb) + 6 * delta_n2 * (na * na * m2 + nb * nb * s.m2) + 4 * delta_n * (na * m3 - nb * s.m3);
+    s.m3 += m3 + term * delta_n * (na - nb) + 3 * delta_n * (na * m2 - nb * s.m2);
+    s.m2 += m2 + term;
+    s.mean += delta * nb / nt;
+    s.n = nt;
+}
+
 int grib_accessor_statistics_t::unpack_double(double* val, size_t* len)
 {
     int ret        = 0;
     double* values = NULL;
-    size_t i = 0, size = 0, real_size = 0;
-    double max, min, avg, sd, value, skew, kurt, m2 = 0, m3 = 0, m4 = 0;
+    size_t i = 0, size = 0, number_of_points = 0, real_size = 0;
+    double max, min, avg, sd, skew, kurt, m2 = 0, m3 = 0, m4 = 0, sum = 0;
     double missing            = 0;
     long missingValuesPresent = 0;
     size_t number_of_missing  = 0;
-    grib_context* c           = context_;
-    grib_handle* h            = grib_handle_of_accessor(this);
-
-    if (!dirty_)
-        return GRIB_SUCCESS;
+    const char* values_name   = values_;
+    statistics_moments moments;
+    double block[STATISTICS_BLOCK_SIZE];
+    grib_context* c = context_;
+    grib_handle* h  = grib_handle_of_accessor(this);
 
     if (*len != number_of_elements_)
         return GRIB_ARRAY_TOO_SMALL;
 
-    if ((ret = grib_get_size(h, values_, &size)) != GRIB_SUCCESS)
+    if (!dirty_) {
+        for (i = 0; i < number_of_elements_; i++)
+            val[i] = v_[i];
+        return GRIB_SUCCESS;
+    }
+
+    if ((ret = grib_get_size(h, values_, &number_of_points)) != GRIB_SUCCESS)
         return ret;
+    size = number_of_points;
+
+    // When the values come from a bitmap, the missing ones are those not coded: the statistics
+    // are taken over the coded values and the bitmap need not be expanded
+    grib_accessor* va = grib_find_accessor(h, values_);
+    if (va && strcmp(va->class_name_, "data_apply_bitmap") == 0) {
+        const char* coded = ((grib_accessor_data_apply_bitmap_t*)va)->coded_values();
+        size_t coded_size = 0;
+        if (coded && grib_get_size(h, coded, &coded_size) == GRIB_SUCCESS && coded_size <= number_of_points) {
+            values_name = coded;
+            size        = coded_size;
+        }
+    }
 
     grib_context_log(context_, GRIB_LOG_DEBUG,
-                     "grib_accessor_statistics_t: computing statistics for %d values", size);
+                     "grib_accessor_statistics_t: computing statistics for %d values", number_of_points);
 
     if ((ret = grib_get_double(h, missing_value_, &missing)) != GRIB_SUCCESS)
         return ret;
     if ((ret = grib_get_long_internal(h, "missingValuesPresent", &missingValuesPresent)) != GRIB_SUCCESS)
         return ret;
 
-    values = (double*)grib_context_malloc_clear(c, size * sizeof(double));
+    values = (double*)grib_context_malloc_clear(c, (size ? size : 1) * sizeof(double));
     if (!values)
         return GRIB_OUT_OF_MEMORY;
 
-    if ((ret = grib_get_double_array_internal(h, values_, values, &size)) != GRIB_SUCCESS) {
+    if (size && (ret = grib_get_double_array_internal(h, values_name, values, &size)) != GRIB_SUCCESS) {
         grib_context_free(c, values);
         return ret;
     }
 
-    number_of_missing = 0;
-    if (missingValuesPresent) {
-        i = 0;
-        while (i < size && values[i] == missing) {
-            i++;
-            number_of_missing++;
-        }
-        if (number_of_missing == size) {
-            /* ECC-649: All values are missing */
-            min = max = avg = missing;
-        }
-        else {
-            max = values[i];
-            min = values[i];
-            avg = values[i];
-            for (i = number_of_missing + 1; i < size; i++) {
-                value = values[i];
-                if (value > max && value != missing)
-                    max = value;
-                if (value < min && value != missing)
-                    min = value;
-                if (value != missing)
-                    avg += value;
-                else
-                    number_of_missing++;
+    number_of_missing = number_of_points - size;
+    max               = -DBL_MAX;
+    min               = DBL_MAX;
+    for (i = 0; i < size; i += STATISTICS_BLOCK_SIZE) {
+        const size_t n  = (size - i < STATISTICS_BLOCK_SIZE) ? size - i : STATISTICS_BLOCK_SIZE;
+        const double* x = values + i;
+        size_t count    = n;
+        if (missingValuesPresent) {
+            count = 0;
+            for (size_t j = 0; j < n; j++) {
+                block[count] = x[j];
+                count += (x[j] != missing);
             }
+            number_of_missing += n - count;
+            x = block;
         }
+        if (count)
+            statistics_add_block(moments, x, count, &sum, &min, &max);
     }
-    else {
-        max = values[0];
-        min = values[0];
-        avg = values[0];
-        for (i = 1; i < size; i++) {
-            value = values[i];
-            if (value > max)
-                max = value;
-            if (value < min)
-                min = value;
-            avg += value;
-        }
-    }
 
-    /* Don't divide by zero if all values are missing! */
-    if (size != number_of_missing) {
-        avg /= (size - number_of_missing);
+    grib_context_free(c, values);
+
+    real_size = number_of_points - number_of_missing;
+    if (real_size == 0) {
+        /* ECC-649: All values are missing */
+        min = max = avg = missing;
+    }
+    else {
+        /* Don't divide by zero if all values are missing! */
+        avg = sum / real_size;
     }
 
     sd   = 0;
     skew = 0;
     kurt = 0;
-    for (i = 0; i < size; i++) {
-        int valueNotMissing = 1;
-        if (missingValuesPresent) {
-            valueNotMissing = (values[i] != missing);
-        }
-        if (valueNotMissing) {
-            double v   = values[i] - avg;
-            double tmp = v * v;
-            m2 += tmp;
-            m3 += v * tmp;
-            m4 += tmp * tmp;
-        }
-    }
-
-    real_size = size - number_of_missing;
     if (real_size != 0) {
-        m2 /= real_size;
-        m3 /= real_size;
-        m4 /= real_size;
+        m2 = moments.m2 / real_size;
+        m3 = moments.m3 / real_size;
+        m4 = moments.m4 / real_size;
         sd = sqrt(m2);
     }
     if (m2 != 0) {
         skew = m3 / (sd * sd * sd);
         kurt = m4 / (m2 * m2) - 3.0;
     }
-    // printf("\ngrib_accessor_class_statistics_t::unpack_double   Computed. So setting dirty to 0....... \n");
     dirty_ = 0;
 
-    grib_context_free(c, values);
-
     v_[0] = max;
     v_[1] = min;
     v_[2] = avg;
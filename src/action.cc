@@ -45,17 +45,17 @@ static void init_mutex()
 
 static void init(grib_action_class* c)
 {
-    if (!c)
+    if (!c || c->inited.load(std::memory_order_acquire))
         return;
 
     GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
     GRIB_MUTEX_LOCK(&mutex1);
-    if (!c->inited) {
+    if (!c->inited.load(std::memory_order_relaxed)) {
         if (c->super) {
             init(*(c->super));
         }
         c->init_class(c);
-        c->inited = 1;
+        c->inited.store(1, std::memory_order_release);
     }
     GRIB_MUTEX_UNLOCK(&mutex1);
 }
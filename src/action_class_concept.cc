@@ -167,10 +167,12 @@ grib_action* grib_action_create_concept(grib_context* context,
 
     a->concept_value = concept_value;
     if (concept_value) {
-        grib_concept_value* conc_val = concept_value;
-        grib_trie* index             = grib_trie_new(context);
+        grib_concept_value* conc_val          = concept_value;
+        grib_trie* index                      = grib_trie_new(context);
+        grib_concept_match_index* match_index = grib_concept_match_index_new(context, concept_value);
         while (conc_val) {
-            conc_val->index = index;
+            conc_val->index       = index;
+            conc_val->match_index = match_index;
             grib_trie_insert_no_replace(index, conc_val->name, conc_val);
             conc_val = conc_val->next;
         }
@@ -201,6 +203,7 @@ static void destroy(grib_context* context, grib_action* act)
     grib_concept_value* v = self->concept_value;
     if (v) {
         grib_trie_delete_container(v->index);
+        grib_concept_match_index_delete(context, v->match_index);
     }
     while (v) {
         grib_concept_value* n = v->next;
@@ -292,9 +295,11 @@ static grib_concept_value* get_concept_impl(grib_handle* h, grib_action_concept*
 
     h->context->concepts[id] = c;
     if (c) {
-        grib_trie* index = grib_trie_new(context);
+        grib_trie* index                      = grib_trie_new(context);
+        grib_concept_match_index* match_index = grib_concept_match_index_new(context, c);
         while (c) {
-            c->index = index;
+            c->index       = index;
+            c->match_index = match_index;
             grib_trie_insert_no_replace(index, c->name, c);
             c = c->next;
         }
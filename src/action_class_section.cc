@@ -125,6 +125,10 @@ static int notify_change(grib_action* act, grib_accessor* notified,
             }
     }
 
+    /* Rebuilt later when several values are being set. See grib_dependency_defer_rebuild */
+    if (grib_dependency_defer_rebuild(notified, changed))
+        return GRIB_SUCCESS;
+
     loader.list_is_resized = (la == old_section->branch);
 
     if (!strcmp(changed->name_, "GRIBEditionNumber"))
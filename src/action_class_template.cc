@@ -13,6 +13,16 @@
  ***************************************************************************/
 
 #include "grib_api_internal.h"
+
+/* The action trees a template has expanded to, by file name. See find_template */
+#define TEMPLATE_CACHE_SIZE 8
+
+typedef struct template_cache_entry
+{
+    char* fname;
+    grib_action* la;
+} template_cache_entry;
+
 /*
    This is used by make_class.pl
 
@@ -25,6 +35,7 @@
    IMPLEMENTS = reparse
    MEMBERS    = int nofail
    MEMBERS    = char*           arg
+   MEMBERS    = std::atomic<template_cache_entry*> cache[TEMPLATE_CACHE_SIZE]
    END_CLASS_DEF
 
  */
@@ -52,6 +63,7 @@ typedef struct grib_action_template {
     /* Members defined in template */
     int nofail;
     char*           arg;
+    std::atomic<template_cache_entry*> cache[TEMPLATE_CACHE_SIZE];
 } grib_action_template;
 
 extern grib_action_class* grib_action_class_section;
@@ -82,6 +94,34 @@ static void init_class(grib_action_class* c)
 }
 /* END_CLASS_IMP */
 
+#if GRIB_PTHREADS
+static pthread_once_t once    = PTHREAD_ONCE_INIT;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void init_mutex()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif GRIB_OMP_THREADS
+static int once = 0;
+static omp_nest_lock_t mutex;
+
+static void init_mutex()
+{
+    GRIB_OMP_CRITICAL(lock_action_class_template_c)
+    {
+        if (once == 0) {
+            omp_init_nest_lock(&mutex);
+            once = 1;
+        }
+    }
+}
+#endif
+
 grib_action* grib_action_create_template(grib_context* context, int nofail, const char* name, const char* arg1)
 {
     grib_action_template* a;
@@ -111,6 +151,40 @@ static void dump(grib_action* act, FILE* f, int lvl)
     grib_context_print(act->context, f, "Template %s  %s\n", act->name, a->arg);
 }
 
+/* The file name of a template depends on keys (e.g. productDefinitionTemplateNumber) which
+ * take few values within a file. Once a file name has been resolved on the definitions path and
+ * parsed, its action tree is remembered here so that the following messages go straight to it.
+ * Entries are only ever added, under the mutex, and live as long as the action: no lock to read */
+static grib_action* find_template(grib_action_template* a, const char* fname)
+{
+    for (int i = 0; i < TEMPLATE_CACHE_SIZE; i++) {
+        const template_cache_entry* e = a->cache[i].load(std::memory_order_acquire);
+        if (!e)
+            break;
+        if (strcmp(e->fname, fname) == 0)
+            return e->la;
+    }
+    return NULL;
+}
+
+static void add_template(grib_context* c, grib_action_template* a, const char* fname, grib_action* la)
+{
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex);
+    if (!find_template(a, fname)) {
+        for (int i = 0; i < TEMPLATE_CACHE_SIZE; i++) {
+            if (!a->cache[i].load(std::memory_order_relaxed)) {
+                template_cache_entry* e = (template_cache_entry*)grib_context_malloc_persistent(c, sizeof(template_cache_entry));
+                e->fname                = grib_context_strdup_persistent(c, fname);
+                e->la                   = la;
+                a->cache[i].store(e, std::memory_order_release);
+                break;
+            }
+        }
+    }
+    GRIB_MUTEX_UNLOCK(&mutex);
+}
+
 static grib_action* get_empty_template(grib_context* c, int* err)
 {
     char fname[] = "empty_template.def";
@@ -145,7 +219,10 @@ static int create_accessor(grib_section* p, grib_action* act, grib_loader* h)
     if (a->arg) {
         ret = grib_recompose_name(p->h, as, a->arg, fname, 1);
 
-        if ((fpath = grib_context_full_defs_path(p->h->context, fname)) == NULL) {
+        if ((la = find_template(a, fname)) != NULL) {
+            /* Already resolved */
+        }
+        else if ((fpath = grib_context_full_defs_path(p->h->context, fname)) == NULL) {
             if (!a->nofail) {
                 grib_context_log(p->h->context, GRIB_LOG_ERROR,
                                  "Unable to find template %s from %s ", act->name, fname);
@@ -155,8 +232,11 @@ static int create_accessor(grib_section* p, grib_action* act, grib_loader* h)
             if (ret)
                 return ret;
         }
-        else
+        else {
             la = grib_parse_file(p->h->context, fpath);
+            if (la)
+                add_template(p->h->context, a, fname, la);
+        }
     }
     as->flags_ |= GRIB_ACCESSOR_FLAG_HIDDEN;
     gs         = as->sub_section_;
@@ -190,8 +270,12 @@ static grib_action* reparse(grib_action* a, grib_accessor* acc, int* doit)
 
     if (self->arg) {
         char fname[1024];
+        grib_action* la = NULL;
         grib_recompose_name(grib_handle_of_accessor(acc), NULL, self->arg, fname, 1);
 
+        if ((la = find_template(self, fname)) != NULL)
+            return la;
+
         if ((fpath = grib_context_full_defs_path(acc->context_, fname)) == NULL) {
             if (!self->nofail) {
                 grib_context_log(acc->context_, GRIB_LOG_ERROR,
@@ -212,6 +296,13 @@ static void destroy(grib_context* context, grib_action* act)
 {
     grib_action_template* a = (grib_action_template*)act;
 
+    for (int i = 0; i < TEMPLATE_CACHE_SIZE; i++) {
+        template_cache_entry* e = a->cache[i].load(std::memory_order_relaxed);
+        if (e) {
+            grib_context_free_persistent(context, e->fname);
+            grib_context_free_persistent(context, e);
+        }
+    }
     grib_context_free_persistent(context, a->arg);
     grib_context_free_persistent(context, act->name);
     grib_context_free_persistent(context, act->op);
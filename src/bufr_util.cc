@@ -9,6 +9,7 @@
  */
 
 #include "grib_api_internal.h"
+#include "accessor/grib_accessor_class_bufr_data_array.h"
 
 // Return the rank of the key using list of keys (For BUFR keys)
 // The argument 'keys' is an input as well as output from each call
@@ -1128,6 +1129,26 @@ int codes_bufr_key_is_coordinate(const grib_handle* h, const char* key, int* err
     return ((acc->flags_ & GRIB_ACCESSOR_FLAG_BUFR_COORD) != 0);
 }
 
+// Decode the values of the given element descriptors straight into caller arrays (one per descriptor)
+// without creating the data keys. See eccodes.h
+int codes_bufr_decode_columns(grib_handle* h, const long* codes, size_t num_codes, double** columns, size_t* lengths)
+{
+    grib_accessor_bufr_data_array_t* data_accessor = NULL;
+
+    if (!h || !codes || !lengths)
+        return GRIB_INVALID_ARGUMENT;
+    if (h->product_kind != PRODUCT_BUFR) {
+        grib_context_log(h->context, GRIB_LOG_ERROR, "%s: Not a BUFR message", __func__);
+        return GRIB_INVALID_ARGUMENT;
+    }
+
+    data_accessor = dynamic_cast<grib_accessor_bufr_data_array_t*>(grib_find_accessor(h, "numericValues"));
+    if (!data_accessor)
+        return GRIB_NOT_FOUND;
+
+    return data_accessor->decode_columns(codes, num_codes, columns, lengths);
+}
+
 int codes_bufr_key_exclude_from_dump(const char* key)
 {
     if (strstr(key, "percentConfidence->percentConfidence->percentConfidence->percentConfidence->percentConfidence")) {
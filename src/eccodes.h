@@ -816,6 +816,31 @@ int codes_get_float_elements(const codes_handle* h, const char* key, const int*
  */
 int codes_get_string(const codes_handle* h, const char* key, char* value, size_t* length);
 
+/**
+ *  Resolve a key to an id which can be passed to the codes_get_*_by_id and codes_set_*_by_id functions.
+ *  The key can have a namespace (e.g. "mars.param"). Calling again with the same key returns the same id.
+ *  The id stays valid for all the handles of the context until the context is deleted.
+ *
+ * @param c           : the context (NULL for the default context)
+ * @param key         : the key to be searched. Conditions (e.g. "/key=value/...") are not supported
+ * @return            the id (0 or more) if OK, negative error code on error
+ */
+int codes_key_id(codes_context* c, const char* key);
+
+/**
+ *  Same as codes_get_long, codes_get_double and codes_get_string with a key resolved by codes_key_id.
+ *  The key name is not processed again on each call.
+ *  @see  codes_key_id
+ *
+ * @param h           : the handle to get the data from
+ * @param id          : the id returned by codes_key_id
+ * @param value       : the address where the data will be retrieved
+ * @return            0 if OK, integer value on error (GRIB_NOT_FOUND if the key is not in the handle or the id is invalid)
+ */
+int codes_get_long_by_id(const codes_handle* h, int id, long* value);
+int codes_get_double_by_id(const codes_handle* h, int id, double* value);
+int codes_get_string_by_id(const codes_handle* h, int id, char* value, size_t* length);
+
 /**
  *  Get string array values from a key. If several keys of the same name are present, the last one is returned
  * @see  codes_set_string_array
@@ -917,6 +942,19 @@ int codes_set_double(codes_handle* h, const char* key, double val);
  */
 int codes_set_string(codes_handle* h, const char* key, const char* value, size_t* length);
 
+/**
+ *  Same as codes_set_long, codes_set_double and codes_set_string with a key resolved by codes_key_id.
+ *  @see  codes_key_id
+ *
+ * @param h           : the handle to set the data to
+ * @param id          : the id returned by codes_key_id
+ * @param val         : the value to be set
+ * @return            0 if OK, integer value on error (GRIB_NOT_FOUND if the key is not in the handle or the id is invalid)
+ */
+int codes_set_long_by_id(codes_handle* h, int id, long val);
+int codes_set_double_by_id(codes_handle* h, int id, double val);
+int codes_set_string_by_id(codes_handle* h, int id, const char* value, size_t* length);
+
 /**
  *  Set a bytes array from a key. If several keys of the same name are present, the last one is set
  *  @see  codes_get_bytes
@@ -1158,6 +1196,61 @@ void codes_bufr_multi_element_constant_arrays_on(codes_context* c);
 void codes_bufr_multi_element_constant_arrays_off(codes_context* c);
 /*int  codes_get_bufr_multi_element_constant_arrays(codes_context* c);*/
 
+/**
+ *  Set the memory-mapped I/O mode on.
+ *  GRIB messages read from regular files are used in place in a mapping of the file
+ *  instead of being copied into a new buffer. A message is only copied when its handle is modified.
+ *  Can also be set with the environment variable ECCODES_IO_MMAP=1
+ *
+ * @param c           : the context
+ */
+void codes_io_mmap_on(codes_context* c);
+
+/**
+ *  Set the memory-mapped I/O mode off.
+ *  Each message read from a file is copied into its own buffer.
+ *
+ * @param c           : the context
+ */
+void codes_io_mmap_off(codes_context* c);
+
+/**
+ *  Set the decoded values cache on.
+ *  The arrays decoded from the data keys (e.g. values, codedValues, distinctLatitudes) are kept
+ *  with the handle and reused until a key of the handle changes.
+ *  Can also be set with the environment variable ECCODES_VALUES_CACHE=1
+ *
+ * @param c           : the context
+ */
+void codes_values_cache_on(codes_context* c);
+
+/**
+ *  Set the decoded values cache off.
+ *  The data keys are decoded on every access.
+ *
+ * @param c           : the context
+ */
+void codes_values_cache_off(codes_context* c);
+
+/**
+ *  Set the deferred section rebuilds on.
+ *  When several keys are set at once (e.g. codes_set_values), the sections whose structure
+ *  depends on them (e.g. on productDefinitionTemplateNumber or packingType) are rebuilt once,
+ *  after the keys are applied, instead of on every change.
+ *  Can also be set with the environment variable ECCODES_DEFERRED_REBUILDS=1
+ *
+ * @param c           : the context
+ */
+void codes_deferred_rebuilds_on(codes_context* c);
+
+/**
+ *  Set the deferred section rebuilds off.
+ *  A section is rebuilt as soon as a key it depends on changes.
+ *
+ * @param c           : the context
+ */
+void codes_deferred_rebuilds_off(codes_context* c);
+
 /**
  * Sets the search path for definition files.
  *
@@ -1350,6 +1443,15 @@ int codes_bufr_key_is_header(const codes_handle* h, const char* key, int* err);
    The error code is the final argument */
 int codes_bufr_key_is_coordinate(const codes_handle* h, const char* key, int* err);
 
+/* Decode the values of some element descriptors of a BUFR message into one array per descriptor,
+   without creating the keys of the data section (much faster for messages with many subsets).
+   codes      = the element descriptors, e.g. {5001, 6001, 12101} for latitude, longitude and temperature
+   columns    = num_codes arrays receiving the values, subset by subset and in order of occurrence.
+                Missing values are CODES_MISSING_DOUBLE. If NULL, only the lengths are returned
+   lengths    = on input the sizes of the arrays, on output the number of values of each descriptor
+   Returns CODES_ARRAY_TOO_SMALL if an array is too small and CODES_WRONG_TYPE for a string descriptor */
+int codes_bufr_decode_columns(codes_handle* h, const long* codes, size_t num_codes, double** columns, size_t* lengths);
+
 /* Set the given key to have the value 'missing' */
 int codes_set_missing(codes_handle* h, const char* key);
 
@@ -1446,6 +1548,19 @@ int codes_extract_offsets_malloc(codes_context* c, const char* filename, Product
 int codes_extract_offsets_sizes_malloc(codes_context* c, const char* filename, ProductKind product,
                                        off_t** offsets, size_t** sizes, int* num_messages, int strict_mode);
 
+/* EXPERIMENTAL FEATURE
+ * Call 'proc' for each message of the input file. The client has to supply the ProductKind (GRIB, BUFR etc)
+ * Messages are decoded concurrently by 'nthreads' threads, each message with its own handle
+ * which is deleted when 'proc' returns. nthreads <= 0 means one thread per processor.
+ * ordered  = If 1 means 'proc' is called for the messages in file order, one at a time.
+ *            Otherwise it is called concurrently from several threads in any order.
+ * Without thread support (ENABLE_ECCODES_THREADS) messages are processed in order by the calling thread.
+ * returns 0 if OK, the first non-zero value returned by 'proc' or an error code.
+ */
+typedef int (*codes_foreach_proc)(codes_handle* h, int index, void* data);
+int codes_file_parallel_foreach(codes_context* c, const char* filename, ProductKind product,
+                                int nthreads, int ordered, codes_foreach_proc proc, void* data);
+
 /* --------------------------------------- */
 #ifdef __cplusplus
 }
@@ -104,6 +104,16 @@ grib_concept_value* grib_concept_value_new(grib_context* c, const char* name, gr
 void grib_concept_value_delete(grib_context* c, grib_concept_value* v);
 grib_concept_condition* grib_concept_condition_new(grib_context* c, const char* name, grib_expression* expression, grib_iarray* iarray);
 void grib_concept_condition_delete(grib_context* c, grib_concept_condition* v);
+grib_concept_match_index* grib_concept_match_index_new(grib_context* c, grib_concept_value* concepts);
+void grib_concept_match_index_delete(grib_context* c, grib_concept_match_index* index);
+size_t grib_concept_match_index_keys(const grib_concept_match_index* index, const char** keys);
+grib_concept_value* const* grib_concept_match_index_candidates(const grib_concept_match_index* index, const long* values, size_t* count);
+
+/* grib_definitions_cache.cc */
+grib_definitions_cache* grib_definitions_cache_open(grib_context* c, const char* path);
+void grib_definitions_cache_close(grib_context* c, grib_definitions_cache* cache);
+grib_concept_value* grib_definitions_cache_get_concept(grib_context* c, const char* filename);
+int grib_definitions_cache_compile(grib_context* c, const char* path, size_t* count);
 
 /* grib_hash_array.cc */
 grib_hash_array_value* grib_integer_hash_array_value_new(const char* name, grib_iarray* array);
@@ -361,6 +371,15 @@ void grib_permanent_free(const grib_context* c, void* p);
 void* grib_buffer_malloc(const grib_context* c, size_t s);
 void grib_buffer_free(const grib_context* c, void* p);
 void* grib_buffer_realloc(const grib_context* c, void* p, size_t s);
+grib_arena* grib_arena_new(grib_context* c);
+void grib_arena_delete(grib_arena* a);
+void* grib_arena_malloc(grib_arena* a, size_t size);
+void* grib_arena_malloc_clear(grib_arena* a, size_t size);
+char* grib_arena_strdup(grib_arena* a, const char* s);
+void grib_arena_free(void* p);
+grib_arena* grib_arena_current(void);
+grib_arena* grib_arena_set_current(grib_arena* a);
+size_t grib_arena_num_chunks(const grib_arena* a);
 
 /* grib_buffer.cc */
 grib_buffer* grib_create_growable_buffer(const grib_context* c);
@@ -421,6 +440,12 @@ void grib_context_reset(grib_context* c);
 void grib_context_delete(grib_context* c);
 void codes_bufr_multi_element_constant_arrays_on(grib_context* c);
 void codes_bufr_multi_element_constant_arrays_off(grib_context* c);
+void codes_io_mmap_on(grib_context* c);
+void codes_io_mmap_off(grib_context* c);
+void codes_values_cache_on(grib_context* c);
+void codes_values_cache_off(grib_context* c);
+void codes_deferred_rebuilds_on(grib_context* c);
+void codes_deferred_rebuilds_off(grib_context* c);
 void grib_context_set_definitions_path(grib_context* c, const char* path);
 void grib_context_set_samples_path(grib_context* c, const char* path);
 void* grib_context_malloc_persistent(const grib_context* c, size_t size);
@@ -487,6 +512,7 @@ void grib_file_pool_print(const char* title, FILE* out);
 
 /* grib_geography.cc */
 int grib_get_gaussian_latitudes(long trunc, double* lats);
+void grib_gaussian_latitudes_cache_delete(grib_context* c);
 int is_gaussian_global(double lat1, double lat2, double lon1, double lon2, long num_points_equator, const double* latitudes, double angular_precision);
 void rotate(const double inlat, const double inlon, const double angleOfRot, const double southPoleLat, const double southPoleLon, double* outlat, double* outlon);
 void unrotate(const double inlat, const double inlon, const double angleOfRot, const double southPoleLat, const double southPoleLon, double* outlat, double* outlon);
@@ -494,6 +520,7 @@ double geographic_distance_spherical(double radius, double lon1, double lat1, do
 
 /* grib_handle.cc */
 grib_section* grib_section_create(grib_handle* h, grib_accessor* owner);
+grib_arena* grib_handle_arena(grib_handle* h);
 void grib_swap_sections(grib_section* the_old, grib_section* the_new);
 void grib_empty_section(grib_context* c, grib_section* b);
 void grib_section_delete(grib_context* c, grib_section* b);
@@ -553,6 +580,9 @@ int stdio_seek(void* data, off_t len);
 int stdio_seek_from_start(void* data, off_t len);
 size_t stdio_read(void* data, void* buf, size_t len, int* err);
 int wmo_read_any_from_file(FILE* f, void* buffer, size_t* len);
+grib_mapped_file* grib_mapped_file_acquire(grib_context* c, FILE* f);
+const unsigned char* grib_mapped_file_claim(grib_mapped_file* m, off_t offset, size_t length);
+void grib_mapped_file_release(grib_context* c, grib_mapped_file* m);
 int wmo_read_grib_from_file(FILE* f, void* buffer, size_t* len);
 int wmo_read_bufr_from_file(FILE* f, void* buffer, size_t* len);
 int wmo_read_gts_from_file(FILE* f, void* buffer, size_t* len);
@@ -577,6 +607,8 @@ int grib_count_in_filename(grib_context* c, const char* filename, int* n);
 int codes_extract_offsets_malloc(grib_context* c, const char* filename, ProductKind product, off_t** offsets, int* num_messages, int strict_mode);
 int codes_extract_offsets_sizes_malloc(grib_context* c, const char* filename, ProductKind product,
                                        off_t** offsets, size_t** sizes, int* num_messages, int strict_mode);
+int codes_file_parallel_foreach(grib_context* c, const char* filename, ProductKind product,
+                                int nthreads, int ordered, grib_foreach_proc proc, void* data);
 
 
 /* grib_trie.cc */
@@ -648,6 +680,9 @@ grib_accessors_list* grib_find_accessors_list(const grib_handle* h, const char*
 char* grib_split_name_attribute(grib_context* c, const char* name, char* attribute_name);
 grib_accessor* grib_find_accessor(const grib_handle* h, const char* name);
 grib_accessor* grib_find_accessor_fast(grib_handle* h, const char* name);
+int codes_key_id(grib_context* c, const char* key);
+grib_accessor* grib_find_accessor_by_id(const grib_handle* h, int id);
+void grib_key_refs_delete(grib_context* c);
 
 /* grib_scaling.cc */
 double grib_power(long s, long n);
@@ -663,9 +698,14 @@ void grib_dependency_add(grib_accessor* observer, grib_accessor* observed);
 void grib_dependency_remove_observed(grib_accessor* observed);
 int grib_dependency_notify_change_h(grib_handle* h, grib_accessor* observed);
 int grib_dependency_notify_change(grib_accessor* observed);
+int grib_handle_change_count_valid(const grib_handle* h);
 void grib_dependency_remove_observer(grib_accessor* observer);
 void grib_dependency_observe_expression(grib_accessor* observer, grib_expression* e);
 void grib_dependency_observe_arguments(grib_accessor* observer, grib_arguments* a);
+int grib_dependency_defer_rebuild(grib_accessor* notified, grib_accessor* changed);
+int grib_dependency_defer_set(grib_handle* h, const char* name);
+int grib_dependency_deferred_pending(const grib_handle* h);
+int grib_dependency_run_deferred_rebuilds(grib_handle* h, int level, size_t* count);
 
 /* grib_value.cc */
 int grib_set_expression(grib_handle* h, const char* name, grib_expression* e);
@@ -697,6 +737,12 @@ int grib_set_long_array_internal(grib_handle* h, const char* name, const long* v
 int grib_set_long_array(grib_handle* h, const char* name, const long* val, size_t length);
 int grib_get_long_internal(grib_handle* h, const char* name, long* val);
 int grib_get_long(const grib_handle* h, const char* name, long* val);
+int codes_get_long_by_id(const grib_handle* h, int id, long* val);
+int codes_get_double_by_id(const grib_handle* h, int id, double* val);
+int codes_get_string_by_id(const grib_handle* h, int id, char* val, size_t* length);
+int codes_set_long_by_id(grib_handle* h, int id, long val);
+int codes_set_double_by_id(grib_handle* h, int id, double val);
+int codes_set_string_by_id(grib_handle* h, int id, const char* val, size_t* length);
 int grib_get_double_internal(grib_handle* h, const char* name, double* val);
 int grib_get_double(const grib_handle* h, const char* name, double* val);
 int grib_get_double_element_internal(grib_handle* h, const char* name, int i, double* val);
@@ -710,6 +756,7 @@ int grib_get_float_element_set(const grib_handle* h, const char* name, const siz
 
 int grib_get_double_elements(const grib_handle* h, const char* name, const int* index_array, long len, double* val_array);
 int grib_get_float_elements(const grib_handle* h, const char* name, const int* index_array, long len, float* val_array);
+void grib_values_cache_delete(grib_handle* h);
 int grib_get_string_internal(grib_handle* h, const char* name, char* val, size_t* length);
 int grib_get_string(const grib_handle* h, const char* name, char* val, size_t* length);
 int grib_get_bytes(const grib_handle* h, const char* name, unsigned char* val, size_t* length);
@@ -797,6 +844,9 @@ grib_expression* new_sub_string_expression(grib_context* c, const char* value, s
 //void grib_binary_search(const double xx[], const size_t n, double x, size_t* ju, size_t* jl);
 //int grib_nearest_find_multiple(const grib_handle* h, int is_lsm, const double* inlats, const double* inlons, long npoints, double* outlats, double* outlons, double* values, double* distances, int* indexes);
 
+/* grib_nearest_kdtree.cc */
+void grib_nearest_kdtree_cache_delete(grib_context* c);
+
 /* grib_iterator.cc */
 int grib_get_data(const grib_handle* h, double* lats, double* lons, double* values);
 //int grib_iterator_next(grib_iterator* i, double* lat, double* lon, double* value);
@@ -810,6 +860,7 @@ int grib_get_data(const grib_handle* h, double* lats, double* lons, double* valu
 eccodes::geo_iterator::Iterator* grib_iterator_factory(grib_handle* h, grib_arguments* args, unsigned long flags, int* error);
 
 /* grib_iterator_class_gen.cc */
+void grib_iterator_geometry_cache_delete(grib_context* c);
 int transform_iterator_data(grib_context* c, double* data, long iScansNegatively, long jScansPositively, long jPointsAreConsecutive, long alternativeRowScanning, size_t numPoints, long nx, long ny);
 
 /* grib_expression.cc */
@@ -867,6 +918,7 @@ int grib2_choose_PDTN(int current_PDTN, bool is_det, bool is_instant);
 int grib2_select_PDTN(int is_eps, int is_instant, int is_chemical, int is_chemical_srcsink, int is_chemical_distfn, int is_aerosol, int is_aerosol_optical);
 size_t sum_of_pl_array(const long* pl, size_t plsize);
 int grib_is_earth_oblate(const grib_handle* h);
+void grib_get_min_max(const double* val, size_t n_vals, double* min, double* max);
 int grib_check_data_values_minmax(grib_handle* h, const double min_val, const double max_val);
 int grib_producing_large_constant_fields(const grib_handle* h, int edition);
 int grib_util_grib_data_quality_check(grib_handle* h, double min_val, double max_val);
@@ -879,6 +931,7 @@ int codes_bufr_extract_headers_malloc(grib_context* c, const char* filename, cod
 int codes_bufr_header_get_string(codes_bufr_header* bh, const char* key, char* val, size_t* len);
 int codes_bufr_key_is_header(const grib_handle* h, const char* key, int* err);
 int codes_bufr_key_is_coordinate(const grib_handle* h, const char* key, int* err);
+int codes_bufr_decode_columns(grib_handle* h, const long* codes, size_t num_codes, double** columns, size_t* lengths);
 int codes_bufr_key_exclude_from_dump(const char* key);
 
 /* string_util.cc */
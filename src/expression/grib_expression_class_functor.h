@@ -27,6 +27,7 @@ public:
     const char* class_name() const override { return "functor"; };
 
     char* name() { return name_; }  // For testing
+    const grib_arguments* args() const { return args_; }
 
 private:
     char* name_ = nullptr;
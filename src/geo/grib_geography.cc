@@ -15,6 +15,44 @@
 
 #include <cmath>
 #include <algorithm>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#if GRIB_PTHREADS
+static pthread_once_t once   = PTHREAD_ONCE_INIT;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void init_mutex()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif GRIB_OMP_THREADS
+static int once = 0;
+static omp_nest_lock_t mutex;
+
+static void init_mutex()
+{
+    GRIB_OMP_CRITICAL(lock_grib_geography_c)
+    {
+        if (once == 0) {
+            omp_init_nest_lock(&mutex);
+            once = 1;
+        }
+    }
+}
+#endif
+
+/* Number of Gaussian numbers whose latitudes are kept in the context */
+#define GAUSSIAN_LATITUDES_CACHE_SIZE 8
+
+/* Smallest Gaussian number whose roots are shared between threads (see ECCODES_GAUSSIAN_THREADS) */
+#define GAUSSIAN_PARALLEL_MIN_TRUNC 1024
 
 #define MAXITER 10
 
@@ -90,10 +128,9 @@ static void gauss_first_guess(long trunc, double* vals)
     }
 }
 
-/* 'trunc' is the Gaussian number (or order) */
-/* i.e. Number of parallels between a pole and the equator. */
-/* The provided 'lats' array should have allocated 2*trunc elements */
-static int compute_gaussian_latitudes(long trunc, double* lats)
+/* Compute the roots jlat in [begin, end) of the Legendre polynomial of degree 2*trunc.
+ * On input lats holds the first guesses, on output the latitudes in degrees */
+static int compute_gaussian_roots(long trunc, double* lats, long begin, long end)
 {
     long jlat, iter, legi;
     double rad2deg, convval, root, legfonc = 0;
@@ -106,10 +143,9 @@ static int compute_gaussian_latitudes(long trunc, double* lats)
 
     convval = (1.0 - ((2.0 / M_PI) * (2.0 / M_PI)) * 0.25);
 
-    gauss_first_guess(trunc, lats);
     denom = sqrt(((((double)nlat) + 0.5) * (((double)nlat) + 0.5)) + convval);
 
-    for (jlat = 0; jlat < trunc; jlat++) {
+    for (jlat = begin; jlat < end; jlat++) {
         /*   First approximation for root      */
         root = cos(lats[jlat] / denom);
 
@@ -143,11 +179,78 @@ static int compute_gaussian_latitudes(long trunc, double* lats)
         lats[nlat - 1 - jlat] = -lats[jlat];
     }
 
-    //if (nlat != (trunc * 2))
-    //    lats[trunc + 1] = 0.0;
     return GRIB_SUCCESS;
 }
 
+#if GRIB_PTHREADS
+typedef struct gaussian_roots_job {
+    long trunc;
+    double* lats;
+    long begin;
+    long end;
+    int err;
+} gaussian_roots_job;
+
+static void* gaussian_roots_worker(void* arg)
+{
+    gaussian_roots_job* job = (gaussian_roots_job*)arg;
+    job->err = compute_gaussian_roots(job->trunc, job->lats, job->begin, job->end);
+    return NULL;
+}
+
+/* Each root needs O(trunc) operations: share them between nthreads threads */
+static int compute_gaussian_roots_parallel(long trunc, double* lats, int nthreads)
+{
+    int i = 0, err = GRIB_SUCCESS;
+    std::vector<gaussian_roots_job> jobs(nthreads);
+    std::vector<pthread_t> workers(nthreads);
+    std::vector<bool> started(nthreads, false);
+
+    for (i = 0; i < nthreads; i++) {
+        jobs[i].trunc = trunc;
+        jobs[i].lats  = lats;
+        jobs[i].begin = trunc * i / nthreads;
+        jobs[i].end   = trunc * (i + 1) / nthreads;
+        jobs[i].err   = GRIB_SUCCESS;
+    }
+    /* The calling thread takes the first share, and any share whose thread could not be started */
+    for (i = 1; i < nthreads; i++) {
+        started[i] = (pthread_create(&workers[i], NULL, gaussian_roots_worker, &jobs[i]) == 0);
+    }
+    for (i = 0; i < nthreads; i++) {
+        if (!started[i]) gaussian_roots_worker(&jobs[i]);
+    }
+    for (i = 1; i < nthreads; i++) {
+        if (started[i]) pthread_join(workers[i], NULL);
+    }
+    for (i = 0; i < nthreads; i++) {
+        if (jobs[i].err) err = jobs[i].err;
+    }
+    return err;
+}
+#endif
+
+/* 'trunc' is the Gaussian number (or order) */
+/* i.e. Number of parallels between a pole and the equator. */
+/* The provided 'lats' array should have allocated 2*trunc elements */
+static int compute_gaussian_latitudes(long trunc, double* lats)
+{
+    gauss_first_guess(trunc, lats);
+
+#if GRIB_PTHREADS
+    if (trunc >= GAUSSIAN_PARALLEL_MIN_TRUNC) {
+        int nthreads = grib_context_get_default()->gaussian_threads;
+#ifndef ECCODES_ON_WINDOWS
+        if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        if (nthreads > 1)
+            return compute_gaussian_roots_parallel(trunc, lats, nthreads);
+    }
+#endif
+
+    return compute_gaussian_roots(trunc, lats, 0, trunc);
+}
+
 // Performance: return the precomputed latitudes for N=640
 // The provided 'lats' array should have allocated 2*N elements
 static int get_precomputed_latitudes_N640(double* lats)
@@ -184,8 +287,37 @@ static int get_precomputed_latitudes_N1280(double* lats)
     return GRIB_SUCCESS;
 }
 
+typedef std::shared_ptr<const std::vector<double>> gaussian_latitudes_ptr;
+
+struct grib_gaussian_latitudes_cache {
+    gaussian_latitudes_ptr get(long trunc)
+    {
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->first == trunc) {
+                entries_.splice(entries_.begin(), entries_, it);  // most recently used first
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    void put(long trunc, const gaussian_latitudes_ptr& lats)
+    {
+        entries_.emplace_front(trunc, lats);
+        if (entries_.size() > GAUSSIAN_LATITUDES_CACHE_SIZE)
+            entries_.pop_back();
+    }
+
+private:
+    std::list<std::pair<long, gaussian_latitudes_ptr>> entries_;
+};
+
 int grib_get_gaussian_latitudes(long trunc, double* lats)
 {
+    grib_context* c = NULL;
+    gaussian_latitudes_ptr cached;
+    int err = 0;
+
     if (trunc <= 0)
         return GRIB_GEOCALCULUS_PROBLEM;
 
@@ -195,7 +327,40 @@ int grib_get_gaussian_latitudes(long trunc, double* lats)
     if (trunc == 1280) {
         return get_precomputed_latitudes_N1280(lats);
     }
-    return compute_gaussian_latitudes(trunc, lats);
+
+    c = grib_context_get_default();
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex);
+    if (c->gaussian_latitudes_cache)
+        cached = c->gaussian_latitudes_cache->get(trunc);
+    GRIB_MUTEX_UNLOCK(&mutex);
+    if (cached) {
+        std::copy(cached->begin(), cached->end(), lats);
+        return GRIB_SUCCESS;
+    }
+
+    // Compute outside the lock: two threads may compute the same latitudes, one of which is dropped
+    err = compute_gaussian_latitudes(trunc, lats);
+    if (err)
+        return err;
+
+    cached = std::make_shared<const std::vector<double>>(lats, lats + 2 * trunc);
+    GRIB_MUTEX_LOCK(&mutex);
+    if (!c->gaussian_latitudes_cache)
+        c->gaussian_latitudes_cache = new grib_gaussian_latitudes_cache();
+    c->gaussian_latitudes_cache->put(trunc, cached);
+    GRIB_MUTEX_UNLOCK(&mutex);
+
+    return GRIB_SUCCESS;
+}
+
+void grib_gaussian_latitudes_cache_delete(grib_context* c)
+{
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex);
+    delete c->gaussian_latitudes_cache;
+    c->gaussian_latitudes_cache = NULL;
+    GRIB_MUTEX_UNLOCK(&mutex);
 }
 
 /* Boolean return type: 1 if the reduced gaussian field is global, 0 for sub area */
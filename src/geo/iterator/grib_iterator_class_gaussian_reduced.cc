@@ -286,6 +286,11 @@ int GaussianReduced::init(grib_handle* h, grib_arguments* args)
         angular_precision = 1.0 / angleSubdivisions;
     }
 
+    if (geometry_from_cache(h)) {
+        e_ = -1;
+        return GRIB_SUCCESS;
+    }
+
     numlats = order * 2;
     lats    = (double*)grib_context_malloc(h->context, sizeof(double) * numlats);
     if (!lats)
@@ -357,6 +362,8 @@ int GaussianReduced::init(grib_handle* h, grib_arguments* args)
     }
 
 finalise:
+    if (ret == GRIB_SUCCESS)
+        geometry_to_cache(nv_, nv_);
     e_ = -1;
     grib_context_free(h->context, lats);
     grib_context_free(h->context, pl);
@@ -367,9 +374,7 @@ finalise:
 int GaussianReduced::destroy()
 {
     DEBUG_ASSERT(h_);
-    const grib_context* c = h_->context;
-    grib_context_free(c, lats_);
-    grib_context_free(c, lons_);
+    free_geometry();
 
     return Gen::destroy();
 }
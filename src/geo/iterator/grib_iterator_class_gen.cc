@@ -9,9 +9,141 @@
  */
 
 #include "grib_iterator_class_gen.h"
+#include <list>
+#include <utility>
+
+#if GRIB_PTHREADS
+static pthread_once_t once   = PTHREAD_ONCE_INIT;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void init_mutex()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif GRIB_OMP_THREADS
+static int once = 0;
+static omp_nest_lock_t mutex;
+
+static void init_mutex()
+{
+    GRIB_OMP_CRITICAL(lock_grib_iterator_class_gen_c)
+    {
+        if (once == 0) {
+            omp_init_nest_lock(&mutex);
+            once = 1;
+        }
+    }
+}
+#endif
 
 namespace eccodes::geo_iterator {
 
+Geometry::~Geometry()
+{
+    grib_context_free(context, lats);
+    grib_context_free(context, lons);
+}
+
+// Geometries of the grids last iterated, within the memory budget
+// of the context (ECCODES_GEOMETRY_CACHE_SIZE in megabytes)
+class GeometryCache
+{
+public:
+    std::shared_ptr<const Geometry> get(const std::string& key)
+    {
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->first == key) {
+                entries_.splice(entries_.begin(), entries_, it);  // most recently used first
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    void put(const std::string& key, const std::shared_ptr<const Geometry>& geometry, size_t budget)
+    {
+        entries_.emplace_front(key, geometry);
+        size_ += geometry_size(*geometry);
+        while (size_ > budget) {
+            size_ -= geometry_size(*entries_.back().second);
+            entries_.pop_back();
+        }
+    }
+
+private:
+    static size_t geometry_size(const Geometry& g) { return (g.nlats + g.nlons) * sizeof(double); }
+
+    std::list<std::pair<std::string, std::shared_ptr<const Geometry>>> entries_;
+    size_t size_ = 0;
+};
+
+// The grid section checksum identifies the grid. Iterators of different
+// classes or sizes may be created on the same grid
+bool Gen::geometry_from_cache(grib_handle* h)
+{
+    grib_context* c = h->context;
+    char md5[128]   = {0,};
+    size_t len      = sizeof(md5);
+
+    geometry_key_.clear();
+    if (c->geometry_cache_size <= 0 || grib_get_string(h, "md5GridSection", md5, &len) != GRIB_SUCCESS)
+        return false;
+    geometry_key_ = std::string(class_name_) + "/" + md5 + "/" + std::to_string(nv_);
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex);
+    if (c->geometry_cache)
+        geometry_ = c->geometry_cache->get(geometry_key_);
+    GRIB_MUTEX_UNLOCK(&mutex);
+    if (!geometry_)
+        return false;
+
+    lats_ = geometry_->lats;
+    lons_ = geometry_->lons;
+    return true;
+}
+
+// Hand lats_ and lons_ over to the cache. The iterator keeps using them
+void Gen::geometry_to_cache(size_t nlats, size_t nlons)
+{
+    grib_context* c     = h_->context;
+    const size_t budget = (size_t)c->geometry_cache_size * 1024 * 1024;
+
+    if (geometry_key_.empty() || geometry_ || (nlats + nlons) * sizeof(double) > budget)
+        return;
+
+    auto geometry     = std::make_shared<Geometry>();
+    geometry->context = c;
+    geometry->lats    = lats_;
+    geometry->lons    = lons_;
+    geometry->nlats   = nlats;
+    geometry->nlons   = nlons;
+    geometry_         = geometry;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex);
+    if (!c->geometry_cache)
+        c->geometry_cache = new GeometryCache();
+    c->geometry_cache->put(geometry_key_, geometry_, budget);
+    GRIB_MUTEX_UNLOCK(&mutex);
+}
+
+void Gen::free_geometry()
+{
+    if (geometry_) {
+        geometry_.reset();
+    }
+    else {
+        grib_context_free(h_->context, lats_);
+        grib_context_free(h_->context, lons_);
+    }
+    lats_ = lons_ = nullptr;
+}
+
 int Gen::init(grib_handle* h, grib_arguments* args)
 {
     int err = GRIB_SUCCESS;
@@ -120,3 +252,12 @@ int Gen::next(double*, double*, double*) const
 //}
 
 }  // namespace eccodes::geo_iterator
+
+void grib_iterator_geometry_cache_delete(grib_context* c)
+{
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex);
+    delete c->geometry_cache;
+    c->geometry_cache = NULL;
+    GRIB_MUTEX_UNLOCK(&mutex);
+}
@@ -11,9 +11,23 @@
 #pragma once
 
 #include "grib_iterator.h"
+#include <memory>
+#include <string>
 
 namespace eccodes::geo_iterator {
 
+// Latitudes and longitudes computed for a grid, shared by the iterators on that grid
+struct Geometry
+{
+    ~Geometry();
+
+    const grib_context* context = nullptr;
+    double* lats = nullptr;
+    double* lons = nullptr;
+    size_t nlats = 0;
+    size_t nlons = 0;
+};
+
 class Gen : public Iterator
 {
 public:
@@ -29,12 +43,18 @@ public:
     bool has_next() const override;
 
 protected:
+    bool geometry_from_cache(grib_handle*);
+    void geometry_to_cache(size_t nlats, size_t nlons);
+    void free_geometry();
+
     int carg_ = 0;
     double* lats_ = nullptr;
     double* lons_ = nullptr;
 
 private:
     //int get(double*, double*, double*);
+    std::shared_ptr<const Geometry> geometry_;  // set when lats_ and lons_ belong to the geometry cache
+    std::string geometry_key_;
 };
 
 }  // namespace eccodes::geo_iterator
@@ -307,6 +307,11 @@ int Healpix::init(grib_handle* h, grib_arguments* args)
         return GRIB_WRONG_GRID;
     }
 
+    if (geometry_from_cache(h)) {
+        e_ = -1;
+        return GRIB_SUCCESS;
+    }
+
     lats_ = (double*)grib_context_malloc(h->context, nv_ * sizeof(double));
     if (lats_ == nullptr) {
         return GRIB_OUT_OF_MEMORY;
@@ -323,6 +328,8 @@ int Healpix::init(grib_handle* h, grib_arguments* args)
     catch (...) {
         return GRIB_INTERNAL_ERROR;
     }
+    if (err == GRIB_SUCCESS)
+        geometry_to_cache(nv_, nv_);
 
     e_ = -1;
 
@@ -348,9 +355,7 @@ int Healpix::next(double* lat, double* lon, double* val) const
 int Healpix::destroy()
 {
     DEBUG_ASSERT(h_);
-    const grib_context* c = h_->context;
-    grib_context_free(c, lats_);
-    grib_context_free(c, lons_);
+    free_geometry();
 
     return Gen::destroy();
 }
@@ -406,6 +406,11 @@ int LambertAzimuthalEqualArea::init(grib_handle* h, grib_arguments* args)
     centralLongitudeInRadians = centralLongitudeInDegrees * d2r;
     standardParallelInRadians = standardParallelInDegrees * d2r;
 
+    if (geometry_from_cache(h)) {
+        e_ = -1;
+        return GRIB_SUCCESS;
+    }
+
     if (is_oblate) {
         err = init_oblate(h, nv_, nx, ny,
                           Dx, Dy, earthMinorAxisInMetres, earthMajorAxisInMetres,
@@ -421,6 +426,7 @@ int LambertAzimuthalEqualArea::init(grib_handle* h, grib_arguments* args)
                           iScansNegatively, jScansPositively, jPointsAreConsecutive);
     }
     if (err) return err;
+    geometry_to_cache(nv_, nv_);
 
     e_ = -1;
 
@@ -430,9 +436,7 @@ int LambertAzimuthalEqualArea::init(grib_handle* h, grib_arguments* args)
 int LambertAzimuthalEqualArea::destroy()
 {
     DEBUG_ASSERT(h_);
-    const grib_context* c = h_->context;
-    grib_context_free(c, lats_);
-    grib_context_free(c, lons_);
+    free_geometry();
 
     return Gen::destroy();
 }
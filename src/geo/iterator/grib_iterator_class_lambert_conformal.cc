@@ -436,22 +436,25 @@ int LambertConformal::init(grib_handle* h, grib_arguments* args)
     LaDInRadians      = LaDInDegrees * DEG2RAD;
     LoVInRadians      = LoVInDegrees * DEG2RAD;
 
-    if (is_oblate) {
-        err = init_oblate(h, nv_, nx, ny,
-                          LoVInDegrees,
-                          Dx, Dy, earthMinorAxisInMetres, earthMajorAxisInMetres,
-                          latFirstInRadians, lonFirstInRadians,
-                          LoVInRadians, Latin1InRadians, Latin2InRadians,
-                          LaDInRadians);
-    }
-    else {
-        err = init_sphere(h, nv_, nx, ny,
-                          LoVInDegrees,
-                          Dx, Dy, radius,
-                          latFirstInRadians, lonFirstInRadians,
-                          LoVInRadians, Latin1InRadians, Latin2InRadians, LaDInRadians);
+    if (!geometry_from_cache(h)) {
+        if (is_oblate) {
+            err = init_oblate(h, nv_, nx, ny,
+                              LoVInDegrees,
+                              Dx, Dy, earthMinorAxisInMetres, earthMajorAxisInMetres,
+                              latFirstInRadians, lonFirstInRadians,
+                              LoVInRadians, Latin1InRadians, Latin2InRadians,
+                              LaDInRadians);
+        }
+        else {
+            err = init_sphere(h, nv_, nx, ny,
+                              LoVInDegrees,
+                              Dx, Dy, radius,
+                              latFirstInRadians, lonFirstInRadians,
+                              LoVInRadians, Latin1InRadians, Latin2InRadians, LaDInRadians);
+        }
+        if (err) return err;
+        geometry_to_cache(nv_, nv_);
     }
-    if (err) return err;
 
     e_ = -1;
 
@@ -479,9 +482,7 @@ int LambertConformal::next(double* lat, double* lon, double* val) const
 int LambertConformal::destroy()
 {
     DEBUG_ASSERT(h_);
-    const grib_context* c = h_->context;
-    grib_context_free(c, lats_);
-    grib_context_free(c, lons_);
+    free_geometry();
 
     return Gen::destroy();
 }
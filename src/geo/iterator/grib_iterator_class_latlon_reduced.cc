@@ -74,6 +74,11 @@ int LatlonReduced::init(grib_handle* h, grib_arguments* args)
     if ((ret = grib_get_double_internal(h, jdirec, &jdirinc)))
         return ret;
 
+    if (geometry_from_cache(h)) {
+        e_ = -1;
+        return GRIB_SUCCESS;
+    }
+
     plsize = nlats;
     pl     = (long*)grib_context_malloc(h->context, plsize * sizeof(long));
     grib_get_long_array_internal(h, plac, pl, &plsize);
@@ -121,6 +126,7 @@ int LatlonReduced::init(grib_handle* h, grib_arguments* args)
         }
         laf += jdirinc;
     }
+    geometry_to_cache(nv_, nv_);
 
     e_ = -1;
     grib_context_free(h->context, pl);
@@ -131,9 +137,7 @@ int LatlonReduced::init(grib_handle* h, grib_arguments* args)
 int LatlonReduced::destroy()
 {
     DEBUG_ASSERT(h_);
-    const grib_context* c = h_->context;
-    grib_context_free(c, lats_);
-    grib_context_free(c, lons_);
+    free_geometry();
 
     return Gen::destroy();
 }
@@ -241,12 +241,15 @@ int Mercator::init(grib_handle* h, grib_arguments* args)
     LaDInRadians         = LaDInDegrees * DEG2RAD;
     orientationInRadians = orientationInDegrees * DEG2RAD;
 
-    err = init_mercator(h, nv_, ni, nj,
-                        DiInMetres, DjInMetres, earthMinorAxisInMetres, earthMajorAxisInMetres,
-                        latFirstInRadians, lonFirstInRadians,
-                        latLastInRadians, lonLastInRadians,
-                        LaDInRadians, orientationInRadians);
-    if (err) return err;
+    if (!geometry_from_cache(h)) {
+        err = init_mercator(h, nv_, ni, nj,
+                            DiInMetres, DjInMetres, earthMinorAxisInMetres, earthMajorAxisInMetres,
+                            latFirstInRadians, lonFirstInRadians,
+                            latLastInRadians, lonLastInRadians,
+                            LaDInRadians, orientationInRadians);
+        if (err) return err;
+        geometry_to_cache(nv_, nv_);
+    }
 
     e_ = -1;
 
@@ -274,9 +277,7 @@ int Mercator::next(double* lat, double* lon, double* val) const
 int Mercator::destroy()
 {
     DEBUG_ASSERT(h_);
-    const grib_context* c = h_->context;
-    grib_context_free(c, lats_);
-    grib_context_free(c, lons_);
+    free_geometry();
 
     return Gen::destroy();
 }
@@ -180,6 +180,9 @@ int PolarStereographic::init(grib_handle* h, grib_arguments* args)
         inv_proj_data.mcs = cos(con1);
         inv_proj_data.tcs = tan(0.5 * (PI_OVER_2 - con1));
     }
+    if (geometry_from_cache(h))
+        goto transform;
+
     lats_ = (double*)grib_context_malloc(h->context, nv_ * sizeof(double));
     if (!lats_) {
         grib_context_log(h->context, GRIB_LOG_ERROR, "%s: Error allocating %zu bytes", ITER, nv_ * sizeof(double));
@@ -230,6 +233,7 @@ int PolarStereographic::init(grib_handle* h, grib_arguments* args)
         }
         y += Dy;
     }
+    geometry_to_cache(nv_, nv_);
 
     //     /*standardParallel = (southPoleOnPlane == 1) ? -90 : +90;*/
     //     if (jPointsAreConsecutive)
@@ -290,6 +294,7 @@ int PolarStereographic::init(grib_handle* h, grib_arguments* args)
     //         }
     //     }
 
+transform:
     e_ = -1;
 
     /* Apply the scanning mode flags which may require data array to be transformed */
@@ -303,9 +308,7 @@ int PolarStereographic::init(grib_handle* h, grib_arguments* args)
 int PolarStereographic::destroy()
 {
     DEBUG_ASSERT(h_);
-    const grib_context* c = h_->context;
-    grib_context_free(c, lats_);
-    grib_context_free(c, lons_);
+    free_geometry();
 
     return Gen::destroy();
 }
@@ -221,6 +221,11 @@ int SpaceView::init(grib_handle* h, grib_arguments* args)
     rx = angular_size / dx;
     ry = (r_pol / r_eq) * angular_size / dy;
 
+    if (geometry_from_cache(h)) {
+        e_ = -1;
+        return GRIB_SUCCESS;
+    }
+
     lats_ = (double*)grib_context_malloc(h->context, array_size);
     if (!lats_) {
         grib_context_log(h->context, GRIB_LOG_ERROR, "%s: Error allocating %zu bytes", ITER, array_size);
@@ -306,6 +311,7 @@ int SpaceView::init(grib_handle* h, grib_arguments* args)
     }
     grib_context_free(h->context, s_x);
     grib_context_free(h->context, c_x);
+    geometry_to_cache(nv_, nv_);
     e_ = -1;
 
     return ret;
@@ -314,9 +320,7 @@ int SpaceView::init(grib_handle* h, grib_arguments* args)
 int SpaceView::destroy()
 {
     DEBUG_ASSERT(h_);
-    const grib_context* c = h_->context;
-    grib_context_free(c, lats_);
-    grib_context_free(c, lons_);
+    free_geometry();
 
     return Gen::destroy();
 }
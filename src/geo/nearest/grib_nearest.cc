@@ -9,8 +9,11 @@
  */
 
 #include "grib_nearest.h"
+#include "grib_nearest_kdtree.h"
 #include "grib_nearest_factory.h"
 #include "accessor/grib_accessor_class_nearest.h"
+#include <algorithm>
+#include <vector>
 
 struct PointStore
 {
@@ -21,31 +24,6 @@ struct PointStore
     int m_index;
 };
 
-/* Generic implementation of nearest for Lambert, Polar stereo, Mercator etc */
-static int compare_doubles(const void* a, const void* b, int ascending)
-{
-    /* ascending is a boolean: 0 or 1 */
-    const double* arg1 = (const double*)a;
-    const double* arg2 = (const double*)b;
-    if (ascending) {
-        if (*arg1 < *arg2)
-            return -1; /*Smaller values come before larger ones*/
-    }
-    else {
-        if (*arg1 > *arg2)
-            return -1; /*Larger values come before smaller ones*/
-    }
-    if (*arg1 == *arg2)
-        return 0;
-    else
-        return 1;
-}
-
-static int compare_doubles_ascending(const void* a, const void* b)
-{
-    return compare_doubles(a, b, 1);
-}
-
 /* Comparison function to sort points by distance */
 static int compare_points(const void* a, const void* b)
 {
@@ -87,13 +65,15 @@ int Nearest::grib_nearest_find_generic(
     double* values, double* distances, int* indexes, size_t* len)
 {
     int ret = 0;
-    size_t i = 0, nvalues = 0, nneighbours = 0;
+    size_t i = 0, nvalues = 0, nneighbours = 0, npoints = 0;
     double radiusInKm;
-    grib_iterator* iter = NULL;
-    double lat = 0, lon = 0;
+    size_t idx_upper = 0, idx_lower = 0;
+    double lat1 = 0, lat2 = 0;     /* inlat will be between these */
+    const double LAT_DELTA = 10.0; /* in degrees */
+    size_t nearest[4] = {0,};
 
-    /* array of candidates for nearest neighbours */
-    PointStore* neighbours = NULL;
+    /* The 4 nearest neighbours */
+    PointStore neighbours[4];
 
     inlon = normalise_longitude_in_degrees(inlon);
 
@@ -104,8 +84,7 @@ int Nearest::grib_nearest_find_generic(
     if ((ret = grib_nearest_get_radius(h, &radiusInKm)) != GRIB_SUCCESS)
         return ret;
 
-    neighbours = (PointStore*)grib_context_malloc(h->context, nvalues * sizeof(PointStore));
-    for (i = 0; i < nvalues; ++i) {
+    for (i = 0; i < 4; ++i) {
         neighbours[i].m_dist  = 1e10; /* set all distances to large number to begin with */
         neighbours[i].m_lat   = 0;
         neighbours[i].m_lon   = 0;
@@ -113,90 +92,73 @@ int Nearest::grib_nearest_find_generic(
         neighbours[i].m_index = 0;
     }
 
-    /* GRIB_NEAREST_SAME_GRID not yet implemented */
-    {
-        double the_value = 0;
-        double min_dist  = 1e10;
-        size_t the_index = 0;
-        int ilat = 0, ilon = 0;
-        size_t idx_upper = 0, idx_lower = 0;
-        double lat1 = 0, lat2 = 0;     /* inlat will be between these */
-        const double LAT_DELTA = 10.0; /* in degrees */
-
-        *out_lons_count = (int)nvalues; /* Maybe overestimate but safe */
-        *out_lats_count = (int)nvalues;
-
-        if (*out_lats)
-            grib_context_free(h->context, *out_lats);
-        *out_lats = (double*)grib_context_malloc(h->context, nvalues * sizeof(double));
-        if (!*out_lats)
-            return GRIB_OUT_OF_MEMORY;
-
-        if (*out_lons)
-            grib_context_free(h->context, *out_lons);
-        *out_lons = (double*)grib_context_malloc(h->context, nvalues * sizeof(double));
-        if (!*out_lons)
-            return GRIB_OUT_OF_MEMORY;
-
-        iter = grib_iterator_new(h, 0, &ret);
-        if (ret) {
-            free(neighbours);
+    /* The spatial index of the grid is built once per geometry and shared */
+    if (!kdtree_ || (flags & GRIB_NEAREST_SAME_GRID) == 0 || values_count_ != kdtree_count_) {
+        kdtree_ = grib_nearest_kdtree_get(h, nvalues, &ret);
+        if (!kdtree_)
             return ret;
-        }
-        /* First pass: collect all latitudes and longitudes */
-        while (grib_iterator_next(iter, &lat, &lon, &the_value)) {
-            ++the_index;
-            ECCODES_ASSERT(ilat < *out_lats_count);
-            ECCODES_ASSERT(ilon < *out_lons_count);
-            (*out_lats)[ilat++] = lat;
-            (*out_lons)[ilon++] = lon;
-        }
-
-        /* See between which 2 latitudes our point lies */
-        qsort(*out_lats, nvalues, sizeof(double), &compare_doubles_ascending);
-        grib_binary_search(*out_lats, *out_lats_count - 1, inlat, &idx_upper, &idx_lower);
-        lat2 = (*out_lats)[idx_upper];
-        lat1 = (*out_lats)[idx_lower];
-        ECCODES_ASSERT(lat1 <= lat2);
-
-        /* Second pass: Iterate again and collect candidate neighbours */
-        grib_iterator_reset(iter);
-        the_index = 0;
-        i         = 0;
-        while (grib_iterator_next(iter, &lat, &lon, &the_value)) {
-            if (lat > lat2 + LAT_DELTA || lat < lat1 - LAT_DELTA) {
-                /* Ignore latitudes too far from our point */
-            }
-            else {
-                double dist = geographic_distance_spherical(radiusInKm, inlon, inlat, lon, lat);
-                if (dist < min_dist)
-                    min_dist = dist;
-                /*printf("Candidate: lat=%.5f lon=%.5f dist=%f Idx=%ld Val=%f\n",lat,lon,dist,the_index,the_value);*/
-                /* store this candidate point */
-                neighbours[i].m_dist  = dist;
-                neighbours[i].m_index = (int)the_index;
-                neighbours[i].m_lat   = lat;
-                neighbours[i].m_lon   = lon;
-                neighbours[i].m_value = the_value;
-                i++;
+        kdtree_count_ = nvalues;
+    }
+    const KdTree& tree = *kdtree_;
+    npoints            = tree.size();
+    if (npoints == 0)
+        return GRIB_GEOCALCULUS_PROBLEM;
+
+    /* Candidate neighbours are the points less than LAT_DELTA degrees north or south of
+     * the two latitudes between which our point lies */
+    const std::vector<double>& sorted_lats = tree.sorted_lats();
+    grib_binary_search(sorted_lats.data(), npoints - 1, inlat, &idx_upper, &idx_lower);
+    lat2 = sorted_lats[idx_upper];
+    lat1 = sorted_lats[idx_lower];
+    ECCODES_ASSERT(lat1 <= lat2);
+
+    nneighbours = tree.find(inlat, inlon, 4, nearest);
+    for (i = 0; i < nneighbours; ++i) {
+        const double lat = tree.lat(nearest[i]);
+        if (lat > lat2 + LAT_DELTA || lat < lat1 - LAT_DELTA)
+            break;
+    }
+    if (i < nneighbours) {
+        /* The nearest points are not all candidates (very sparse grid or far away point):
+         * choose among the candidates by brute force */
+        std::vector<PointStore> candidates;
+        for (i = 0; i < npoints; ++i) {
+            const double lat = tree.lat(i);
+            if (lat <= lat2 + LAT_DELTA && lat >= lat1 - LAT_DELTA) {
+                PointStore p = { lat, tree.lon(i), geographic_distance_spherical(radiusInKm, inlon, inlat, tree.lon(i), lat), 0, (int)i };
+                candidates.push_back(p);
             }
-            ++the_index;
         }
-        nneighbours = i;
-        /* Sort the candidate neighbours in ascending order of distance */
-        /* The first 4 entries will now be the closest 4 neighbours */
-        qsort(neighbours, nneighbours, sizeof(PointStore), &compare_points);
-
-        grib_iterator_delete(iter);
+        nneighbours = candidates.size() < 4 ? candidates.size() : 4;
+        std::partial_sort(candidates.begin(), candidates.begin() + nneighbours, candidates.end(),
+                          [](const PointStore& a, const PointStore& b) {
+                              return a.m_dist < b.m_dist || (a.m_dist == b.m_dist && a.m_index < b.m_index);
+                          });
+        for (i = 0; i < nneighbours; ++i)
+            nearest[i] = candidates[i].m_index;
     }
-    h_ = h;
 
-    /* Sanity check for sorting */
-#ifdef DEBUG
-    for (i = 0; i < nneighbours - 1; ++i) {
-        ECCODES_ASSERT(neighbours[i].m_dist <= neighbours[i + 1].m_dist);
+    for (i = 0; i < nneighbours; ++i) {
+        neighbours[i].m_index = (int)nearest[i];
+        neighbours[i].m_lat   = tree.lat(nearest[i]);
+        neighbours[i].m_lon   = tree.lon(nearest[i]);
+        neighbours[i].m_dist  = geographic_distance_spherical(radiusInKm, inlon, inlat, neighbours[i].m_lon, neighbours[i].m_lat);
     }
-#endif
+    /* Sort the neighbours in ascending order of distance */
+    qsort(neighbours, nneighbours, sizeof(PointStore), &compare_points);
+
+    if (values && nneighbours > 0) {
+        /* ECC-499: Only decode the data if the values are wanted */
+        int vindexes[4]   = {0,};
+        double vvalues[4] = {0,};
+        for (i = 0; i < nneighbours; ++i)
+            vindexes[i] = neighbours[i].m_index;
+        if ((ret = grib_get_double_elements(h, values_keyname, vindexes, (long)nneighbours, vvalues)) != GRIB_SUCCESS)
+            return ret;
+        for (i = 0; i < nneighbours; ++i)
+            neighbours[i].m_value = vvalues[i];
+    }
+    h_ = h;
 
     /* GRIB_NEAREST_SAME_XXX not yet implemented */
     if (!*out_distances) {
@@ -218,7 +180,6 @@ int Nearest::grib_nearest_find_generic(
         /*printf("(%f,%f)  i=%d  d=%f  v=%f\n",outlats[i],outlons[i],indexes[i],distances[i],values[i]);*/
     }
 
-    free(neighbours);
     return GRIB_SUCCESS;
 }
 
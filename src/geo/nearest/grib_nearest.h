@@ -11,9 +11,12 @@
 #pragma once
 
 #include "grib_api_internal.h"
+#include <memory>
 
 namespace eccodes::geo_nearest {
 
+class KdTree;
+
 class Nearest {
 public:
     virtual ~Nearest() {}
@@ -37,6 +40,10 @@ protected:
     size_t values_count_ = 0;
     unsigned long flags_ = 0;
     const char* class_name_ = nullptr;
+
+    // Spatial index used by grib_nearest_find_generic, kept for GRIB_NEAREST_SAME_GRID
+    std::shared_ptr<const KdTree> kdtree_;
+    size_t kdtree_count_ = 0;
 };
 
 Nearest* gribNearestNew(const grib_handle*, int*);
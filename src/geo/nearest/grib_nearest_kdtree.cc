@@ -0,0 +1,268 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+#include "grib_nearest_kdtree.h"
+#include <algorithm>
+#include <list>
+#include <numeric>
+#include <string>
+#include <utility>
+
+#if GRIB_PTHREADS
+static pthread_once_t once   = PTHREAD_ONCE_INIT;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void init_mutex()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif GRIB_OMP_THREADS
+static int once = 0;
+static omp_nest_lock_t mutex;
+
+static void init_mutex()
+{
+    GRIB_OMP_CRITICAL(lock_grib_nearest_kdtree_c)
+    {
+        if (once == 0) {
+            omp_init_nest_lock(&mutex);
+            once = 1;
+        }
+    }
+}
+#endif
+
+/* Number of geometries whose index is kept in the context */
+#define KDTREE_CACHE_SIZE 4
+
+#define DEG2RAD 0.01745329251994329576  /* pi over 180 */
+
+static void to_xyz(double lat, double lon, double* xyz)
+{
+    const double rlat = lat * DEG2RAD;
+    const double rlon = lon * DEG2RAD;
+    xyz[0]            = cos(rlat) * cos(rlon);
+    xyz[1]            = cos(rlat) * sin(rlon);
+    xyz[2]            = sin(rlat);
+}
+
+namespace eccodes::geo_nearest {
+
+KdTree::KdTree(const double* lats, const double* lons, size_t n) :
+    lats_(lats, lats + n), lons_(lons, lons + n), sorted_lats_(lats, lats + n),
+    xyz_(3 * n), index_(n), axis_(n)
+{
+    std::sort(sorted_lats_.begin(), sorted_lats_.end());
+
+    // Build on the coordinates by point index, then store them in node order
+    std::vector<double> points(3 * n);
+    for (size_t i = 0; i < n; i++)
+        to_xyz(lats[i], lons[i], &points[3 * i]);
+    std::iota(index_.begin(), index_.end(), 0);
+    build(points.data(), 0, n);
+    for (size_t i = 0; i < n; i++) {
+        for (int d = 0; d < 3; d++)
+            xyz_[3 * i + d] = points[3 * index_[i] + d];
+    }
+}
+
+// Put the median along the axis of largest spread in the middle of [lo,hi) and recurse on each side
+void KdTree::build(const double* points, size_t lo, size_t hi)
+{
+    if (hi - lo < 2) {
+        if (hi > lo)
+            axis_[lo] = 0;
+        return;
+    }
+
+    double pmin[3] = { 2, 2, 2 };
+    double pmax[3] = { -2, -2, -2 };
+    for (size_t i = lo; i < hi; i++) {
+        const double* p = &points[3 * index_[i]];
+        for (int d = 0; d < 3; d++) {
+            pmin[d] = std::min(pmin[d], p[d]);
+            pmax[d] = std::max(pmax[d], p[d]);
+        }
+    }
+    int axis = 0;
+    for (int d = 1; d < 3; d++) {
+        if (pmax[d] - pmin[d] > pmax[axis] - pmin[axis])
+            axis = d;
+    }
+
+    const size_t mid = lo + (hi - lo) / 2;
+    std::nth_element(index_.begin() + lo, index_.begin() + mid, index_.begin() + hi,
+                     [points, axis](size_t a, size_t b) { return points[3 * a + axis] < points[3 * b + axis]; });
+    axis_[mid] = (unsigned char)axis;
+
+    build(points, lo, mid);
+    build(points, mid + 1, hi);
+}
+
+// Points at the same distance are ordered by grid point index, as a scan of the grid would
+static bool closer(double d2a, size_t a, double d2b, size_t b)
+{
+    return d2a < d2b || (d2a == d2b && a < b);
+}
+
+// best[0..nbest) is kept sorted on increasing squared distance
+void KdTree::search(size_t lo, size_t hi, const double* q, size_t k, size_t* best, double* best_d2, size_t* nbest) const
+{
+    if (hi <= lo)
+        return;
+
+    const size_t mid = lo + (hi - lo) / 2;
+    const double* p  = &xyz_[3 * mid];
+    const double dx = p[0] - q[0], dy = p[1] - q[1], dz = p[2] - q[2];
+    const double d2 = dx * dx + dy * dy + dz * dz;
+    const size_t n  = index_[mid];
+
+    if (*nbest < k || closer(d2, n, best_d2[*nbest - 1], best[*nbest - 1])) {
+        size_t i = (*nbest < k) ? (*nbest)++ : *nbest - 1;
+        while (i > 0 && closer(d2, n, best_d2[i - 1], best[i - 1])) {
+            best[i]    = best[i - 1];
+            best_d2[i] = best_d2[i - 1];
+            i--;
+        }
+        best[i]    = n;
+        best_d2[i] = d2;
+    }
+
+    // Visit the far side unless all its points are strictly further than the k-th best
+    const int axis     = axis_[mid];
+    const double delta = q[axis] - p[axis];
+    if (delta < 0) {
+        search(lo, mid, q, k, best, best_d2, nbest);
+        if (*nbest < k || delta * delta <= best_d2[*nbest - 1])
+            search(mid + 1, hi, q, k, best, best_d2, nbest);
+    }
+    else {
+        search(mid + 1, hi, q, k, best, best_d2, nbest);
+        if (*nbest < k || delta * delta <= best_d2[*nbest - 1])
+            search(lo, mid, q, k, best, best_d2, nbest);
+    }
+}
+
+size_t KdTree::find(double lat, double lon, size_t k, size_t* indexes) const
+{
+    std::vector<double> best_d2(k);
+    double q[3];
+    size_t nbest = 0;
+
+    to_xyz(lat, lon, q);
+    search(0, index_.size(), q, k, indexes, best_d2.data(), &nbest);
+    return nbest;
+}
+
+class KdTreeCache {
+public:
+    std::shared_ptr<const KdTree> get(const std::string& key)
+    {
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->first == key) {
+                entries_.splice(entries_.begin(), entries_, it);  // most recently used first
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    void put(const std::string& key, const std::shared_ptr<const KdTree>& tree)
+    {
+        entries_.emplace_front(key, tree);
+        if (entries_.size() > KDTREE_CACHE_SIZE)
+            entries_.pop_back();
+    }
+
+private:
+    std::list<std::pair<std::string, std::shared_ptr<const KdTree>>> entries_;
+};
+
+/* The grid section checksum identifies the geometry */
+static int kdtree_cache_key(grib_handle* h, size_t nvalues, std::string& key)
+{
+    char md5[128] = {0,};
+    size_t len    = sizeof(md5);
+    int err       = grib_get_string(h, "md5GridSection", md5, &len);
+    if (err)
+        return err;
+    key = std::string(md5) + "/" + std::to_string(nvalues);
+    return GRIB_SUCCESS;
+}
+
+static std::shared_ptr<const KdTree> kdtree_new(grib_handle* h, size_t nvalues, int* err)
+{
+    double lat = 0, lon = 0, value = 0;
+    size_t n   = 0;
+    std::vector<double> lats(nvalues), lons(nvalues);
+
+    grib_iterator* iter = grib_iterator_new(h, GRIB_GEOITERATOR_NO_VALUES, err);
+    if (*err)
+        return nullptr;
+    while (grib_iterator_next(iter, &lat, &lon, &value)) {
+        ECCODES_ASSERT(n < nvalues);
+        lats[n] = lat;
+        lons[n] = lon;
+        n++;
+    }
+    grib_iterator_delete(iter);
+
+    return std::make_shared<const KdTree>(lats.data(), lons.data(), n);
+}
+
+std::shared_ptr<const KdTree> grib_nearest_kdtree_get(grib_handle* h, size_t nvalues, int* err)
+{
+    grib_context* c = h->context;
+    std::string key;
+    std::shared_ptr<const KdTree> tree;
+
+    *err = GRIB_SUCCESS;
+    if (kdtree_cache_key(h, nvalues, key) != GRIB_SUCCESS) {
+        // Geometry cannot be identified: index just for this search
+        return kdtree_new(h, nvalues, err);
+    }
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex);
+    if (c->nearest_kdtree_cache)
+        tree = c->nearest_kdtree_cache->get(key);
+    GRIB_MUTEX_UNLOCK(&mutex);
+    if (tree)
+        return tree;
+
+    // Build outside the lock: two threads may build the same index, one of which is dropped
+    tree = kdtree_new(h, nvalues, err);
+    if (!tree)
+        return nullptr;
+    grib_context_log(c, GRIB_LOG_DEBUG, "Nearest: built kd-tree for %zu points (%s)", tree->size(), key.c_str());
+
+    GRIB_MUTEX_LOCK(&mutex);
+    if (!c->nearest_kdtree_cache)
+        c->nearest_kdtree_cache = new KdTreeCache();
+    c->nearest_kdtree_cache->put(key, tree);
+    GRIB_MUTEX_UNLOCK(&mutex);
+
+    return tree;
+}
+
+}  // namespace eccodes::geo_nearest
+
+void grib_nearest_kdtree_cache_delete(grib_context* c)
+{
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex);
+    delete c->nearest_kdtree_cache;
+    c->nearest_kdtree_cache = NULL;
+    GRIB_MUTEX_UNLOCK(&mutex);
+}
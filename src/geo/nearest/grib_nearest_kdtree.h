@@ -0,0 +1,55 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include "grib_api_internal.h"
+#include <memory>
+#include <vector>
+
+namespace eccodes::geo_nearest {
+
+// Spatial index of the points of a grid for the generic nearest neighbour search.
+// Points are stored as (x,y,z) on the unit sphere: the chord length increases with the
+// great-circle distance so the k nearest points are the same, with no special case
+// for the poles or the dateline.
+class KdTree {
+public:
+    KdTree(const double* lats, const double* lons, size_t n);
+
+    // Indexes of the (at most) k nearest points to (lat,lon), closest first. Returns their number
+    size_t find(double lat, double lon, size_t k, size_t* indexes) const;
+
+    size_t size() const { return lats_.size(); }
+    double lat(size_t i) const { return lats_[i]; }
+    double lon(size_t i) const { return lons_[i]; }
+
+    // All latitudes in ascending order
+    const std::vector<double>& sorted_lats() const { return sorted_lats_; }
+
+private:
+    void build(const double* points, size_t lo, size_t hi);
+    void search(size_t lo, size_t hi, const double* q, size_t k, size_t* best, double* best_d2, size_t* nbest) const;
+
+    std::vector<double> lats_;  // by grid point index
+    std::vector<double> lons_;
+    std::vector<double> sorted_lats_;
+
+    // Nodes of an implicit balanced tree: the median of [lo,hi) is at (lo+hi)/2
+    std::vector<double> xyz_;          // 3 coordinates per node
+    std::vector<size_t> index_;        // grid point index of the node
+    std::vector<unsigned char> axis_;  // splitting axis of the node
+};
+
+// The index of the nvalues points of the grid of the handle, shared by all handles with
+// the same geometry. Returns NULL on error
+std::shared_ptr<const KdTree> grib_nearest_kdtree_get(grib_handle* h, size_t nvalues, int* err);
+
+}  // namespace eccodes::geo_nearest
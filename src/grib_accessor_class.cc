@@ -71,7 +71,7 @@ static struct table_entry table[] = {
 grib_section* grib_create_root_section(const grib_context* context, grib_handle* h)
 {
     const char* fpath = 0;
-    grib_section* s = (grib_section*)grib_context_malloc_clear(context, sizeof(grib_section));
+    grib_section* s = (grib_section*)grib_arena_malloc_clear(grib_handle_arena(h), sizeof(grib_section));
 
     GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
     GRIB_MUTEX_LOCK(&mutex1);
@@ -92,7 +92,7 @@ grib_section* grib_create_root_section(const grib_context* context, grib_handle*
     s->aclength = NULL;
     s->owner    = NULL;
     s->block    = (grib_block_of_accessors*)
-        grib_context_malloc_clear(context, sizeof(grib_block_of_accessors));
+        grib_arena_malloc_clear(grib_handle_arena(h), sizeof(grib_block_of_accessors));
     grib_context_log(context, GRIB_LOG_DEBUG, "Creating root section");
     return s;
 }
@@ -129,7 +129,9 @@ grib_accessor* grib_accessor_factory(grib_section* p, grib_action* creator,
     size_t size            = 0;
 
     grib_accessor* builder = *((grib_accessor_hash(creator->op, strlen(creator->op)))->cclass);
+    grib_arena* previous   = grib_arena_set_current(grib_handle_arena(p->h));
     a = builder->create_empty_accessor();
+    grib_arena_set_current(previous);
 
     a->name_       = creator->name;
     a->name_space_ = creator->name_space;
@@ -221,6 +223,24 @@ static void link_same_attributes(grib_accessor* a, grib_accessor* b)
     }
 }
 
+/* The key id of an accessor's name. Actions of the definition files remember it for the next messages.
+ * Not the temporary actions made on the stack (e.g. by BUFR) which have no context and change name */
+static int accessor_key_id(grib_accessor* a)
+{
+    grib_action* creator = a->creator_;
+    int id               = 0;
+
+    if (creator && creator->context == a->context_ && creator->name == a->all_names_[0]) {
+        id = creator->key_id.load(std::memory_order_relaxed);
+        if (id)
+            return id - 1;
+        id = grib_hash_keys_get_id(a->context_->keys, a->all_names_[0]);
+        creator->key_id.store(id + 1, std::memory_order_relaxed);
+        return id;
+    }
+    return grib_hash_keys_get_id(a->context_->keys, a->all_names_[0]);
+}
+
 void grib_push_accessor(grib_accessor* a, grib_block_of_accessors* l)
 {
     int id;
@@ -236,7 +256,7 @@ void grib_push_accessor(grib_accessor* a, grib_block_of_accessors* l)
     if (hand->use_trie) {
         DEBUG_ASSERT( a->all_names_[0] );
         if (*(a->all_names_[0]) != '_') {
-            id = grib_hash_keys_get_id(a->context_->keys, a->all_names_[0]);
+            id = accessor_key_id(a);
 
             DEBUG_ASSERT(id >= 0 && id < ACCESSORS_ARRAY_SIZE);
 
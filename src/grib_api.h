@@ -1102,6 +1102,16 @@ typedef off_t (*grib_data_seek_proc)(const grib_context* c, off_t offset, int wh
  */
 typedef int (*grib_data_eof_proc)(const grib_context* c, void* stream);
 
+/**
+ * message procedure, format of a procedure called for each message of a file by codes_file_parallel_foreach
+ *
+ * @param h             : the handle of the message, deleted when the procedure returns
+ * @param index         : the index of the message in the file, starting at 0
+ * @param data          : the user data
+ * @return              0 to continue, any other value stops the processing of the file
+ */
+typedef int (*grib_foreach_proc)(grib_handle* h, int index, void* data);
+
 /**
  *  Get the static default context
  *
@@ -17,6 +17,7 @@
 #define grib_api_internal_H
 
 #ifdef __cplusplus
+#include <atomic>
 extern "C" {
 #endif
 
@@ -196,7 +197,9 @@ extern int pthread_mutexattr_settype(pthread_mutexattr_t* attr, int type);
 #define MAX_FILE_HANDLES_WITH_MULTI 10
 #define ACCESSORS_ARRAY_SIZE        5000
 #define MAX_NUM_CONCEPTS            2000
+#define MAX_CONCEPT_INDEX_KEYS      4
 #define MAX_NUM_HASH_ARRAY          2000
+#define MAX_NUM_KEY_REFS            2000
 
 #define CODES_NAMESPACE   10
 #define MAX_NAMESPACE_LEN 64
@@ -246,6 +249,9 @@ typedef struct grib_action_file grib_action_file;
 typedef struct grib_action_file_list grib_action_file_list;
 typedef struct grib_block_of_accessors grib_block_of_accessors;
 typedef struct grib_buffer grib_buffer;
+typedef struct grib_mapped_file grib_mapped_file;
+typedef struct grib_arena grib_arena;
+typedef struct grib_values_cache grib_values_cache;
 class grib_accessor_class;
 typedef struct grib_action grib_action;
 typedef struct grib_action_class grib_action_class;
@@ -256,6 +262,7 @@ typedef struct grib_smart_table grib_smart_table;
 class grib_accessor;
 namespace eccodes::geo_iterator {
 class Iterator;
+class GeometryCache;
 }
 
 typedef struct grib_iterator
@@ -339,6 +346,7 @@ struct grib_action
     grib_arguments* default_value; /** default expression as in .def file */
     char* set;
     char* debug_info; /** purely for debugging and tracing */
+    std::atomic<int> key_id; /** id of name plus one, 0 if not yet known. See grib_push_accessor */
 };
 
 class grib_accessors_list;
@@ -366,7 +374,7 @@ struct grib_action_class
     const char* name;          /** < name of the behaviour class */
     size_t size;               /** < size in bytes of the structure */
 
-    int inited;
+    std::atomic<int> inited;   /** < set once init_class has run, read without locking */
     action_init_class_proc init_class;
 
     action_init_proc init;
@@ -454,6 +462,7 @@ struct grib_section
 
 namespace eccodes::geo_nearest {
 class Nearest;
+class KdTreeCache;
 }
 
 typedef struct grib_nearest
@@ -465,7 +474,9 @@ typedef struct grib_nearest
 
 struct grib_dependency
 {
-    grib_dependency* next;
+    grib_dependency* next;          /** All the dependencies of the handle */
+    grib_dependency* next_observer; /** The other dependencies on the same observed accessor */
+    grib_dependency* next_observed; /** The other dependencies of the same observer */
     grib_accessor* observed;
     grib_accessor* observer;
     int run;
@@ -616,6 +627,15 @@ void codes_assertion_failed(const char* message, const char* file, int line);
 
 #define MAX_SET_VALUES     10
 #define MAX_ACCESSOR_CACHE 100
+#define MAX_DEFERRED_REBUILDS 32
+
+/* A section rebuild held back until the values being set are all applied. See grib_set_values */
+typedef struct grib_deferred_rebuild
+{
+    grib_accessor* notified;  /** Accessor owning the section to rebuild */
+    const char* changed;      /** Name of the key which triggered it */
+    int level;                /** Value of values_stack when deferred */
+} grib_deferred_rebuild;
 
 struct grib_handle
 {
@@ -643,6 +663,14 @@ struct grib_handle
     /* grib_accessor* groups[MAX_NUM_GROUPS]; */
     ProductKind product_kind;
     /* grib_trie* bufr_elements_table; */
+    unsigned long change_count; /** Incremented whenever a key is changed. See grib_dependency_notify_change */
+    grib_mapped_file* mapped_file; /** Memory-mapped file holding the message, if any. See codes_io_mmap_on */
+    grib_arena* arena;             /** Memory of the accessors, sections and dependencies. See grib_handle_arena */
+    grib_values_cache* values_cache; /** Decoded arrays of the data keys. See codes_values_cache_on */
+    int defer_rebuilds;              /** Level of values_stack at which section rebuilds are deferred, 0 if none */
+    grib_accessor* deferred_key;     /** Key being set whose rebuilds are deferred */
+    size_t deferred_count;
+    grib_deferred_rebuild deferred[MAX_DEFERRED_REBUILDS]; /** See codes_deferred_rebuilds_on */
 };
 
 /* For GRIB2 multi-field messages */
@@ -699,6 +727,10 @@ struct grib_concept_value_name
     char* name;
 };
 
+/* Hash of the concept values on the integer keys (e.g. discipline, parameterNumber)
+ * tested by most of them. See grib_concept.cc */
+typedef struct grib_concept_match_index grib_concept_match_index;
+
 typedef struct grib_concept_value grib_concept_value;
 struct grib_concept_value
 {
@@ -706,8 +738,25 @@ struct grib_concept_value
     char* name;
     grib_concept_condition* conditions;
     grib_trie* index;
+    grib_concept_match_index* match_index;
 };
 
+/* Image of parsed definition files written by codes_compile_definitions.
+ * See grib_definitions_cache.cc */
+typedef struct grib_definitions_cache grib_definitions_cache;
+
+/* Latitudes of the Gaussian grids already computed. See grib_geography.cc */
+typedef struct grib_gaussian_latitudes_cache grib_gaussian_latitudes_cache;
+
+/* Key resolved once by codes_key_id. See grib_query.cc */
+typedef struct grib_key_ref
+{
+    char* key;        /* As passed to codes_key_id */
+    char* name;       /* Without the namespace */
+    char* name_space; /* NULL if none */
+    int hash_id;      /* Slot in the handle accessors, -1 to look the key up by name */
+} grib_key_ref;
+
 /* ----------*/
 struct grib_context
 {
@@ -716,6 +765,12 @@ struct grib_context
     int write_on_fail;
     int no_abort;
     int io_buffer_size;
+    int io_mmap;
+    int handle_arena;
+    int gaussian_threads;
+    int geometry_cache_size;
+    int values_cache;
+    int deferred_rebuilds;
     int no_big_group_split;
     int no_spd;
     int keep_matrix;
@@ -749,6 +804,7 @@ struct grib_context
     grib_print_proc print;
 
     grib_codetable* codetable;
+    grib_trie* codetable_index; /* codetable by file names, read without locking */
     grib_smart_table* smart_table;
     char* outfilename;
     int multi_support_on;
@@ -782,6 +838,12 @@ struct grib_context
     grib_trie* classes;
     grib_trie* lists;
     grib_trie* expanded_descriptors;
+    eccodes::geo_nearest::KdTreeCache* nearest_kdtree_cache;
+    eccodes::geo_iterator::GeometryCache* geometry_cache;
+    grib_definitions_cache* definitions_cache;
+    grib_gaussian_latitudes_cache* gaussian_latitudes_cache;
+    std::atomic<int> key_refs_count; /** Published after its slot of key_refs is filled. See codes_key_id */
+    grib_key_ref* key_refs[MAX_NUM_KEY_REFS];
     int file_pool_max_opened_files;
 #if GRIB_PTHREADS
     pthread_mutex_t mutex;
@@ -985,6 +1047,8 @@ struct grib_field_list
     grib_field_list* next;
 };
 
+typedef struct grib_index_lookup grib_index_lookup;
+
 struct grib_index
 {
     grib_context* context;
@@ -999,6 +1063,7 @@ struct grib_index
     int count;
     ProductKind product_kind;
     int unpack_bufr; /* Only meaningful for product_kind of BUFR */
+    grib_index_lookup* lookup; /* Hash tables over fields and keys, built on demand */
 };
 
 /* header compute */
@@ -1036,6 +1101,7 @@ struct grib_action_file_list
 {
     grib_action_file* first;
     grib_action_file* last;
+    grib_trie* index; /* action files by file name, read without locking */
 };
 
 /* Common keys iterator */
@@ -75,12 +75,18 @@ static void init_bits_all_one()
         *(--v) = ~(cmask << --size);
 }
 
+/* Set once the table is filled so that it is then read without locking */
+static std::atomic<bool> bits_all_one_ready{false};
+
 static void init_bits_all_one_if_needed()
 {
+    if (bits_all_one_ready.load(std::memory_order_acquire))
+        return;
     GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
     GRIB_MUTEX_LOCK(&mutex);
     if (!bits_all_one.inited)
         init_bits_all_one();
+    bits_all_one_ready.store(true, std::memory_order_release);
     GRIB_MUTEX_UNLOCK(&mutex);
 }
 int grib_is_all_bits_one(int64_t val, long nbits)
@@ -356,6 +362,13 @@ size_t grib_decode_size_t(const unsigned char* p, long* bitp, long nbits)
         return grib_decode_size_t(p, bitp, bits);
     }
 
+    if ((*bitp & 7) + nbits > max_nbits_size_t) {
+        /* The value straddles 9 octets: read the bits of the first one on their own */
+        const long first = 8 - (*bitp & 7);
+        const size_t hi  = grib_decode_size_t(p, bitp, first);
+        return (hi << (nbits - first)) | grib_decode_size_t(p, bitp, nbits - first);
+    }
+
     mask = BIT_MASK_SIZE_T(nbits);
     /* pi: position of bitp in p[]. >>3 == /8 */
     pi = oc;
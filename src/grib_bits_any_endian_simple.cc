@@ -165,16 +165,73 @@ int grib_decode_double_array_complex(const unsigned char* p, long* bitp, long nb
     return GRIB_NOT_IMPLEMENTED;
 }
 
+/* Bit writer for the encoders below: values are shifted into a 64-bit accumulator and written
+ * out a whole octet at a time instead of bit by bit. Bits of the first and last octets lying
+ * outside the encoded range are left untouched, as grib_encode_unsigned_longb does */
+typedef struct grib_bit_writer
+{
+    unsigned char* q; /* next octet to write */
+    uint64_t acc;     /* pending bits, right aligned */
+    int nbits;        /* number of pending bits, less than 8 between two values */
+} grib_bit_writer;
+
+static void grib_bit_writer_init(grib_bit_writer* w, unsigned char* p, long bitp)
+{
+    w->q     = p + bitp / 8;
+    w->nbits = bitp % 8;
+    w->acc   = w->nbits ? (w->q[0] >> (8 - w->nbits)) : 0;
+}
+
+/* nb must not exceed 56 */
+static inline void grib_bit_writer_put(grib_bit_writer* w, uint64_t v, int nb)
+{
+    w->acc = (w->acc << nb) | v;
+    w->nbits += nb;
+    while (w->nbits >= 8) {
+        w->nbits -= 8;
+        *w->q++ = (unsigned char)(w->acc >> w->nbits);
+    }
+}
+
+static inline void grib_bit_writer_put_value(grib_bit_writer* w, unsigned long v, long nb)
+{
+    const unsigned long maxV = BIT_MASK1(nb);
+    if (v > maxV) {
+        fprintf(stderr, "ECCODES WARNING :  %s: Trying to encode value of %lu but the maximum allowable value is %lu (number of bits=%ld)\n",
+                __func__, v, maxV, nb);
+        v &= maxV;
+    }
+    if (nb > 56) {
+        grib_bit_writer_put(w, v >> 32, nb - 32);
+        grib_bit_writer_put(w, v & 0xffffffffUL, 32);
+    }
+    else {
+        grib_bit_writer_put(w, v, nb);
+    }
+}
+
+static void grib_bit_writer_flush(grib_bit_writer* w)
+{
+    if (w->nbits > 0) {
+        const int keep = 8 - w->nbits;
+        w->q[0]        = (unsigned char)((w->acc << keep) | (w->q[0] & ((1u << keep) - 1)));
+    }
+}
+
 int grib_encode_long_array(size_t n_vals, const long* val, long bits_per_value, unsigned char* p, long* off)
 {
     size_t i                   = 0;
     unsigned long unsigned_val = 0;
     unsigned char* encoded     = p;
     if (bits_per_value % 8) {
+        grib_bit_writer w;
+        grib_bit_writer_init(&w, p, *off);
         for (i = 0; i < n_vals; i++) {
             unsigned_val = val[i];
-            grib_encode_unsigned_longb(encoded, unsigned_val, off, bits_per_value);
+            grib_bit_writer_put_value(&w, unsigned_val, bits_per_value);
         }
+        grib_bit_writer_flush(&w);
+        *off += bits_per_value * n_vals;
     }
     else {
         for (i = 0; i < n_vals; i++) {
@@ -192,32 +249,45 @@ int grib_encode_long_array(size_t n_vals, const long* val, long bits_per_value,
     return GRIB_SUCCESS;
 }
 
+/* Quantise and store values on a whole number of octets L */
+template <int L>
+static void grib_encode_double_array_octets(size_t n_vals, const double* val, double reference_value, double d, double divisor, unsigned char* encoded)
+{
+    for (size_t i = 0; i < n_vals; i++) {
+        const unsigned long unsigned_val = (unsigned long)((((val[i] * d) - reference_value) * divisor) + 0.5);
+        for (int k = L - 1; k >= 0; k--)
+            *encoded++ = (unsigned char)(unsigned_val >> (8 * k));
+    }
+}
+
+/* Quantisation and bit packing are done in the same pass over the values */
 int grib_encode_double_array(size_t n_vals, const double* val, long bits_per_value, double reference_value, double d, double divisor, unsigned char* p, long* off)
 {
-    size_t i                   = 0;
-    unsigned long unsigned_val = 0;
-    unsigned char* encoded     = p;
-    double x;
+    size_t i = 0;
     if (bits_per_value % 8) {
+        grib_bit_writer w;
+        grib_bit_writer_init(&w, p, *off);
         for (i = 0; i < n_vals; i++) {
-            x            = (((val[i] * d) - reference_value) * divisor) + 0.5;
-            unsigned_val = (unsigned long)x;
-            grib_encode_unsigned_longb(encoded, unsigned_val, off, bits_per_value);
+            const double x                   = (((val[i] * d) - reference_value) * divisor) + 0.5;
+            const unsigned long unsigned_val = (unsigned long)x;
+            grib_bit_writer_put_value(&w, unsigned_val, bits_per_value);
         }
+        grib_bit_writer_flush(&w);
+        *off += bits_per_value * n_vals;
     }
     else {
-        for (i = 0; i < n_vals; i++) {
-            int blen     = 0;
-            blen         = bits_per_value;
-            x            = ((((val[i] * d) - reference_value) * divisor) + 0.5);
-            unsigned_val = (unsigned long)x;
-            while (blen >= 8) {
-                blen -= 8;
-                *encoded = (unsigned_val >> blen);
-                encoded++;
-                *off += 8;
-            }
+        switch (bits_per_value / 8) {
+            case 0: return GRIB_SUCCESS;
+            case 1: grib_encode_double_array_octets<1>(n_vals, val, reference_value, d, divisor, p); break;
+            case 2: grib_encode_double_array_octets<2>(n_vals, val, reference_value, d, divisor, p); break;
+            case 3: grib_encode_double_array_octets<3>(n_vals, val, reference_value, d, divisor, p); break;
+            case 4: grib_encode_double_array_octets<4>(n_vals, val, reference_value, d, divisor, p); break;
+            case 5: grib_encode_double_array_octets<5>(n_vals, val, reference_value, d, divisor, p); break;
+            case 6: grib_encode_double_array_octets<6>(n_vals, val, reference_value, d, divisor, p); break;
+            case 7: grib_encode_double_array_octets<7>(n_vals, val, reference_value, d, divisor, p); break;
+            default: grib_encode_double_array_octets<8>(n_vals, val, reference_value, d, divisor, p); break;
         }
+        *off += bits_per_value * n_vals;
     }
     return GRIB_SUCCESS;
 }
@@ -11,95 +11,188 @@
 #pragma once
 
 #include "grib_api_internal.h"
+#include <cstdint>
 
 /* A mask with x least-significant bits set, possibly 0 or >=32 */
 /* -1UL is 1111111... in every bit in binary representation */
 #define BIT_MASK1(x) \
     (((x) >= max_nbits) ? (unsigned long)-1UL : (1UL << (x)) - 1)
 
+/* Widest value which always fits in a single 8-octet window, whatever its bit offset */
+#define GRIB_DECODE_WINDOW_MAX_BITS 57
 
+/* Integer to double conversion for values narrower than 64 bits. Exact, and unlike the
+ * unsigned conversion the signed one maps onto a single SIMD instruction on most targets */
+#define GRIB_DECODE_TO_DOUBLE(x) ((double)(int64_t)(x))
+
+/* Big-endian load of the 8 octets starting at p (compilers turn this into a load + bswap) */
+static inline uint64_t grib_decode_load_be64(const unsigned char* p)
+{
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+           ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | ((uint64_t)p[7]);
+}
+
+/* Read nbits (1..64) starting at bit offset bitoff, touching only the octets holding them */
+static inline unsigned long grib_decode_bits_at(const unsigned char* p, size_t bitoff, long nbits)
+{
+    const unsigned char* q = p + (bitoff >> 3);
+    const int shift        = bitoff & 7;
+    const int nbytes       = (shift + nbits + 7) >> 3; /* 1..9 */
+    uint64_t w             = 0;
+    int k;
+
+    for (k = 0; k < nbytes && k < 8; k++)
+        w = (w << 8) | q[k];
+
+    if (nbytes <= 8)
+        return (unsigned long)((w >> (nbytes * 8 - shift - nbits)) & BIT_MASK1(nbits));
+
+    /* nbits > 57 straddling 9 octets */
+    w = (w << shift) | (q[8] >> (8 - shift));
+    return (unsigned long)(w >> (64 - nbits));
+}
+
+/* Values stored on a whole number of octets L, starting on an octet boundary. See ECC-386 */
+template <int L, typename T>
+static void grib_decode_array_octets(const unsigned char* p, double reference_value, double s, double d,
+                                     size_t n_vals, T* val)
+{
+    for (size_t i = 0; i < n_vals; i++) {
+        const unsigned char* q = p + i * L;
+        unsigned long lvalue   = 0;
+        for (int k = 0; k < L; k++)
+            lvalue = (lvalue << 8) | q[k];
+        if (L < 8)
+            val[i] = ((GRIB_DECODE_TO_DOUBLE(lvalue) * s) + reference_value) * d;
+        else
+            val[i] = ((lvalue * s) + reference_value) * d;
+    }
+}
+
+/* 12 bits per value starting on an octet boundary: two values in every three octets */
 template <typename T>
-int grib_decode_array(const unsigned char* p, long* bitp, long bitsPerValue,
-                             double reference_value, double s, double d,
-                             size_t n_vals, T* val)
+static void grib_decode_array_12(const unsigned char* p, double reference_value, double s, double d,
+                                 size_t n_vals, T* val)
 {
-    size_t i               = 0;
-    unsigned long lvalue = 0;
-    T x;
-
-#ifdef SLOW_OLD_CODE
-    /* slow reference code */
-    int j=0;
-    for(i=0; i < n_vals; i++) {
-        lvalue=0;
-        for(j=0; j< bitsPerValue;j++){
-            lvalue <<= 1;
-            if(grib_get_bit( p, *bitp)) lvalue += 1;
-            *bitp += 1;
-        }
-        x=((lvalue*s)+reference_value)*d;
-        val[i] = x;
+    const size_t n_pairs = n_vals / 2;
+    for (size_t i = 0; i < n_pairs; i++) {
+        const unsigned char* q = p + i * 3;
+        const unsigned long a  = ((unsigned long)q[0] << 4) | (q[1] >> 4);
+        const unsigned long b  = ((unsigned long)(q[1] & 0x0f) << 8) | q[2];
+        val[2 * i]             = ((GRIB_DECODE_TO_DOUBLE(a) * s) + reference_value) * d;
+        val[2 * i + 1]         = ((GRIB_DECODE_TO_DOUBLE(b) * s) + reference_value) * d;
+    }
+    if (n_vals & 1) {
+        const unsigned long a = grib_decode_bits_at(p, n_pairs * 24, 12);
+        val[n_vals - 1]       = ((a * s) + reference_value) * d;
     }
-#endif
-    if (bitsPerValue % 8 == 0) {
-        /* See ECC-386 */
-        int bc;
-        int l    = bitsPerValue / 8;
-        size_t o = 0;
+}
 
-        for (i = 0; i < n_vals; i++) {
-            lvalue = 0;
-            lvalue <<= 8;
-            lvalue |= p[o++];
-
-            for (bc = 1; bc < l; bc++) {
-                lvalue <<= 8;
-                lvalue |= p[o++];
-            }
-            x      = ((lvalue * s) + reference_value) * d;
-            val[i] = x;
-            /*  *bitp += bitsPerValue * n_vals; */
+/* Any width up to GRIB_DECODE_WINDOW_MAX_BITS at any bit offset: one 8-octet window per value.
+ * The last few values, whose window would run past the end of the packed data, are read octet by octet */
+template <typename T>
+static void grib_decode_array_window(const unsigned char* p, size_t bitoff, long bitsPerValue,
+                                     double reference_value, double s, double d,
+                                     size_t n_vals, T* val)
+{
+    const size_t nbytes = (bitoff + n_vals * bitsPerValue + 7) / 8;
+    const int rshift    = 64 - bitsPerValue;
+    size_t n_fast       = 0;
+    size_t i;
+
+    if (nbytes >= 8 && (nbytes - 8) * 8 + 7 >= bitoff) {
+        n_fast = ((nbytes - 8) * 8 + 7 - bitoff) / bitsPerValue + 1;
+        if (n_fast > n_vals)
+            n_fast = n_vals;
+    }
+
+    for (i = 0; i < n_fast; i++) {
+        const size_t bo            = bitoff + i * bitsPerValue;
+        const unsigned long lvalue = (unsigned long)((grib_decode_load_be64(p + (bo >> 3)) << (bo & 7)) >> rshift);
+        val[i]                     = ((GRIB_DECODE_TO_DOUBLE(lvalue) * s) + reference_value) * d;
+    }
+    for (; i < n_vals; i++) {
+        const unsigned long lvalue = grib_decode_bits_at(p, bitoff + i * bitsPerValue, bitsPerValue);
+        val[i]                     = ((lvalue * s) + reference_value) * d;
+    }
+}
+
+/* Same windows as grib_decode_array_window for callers doing their own conversion: f(i, X[i]) is called
+ * for each of the n_vals values of bitsPerValue (1 to 64) bits starting at bit offset bitoff */
+template <typename F>
+static void grib_decode_each(const unsigned char* p, size_t bitoff, long bitsPerValue, size_t n_vals, F f)
+{
+    const size_t nbytes = (bitoff + n_vals * bitsPerValue + 7) / 8;
+    const int rshift    = 64 - bitsPerValue;
+    size_t n_fast       = 0;
+    size_t i;
+
+    if (bitsPerValue <= GRIB_DECODE_WINDOW_MAX_BITS && nbytes >= 8 && (nbytes - 8) * 8 + 7 >= bitoff) {
+        n_fast = ((nbytes - 8) * 8 + 7 - bitoff) / bitsPerValue + 1;
+        if (n_fast > n_vals)
+            n_fast = n_vals;
+    }
+
+    for (i = 0; i < n_fast; i++) {
+        const size_t bo = bitoff + i * bitsPerValue;
+        f(i, (unsigned long)((grib_decode_load_be64(p + (bo >> 3)) << (bo & 7)) >> rshift));
+    }
+    for (; i < n_vals; i++)
+        f(i, grib_decode_bits_at(p, bitoff + i * bitsPerValue, bitsPerValue));
+}
+
+/**
+ * decode an array of n_vals values from an octet-bitstream and apply the simple packing scaling
+ * val[i] = ((X[i] * s) + reference_value) * d
+ *
+ * The unpacking kernel is chosen once per call from bitsPerValue and the starting bit offset:
+ * whole octets (8, 16, 24, ...), 12 bits, a generic 8-octet window for widths up to 57 bits and
+ * an octet-by-octet reader for the widest values.
+ *
+ * @param p input bitstream, for technical reasons put into octets
+ * @param bitp current position in the bitstream, advanced by bitsPerValue * n_vals
+ * @param bitsPerValue number of bits needed to build a number (0 to 64)
+ * @param n_vals number of values to decode
+ * @param val output
+ */
+template <typename T>
+int grib_decode_array(const unsigned char* p, long* bitp, long bitsPerValue,
+                      double reference_value, double s, double d,
+                      size_t n_vals, T* val)
+{
+    const size_t bitoff = *bitp;
+    size_t i;
+
+    if (bitsPerValue == 0) {
+        for (i = 0; i < n_vals; i++)
+            val[i] = ((0 * s) + reference_value) * d;
+    }
+    else if (bitsPerValue % 8 == 0 && bitoff % 8 == 0) {
+        const unsigned char* q = p + bitoff / 8;
+        switch (bitsPerValue / 8) {
+            case 1: grib_decode_array_octets<1>(q, reference_value, s, d, n_vals, val); break;
+            case 2: grib_decode_array_octets<2>(q, reference_value, s, d, n_vals, val); break;
+            case 3: grib_decode_array_octets<3>(q, reference_value, s, d, n_vals, val); break;
+            case 4: grib_decode_array_octets<4>(q, reference_value, s, d, n_vals, val); break;
+            case 5: grib_decode_array_octets<5>(q, reference_value, s, d, n_vals, val); break;
+            case 6: grib_decode_array_octets<6>(q, reference_value, s, d, n_vals, val); break;
+            case 7: grib_decode_array_octets<7>(q, reference_value, s, d, n_vals, val); break;
+            default: grib_decode_array_octets<8>(q, reference_value, s, d, n_vals, val); break;
         }
     }
+    else if (bitsPerValue == 12 && bitoff % 8 == 0) {
+        grib_decode_array_12(p + bitoff / 8, reference_value, s, d, n_vals, val);
+    }
+    else if (bitsPerValue <= GRIB_DECODE_WINDOW_MAX_BITS) {
+        grib_decode_array_window(p, bitoff, bitsPerValue, reference_value, s, d, n_vals, val);
+    }
     else {
-        unsigned long mask = BIT_MASK1(bitsPerValue);
-
-        /* pi: position of bitp in p[]. >>3 == /8 */
-        long pi = *bitp / 8;
-        /* some bits might of the current byte at pi might be used */
-        /* by the previous number usefulBitsInByte gives remaining unused bits */
-        /* number of useful bits in current byte */
-        int usefulBitsInByte = 8 - (*bitp & 7);
         for (i = 0; i < n_vals; i++) {
-            /* value read as long */
-            long bitsToRead = 0;
-            lvalue          = 0;
-            bitsToRead      = bitsPerValue;
-            /* read one byte after the other to lvalue until >= bitsPerValue are read */
-            while (bitsToRead > 0) {
-                lvalue <<= 8;
-                lvalue += p[pi];
-                pi++;
-                bitsToRead -= usefulBitsInByte;
-                usefulBitsInByte = 8;
-            }
-            *bitp += bitsPerValue;
-            /* bitsToRead is now <= 0, remove the last bits */
-            lvalue >>= -1 * bitsToRead;
-            /* set leading bits to 0 - removing bits used for previous number */
-            lvalue &= mask;
-
-            usefulBitsInByte = -1 * bitsToRead; /* prepare for next round */
-            if (usefulBitsInByte > 0) {
-                pi--; /* reread the current byte */
-            }
-            else {
-                usefulBitsInByte = 8; /* start with next full byte */
-            }
-            /* scaling and move value to output */
-            x      = ((lvalue * s) + reference_value) * d;
-            val[i] = x;
+            const unsigned long lvalue = grib_decode_bits_at(p, bitoff + i * bitsPerValue, bitsPerValue);
+            val[i]                     = ((lvalue * s) + reference_value) * d;
         }
     }
+
+    *bitp += bitsPerValue * n_vals;
     return 0;
 }
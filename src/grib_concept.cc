@@ -9,6 +9,10 @@
  */
 
 #include "grib_api_internal.h"
+#include <array>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 grib_concept_value* grib_concept_value_new(grib_context* c, const char* name, grib_concept_condition* conditions)
 {
@@ -41,7 +45,166 @@ grib_concept_condition* grib_concept_condition_new(grib_context* c, const char*
 
 void grib_concept_condition_delete(grib_context* c, grib_concept_condition* v)
 {
-    v->expression->destroy(c);
+    if (v->expression)
+        v->expression->destroy(c);
+    if (v->iarray)
+        grib_iarray_delete(v->iarray);
     grib_context_free_persistent(c, v->name);
     grib_context_free_persistent(c, v);
 }
+
+/* Concept matching index
+ *
+ * Concept values are matched by evaluating their conditions in turn. Most tables (e.g. paramId)
+ * test the same few integer keys against constants in nearly every entry, so the entries are
+ * hashed on the values of those keys. For a given handle only the entries in its bucket plus
+ * those which do not test all the index keys can match.
+ * Each bucket keeps the original list order so the best-match rules are unchanged.
+ */
+
+/* Below this number of entries a linear scan is just as fast */
+#define CONCEPT_INDEX_MIN_ENTRIES 16
+
+typedef std::array<long, MAX_CONCEPT_INDEX_KEYS> concept_index_values;
+
+struct concept_index_values_hash
+{
+    size_t operator()(const concept_index_values& v) const
+    {
+        size_t h = 0;
+        for (long x : v)
+            h = h * 1000003 ^ std::hash<long>()(x);
+        return h;
+    }
+};
+
+struct grib_concept_match_index
+{
+    size_t nkeys;
+    const char* keys[MAX_CONCEPT_INDEX_KEYS];
+    // Entries testing all the keys bucketed on the tested values, merged with the unindexed ones in list order
+    std::unordered_map<concept_index_values, std::vector<grib_concept_value*>, concept_index_values_hash> buckets;
+    // Entries which do not test all the keys: candidates whatever the key values
+    std::vector<grib_concept_value*> unindexed;
+};
+
+/* Return the condition testing key 'name' against an integer constant or NULL */
+static const grib_concept_condition* concept_long_condition(const grib_concept_value* v, const char* name)
+{
+    for (const grib_concept_condition* e = v->conditions; e; e = e->next) {
+        if (e->expression && STR_EQUAL(e->expression->class_name(), "long") && STR_EQUAL(e->name, name))
+            return e;
+    }
+    return NULL;
+}
+
+grib_concept_match_index* grib_concept_match_index_new(grib_context* c, grib_concept_value* concepts)
+{
+    std::unordered_map<std::string_view, size_t> frequency;
+    std::vector<const char*> order; // keys in order of first appearance, for reproducibility
+    size_t count = 0;
+
+    for (grib_concept_value* v = concepts; v; v = v->next) {
+        for (const grib_concept_condition* e = v->conditions; e; e = e->next) {
+            if (e->expression && STR_EQUAL(e->expression->class_name(), "long") && concept_long_condition(v, e->name) == e) {
+                if (frequency[e->name]++ == 0)
+                    order.push_back(e->name);
+            }
+        }
+        count++;
+    }
+    if (count < CONCEPT_INDEX_MIN_ENTRIES)
+        return NULL;
+
+    // Index keys: the most frequently tested, as long as at least 3/4 of the entries test them
+    grib_concept_match_index* index = new grib_concept_match_index();
+    index->nkeys                    = 0;
+    while (index->nkeys < MAX_CONCEPT_INDEX_KEYS) {
+        const char* best = NULL;
+        size_t best_freq = 0;
+        for (const char* key : order) {
+            bool taken = false;
+            for (size_t i = 0; i < index->nkeys; i++)
+                taken = taken || STR_EQUAL(index->keys[i], key);
+            if (!taken && frequency[key] > best_freq) {
+                best      = key;
+                best_freq = frequency[key];
+            }
+        }
+        if (!best || best_freq * 4 < count * 3)
+            break;
+        index->keys[index->nkeys++] = best;
+    }
+    if (index->nkeys == 0) {
+        delete index;
+        return NULL;
+    }
+
+    // Unindexed entries are candidates for every bucket, so merge them in by list position
+    std::vector<grib_concept_value*> entries;
+    std::vector<size_t> unindexed;
+    std::unordered_map<concept_index_values, std::vector<size_t>, concept_index_values_hash> positions;
+    for (grib_concept_value* v = concepts; v; v = v->next) {
+        concept_index_values values = {};
+        bool indexed                = true;
+        for (size_t i = 0; i < index->nkeys && indexed; i++) {
+            const grib_concept_condition* e = concept_long_condition(v, index->keys[i]);
+            if (e)
+                e->expression->evaluate_long(NULL, &values[i]);
+            else
+                indexed = false;
+        }
+        if (indexed)
+            positions[values].push_back(entries.size());
+        else
+            unindexed.push_back(entries.size());
+        entries.push_back(v);
+    }
+
+    for (size_t i : unindexed)
+        index->unindexed.push_back(entries[i]);
+    for (const auto& p : positions) {
+        std::vector<grib_concept_value*>& bucket = index->buckets[p.first];
+        size_t i = 0, j = 0;
+        bucket.reserve(p.second.size() + unindexed.size());
+        while (i < p.second.size() || j < unindexed.size()) {
+            if (j == unindexed.size() || (i < p.second.size() && p.second[i] < unindexed[j]))
+                bucket.push_back(entries[p.second[i++]]);
+            else
+                bucket.push_back(entries[unindexed[j++]]);
+        }
+    }
+
+    grib_context_log(c, GRIB_LOG_DEBUG, "Concept index on %s: %zu entries, %zu buckets, %zu unindexed",
+                     index->keys[0], count, index->buckets.size(), index->unindexed.size());
+    return index;
+}
+
+void grib_concept_match_index_delete(grib_context* c, grib_concept_match_index* index)
+{
+    delete index;
+}
+
+size_t grib_concept_match_index_keys(const grib_concept_match_index* index, const char** keys)
+{
+    for (size_t i = 0; i < index->nkeys; i++)
+        keys[i] = index->keys[i];
+    return index->nkeys;
+}
+
+/* Entries which can match a handle whose index keys have the given values, in list order.
+ * values is NULL if one of the keys could not be decoded as an integer */
+grib_concept_value* const* grib_concept_match_index_candidates(const grib_concept_match_index* index, const long* values, size_t* count)
+{
+    const std::vector<grib_concept_value*>* candidates = &index->unindexed;
+    if (values) {
+        concept_index_values key = {};
+        for (size_t i = 0; i < index->nkeys; i++)
+            key[i] = values[i];
+        auto pos = index->buckets.find(key);
+        if (pos != index->buckets.end())
+            candidates = &pos->second;
+    }
+    *count = candidates->size();
+    return candidates->data();
+}
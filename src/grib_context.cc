@@ -295,6 +295,12 @@ static grib_context default_grib_context = {
     0,               /* write_on_fail              */
     0,               /* no_abort                   */
     0,               /* io_buffer_size             */
+    0,               /* io_mmap                    */
+    1,               /* handle_arena               */
+    1,               /* gaussian_threads           */
+    256,             /* geometry_cache_size        */
+    0,               /* values_cache               */
+    0,               /* deferred_rebuilds          */
     0,               /* no_big_group_split         */
     0,               /* no_spd                     */
     0,               /* keep_matrix                */
@@ -341,6 +347,7 @@ static grib_context default_grib_context = {
     &default_log,   /* output_log                 */
     &default_print, /* print                      */
     0,              /* codetable                  */
+    0,              /* codetable_index            */
     0,              /* smart_table                */
     0,              /* outfilename                */
     0,              /* multi_support_on           */
@@ -374,6 +381,12 @@ static grib_context default_grib_context = {
     0,              /* classes                    */
     0,              /* lists                      */
     0,              /* expanded_descriptors       */
+    0,              /* nearest_kdtree_cache       */
+    0,              /* geometry_cache             */
+    0,              /* definitions_cache          */
+    0,              /* gaussian_latitudes_cache   */
+    {0},            /* key_refs_count             */
+    {0,},           /* key_refs                   */
     DEFAULT_FILE_POOL_MAX_OPENED_FILES /* file_pool_max_opened_files */
 #if GRIB_PTHREADS
     ,
@@ -384,8 +397,14 @@ static grib_context default_grib_context = {
 /* Hopefully big enough. Note: Definitions and samples path environment variables can contain SEVERAL colon-separated directories */
 #define ECC_PATH_MAXLEN 8192
 
+/* Set once the default context is fully initialised so that it can be returned without locking */
+static std::atomic<bool> default_grib_context_ready{false};
+
 grib_context* grib_context_get_default()
 {
+    if (default_grib_context_ready.load(std::memory_order_acquire))
+        return &default_grib_context;
+
     GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
     GRIB_MUTEX_LOCK(&mutex_c);
 
@@ -397,6 +416,13 @@ grib_context* grib_context_get_default()
         const char* gribex                              = NULL;
         const char* ieee_packing                        = NULL;
         const char* io_buffer_size                      = NULL;
+        const char* io_mmap                             = NULL;
+        const char* handle_arena                        = NULL;
+        const char* gaussian_threads                    = NULL;
+        const char* geometry_cache_size                 = NULL;
+        const char* values_cache                        = NULL;
+        const char* deferred_rebuilds                   = NULL;
+        const char* definition_cache                    = NULL;
         const char* log_stream                          = NULL;
         const char* no_big_group_split                  = NULL;
         const char* no_spd                              = NULL;
@@ -421,6 +447,13 @@ grib_context* grib_context_get_default()
         single_precision                    = getenv("ECCODES_SINGLE_PRECISION");
         file_pool_max_opened_files          = getenv("ECCODES_FILE_POOL_MAX_OPENED_FILES");
         eckit_geo                           = getenv("ECCODES_ECKIT_GEO");
+        io_mmap                             = getenv("ECCODES_IO_MMAP");
+        handle_arena                        = getenv("ECCODES_HANDLE_ARENA");
+        gaussian_threads                    = getenv("ECCODES_GAUSSIAN_THREADS");
+        geometry_cache_size                 = getenv("ECCODES_GEOMETRY_CACHE_SIZE");
+        values_cache                        = getenv("ECCODES_VALUES_CACHE");
+        deferred_rebuilds                   = getenv("ECCODES_DEFERRED_REBUILDS");
+        definition_cache                    = getenv("ECCODES_DEFINITION_CACHE");
         // The following had an equivalent env. var in grib_api
         write_on_fail                       = codes_getenv("ECCODES_GRIB_WRITE_ON_FAIL");
         large_constant_fields               = codes_getenv("ECCODES_GRIB_LARGE_CONSTANT_FIELDS");
@@ -444,6 +477,12 @@ grib_context* grib_context_get_default()
 
         default_grib_context.inited = 1;
         default_grib_context.io_buffer_size = io_buffer_size ? atoi(io_buffer_size) : 0;
+        default_grib_context.io_mmap = io_mmap ? atoi(io_mmap) : 0;
+        default_grib_context.handle_arena = handle_arena ? atoi(handle_arena) : 1;
+        default_grib_context.gaussian_threads = gaussian_threads ? atoi(gaussian_threads) : 1;
+        default_grib_context.geometry_cache_size = geometry_cache_size ? atoi(geometry_cache_size) : 256;
+        default_grib_context.values_cache = values_cache ? atoi(values_cache) : 0;
+        default_grib_context.deferred_rebuilds = deferred_rebuilds ? atoi(deferred_rebuilds) : 0;
         default_grib_context.no_big_group_split = no_big_group_split ? atoi(no_big_group_split) : 0;
         default_grib_context.no_spd = no_spd ? atoi(no_spd) : 0;
         default_grib_context.keep_matrix = keep_matrix ? atoi(keep_matrix) : 1;
@@ -562,6 +601,8 @@ grib_context* grib_context_get_default()
         default_grib_context.hash_array_index = grib_itrie_new(&(default_grib_context), &(default_grib_context.hash_array_count));
         default_grib_context.def_files = grib_trie_new(&(default_grib_context));
         default_grib_context.lists = grib_trie_new(&(default_grib_context));
+        default_grib_context.codetable_index = grib_trie_new(&(default_grib_context));
+        default_grib_context.expanded_descriptors = grib_trie_new(&(default_grib_context));
         default_grib_context.classes = grib_trie_new(&(default_grib_context));
         default_grib_context.bufrdc_mode = bufrdc_mode ? atoi(bufrdc_mode) : 0;
         default_grib_context.bufr_set_to_missing_if_out_of_range = bufr_set_to_missing_if_out_of_range ? atoi(bufr_set_to_missing_if_out_of_range) : 0;
@@ -570,6 +611,9 @@ grib_context* grib_context_get_default()
         default_grib_context.single_precision = single_precision ? atoi(single_precision) : 0;
         default_grib_context.eckit_geo = eckit_geo ? atoi(eckit_geo) : 0;
         default_grib_context.file_pool_max_opened_files = file_pool_max_opened_files ? atoi(file_pool_max_opened_files) : DEFAULT_FILE_POOL_MAX_OPENED_FILES;
+        if (definition_cache)
+            default_grib_context.definitions_cache = grib_definitions_cache_open(&default_grib_context, definition_cache);
+        default_grib_context_ready.store(true, std::memory_order_release);
     }
 
     GRIB_MUTEX_UNLOCK(&mutex_c);
@@ -714,9 +758,8 @@ char* grib_context_full_defs_path(grib_context* c, const char* basename)
         return (char*)basename;
     }
     else {
-        GRIB_MUTEX_LOCK(&mutex_c); /* See ECC-604 */
+        /* Entries are never removed so the lookup does not need mutex_c (See ECC-604) */
         fullpath = (grib_string_list*)grib_trie_get(c->def_files, basename);
-        GRIB_MUTEX_UNLOCK(&mutex_c);
         if (fullpath != NULL) {
             return fullpath->value;
         }
@@ -812,6 +855,7 @@ void grib_context_reset(grib_context* c)
             grib_context_free_persistent(c, fr->filename);
             grib_context_free_persistent(c, fr);
         }
+        grib_trie_delete_container(c->grib_reader->index);
         grib_context_free_persistent(c, c->grib_reader);
     }
 
@@ -820,6 +864,8 @@ void grib_context_reset(grib_context* c)
     if (c->codetable)
         grib_codetable_delete(c);
     c->codetable = NULL;
+    grib_trie_delete_container(c->codetable_index);
+    c->codetable_index = NULL;
 
     if (c->smart_table)
         grib_smart_table_delete(c);
@@ -844,6 +890,7 @@ void grib_context_reset(grib_context* c)
         grib_concept_value* cv = c->concepts[i];
         if (cv) {
             grib_trie_delete_container(cv->index);
+            grib_concept_match_index_delete(c, cv->match_index);
         }
         while (cv) {
             grib_concept_value* n = cv->next;
@@ -873,8 +920,16 @@ void grib_context_delete(grib_context* c)
     c->hash_array_index=0;
     grib_trie_delete_container(c->expanded_descriptors);
     c->expanded_descriptors=0;
+    grib_nearest_kdtree_cache_delete(c);
+    grib_iterator_geometry_cache_delete(c);
+    grib_gaussian_latitudes_cache_delete(c);
+    grib_key_refs_delete(c);
+    grib_definitions_cache_close(c, c->definitions_cache);
+    c->definitions_cache = NULL;
 
     c->inited = 0;
+    if (c == &default_grib_context)
+        default_grib_context_ready.store(false, std::memory_order_release);
 }
 
 void codes_bufr_multi_element_constant_arrays_on(grib_context* c)
@@ -889,6 +944,45 @@ void codes_bufr_multi_element_constant_arrays_off(grib_context* c)
         c = grib_context_get_default();
     c->bufr_multi_element_constant_arrays = 0;
 }
+
+void codes_io_mmap_on(grib_context* c)
+{
+    if (!c)
+        c = grib_context_get_default();
+    c->io_mmap = 1;
+}
+void codes_io_mmap_off(grib_context* c)
+{
+    if (!c)
+        c = grib_context_get_default();
+    c->io_mmap = 0;
+}
+
+void codes_values_cache_on(grib_context* c)
+{
+    if (!c)
+        c = grib_context_get_default();
+    c->values_cache = 1;
+}
+void codes_values_cache_off(grib_context* c)
+{
+    if (!c)
+        c = grib_context_get_default();
+    c->values_cache = 0;
+}
+
+void codes_deferred_rebuilds_on(grib_context* c)
+{
+    if (!c)
+        c = grib_context_get_default();
+    c->deferred_rebuilds = 1;
+}
+void codes_deferred_rebuilds_off(grib_context* c)
+{
+    if (!c)
+        c = grib_context_get_default();
+    c->deferred_rebuilds = 0;
+}
 /*int  codes_get_bufr_multi_element_constant_arrays(grib_context* c);*/
 
 
@@ -1156,13 +1250,15 @@ bufr_descriptors_array* grib_context_expanded_descriptors_list_get(grib_context*
     if (!c)
         c = grib_context_get_default();
 
-    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
-    GRIB_MUTEX_LOCK(&mutex_c);
-
+    /* Lists are complete when published by grib_context_expanded_descriptors_list_push
+     * so they are searched without locking */
     if (!c->expanded_descriptors) {
-        c->expanded_descriptors = (grib_trie*)grib_trie_new(c);
-        result                  = NULL;
-        goto the_end;
+        GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+        GRIB_MUTEX_LOCK(&mutex_c);
+        if (!c->expanded_descriptors)
+            c->expanded_descriptors = (grib_trie*)grib_trie_new(c);
+        GRIB_MUTEX_UNLOCK(&mutex_c);
+        return NULL;
     }
     expandedUnexpandedMapList = (bufr_descriptors_map_list*)grib_trie_get(c->expanded_descriptors, key);
     found                     = 0;
@@ -1178,20 +1274,16 @@ bufr_descriptors_array* grib_context_expanded_descriptors_list_get(grib_context*
         }
         if (found) {
             result = expandedUnexpandedMapList->expanded;
-            goto the_end;
+            break;
         }
         expandedUnexpandedMapList = expandedUnexpandedMapList->next;
     }
-the_end:
-    GRIB_MUTEX_UNLOCK(&mutex_c);
     return result;
 }
 
 void grib_context_expanded_descriptors_list_push(grib_context* c,
                                                  const char* key, bufr_descriptors_array* expanded, bufr_descriptors_array* unexpanded)
 {
-    bufr_descriptors_map_list* descriptorsList    = NULL;
-    bufr_descriptors_map_list* next               = NULL;
     bufr_descriptors_map_list* newdescriptorsList = NULL;
     if (!c)
         c = grib_context_get_default();
@@ -1199,21 +1291,13 @@ void grib_context_expanded_descriptors_list_push(grib_context* c,
     GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
     GRIB_MUTEX_LOCK(&mutex_c);
 
+    /* The new entry goes first and the trie insert publishes it complete to the readers */
     newdescriptorsList             = (bufr_descriptors_map_list*)grib_context_malloc_clear(c, sizeof(bufr_descriptors_map_list));
     newdescriptorsList->expanded   = expanded;
     newdescriptorsList->unexpanded = unexpanded;
+    newdescriptorsList->next       = (bufr_descriptors_map_list*)grib_trie_get(c->expanded_descriptors, key);
+    grib_trie_insert(c->expanded_descriptors, key, newdescriptorsList);
 
-    descriptorsList = (bufr_descriptors_map_list*)grib_trie_get(c->expanded_descriptors, key);
-    if (descriptorsList) {
-        next = descriptorsList;
-        while (next->next) {
-            next = next->next;
-        }
-        next->next = newdescriptorsList;
-    }
-    else {
-        grib_trie_insert(c->expanded_descriptors, key, newdescriptorsList);
-    }
     GRIB_MUTEX_UNLOCK(&mutex_c);
 }
 
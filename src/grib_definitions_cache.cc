@@ -0,0 +1,641 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/* Binary cache of parsed definition files
+ *
+ * Parsing the concept tables (paramId.def, shortName.def, name.def...) takes most of the time
+ * needed to decode the first message of a process. codes_compile_definitions writes them in
+ * parsed form to an image, which the default context maps at creation when the environment
+ * variable ECCODES_DEFINITION_CACHE names it.
+ *
+ * Entries are keyed on the path of the file relative to its definitions directory and carry
+ * the MD5 checksum of its contents. An entry is only used if the file found on the definitions
+ * path has the same checksum, otherwise that file is parsed as usual.
+ *
+ * Layout (native byte order, offsets from the start of the image):
+ *   header   magic, version, byte order mark, number of entries
+ *   entries  sorted on path: offset of the path, checksum, offset and size of the data
+ *   data     for each concept value its name and number of conditions, then for each
+ *            condition its key, kind and value
+ * Strings are stored as their length followed by their characters.
+ */
+
+#include "grib_api_internal.h"
+#include "expression/grib_expression_class_functor.h"
+#include "md5.h"
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifndef ECCODES_ON_WINDOWS
+#include <dirent.h>
+#include <sys/mman.h>
+#define ECC_PATH_DELIMITER_CHAR ':'
+#else
+#define ECC_PATH_DELIMITER_CHAR ';'
+#endif
+
+#define DEFS_CACHE_MAGIC     "ECCDEFS"
+#define DEFS_CACHE_VERSION   1
+#define DEFS_CACHE_BOM       0x01020304
+#define DEFS_CACHE_MD5_SIZE  32
+
+/* Kinds of condition */
+#define DEFS_CACHE_LONG      1
+#define DEFS_CACHE_DOUBLE    2
+#define DEFS_CACHE_STRING    3
+#define DEFS_CACHE_FUNCTOR   4 /* with no arguments, e.g. missing() */
+#define DEFS_CACHE_IARRAY    5
+
+typedef struct defs_cache_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t bom;
+    uint64_t count;
+} defs_cache_header;
+
+typedef struct defs_cache_entry
+{
+    uint64_t path;
+    uint64_t data;
+    uint64_t size;
+    char md5[DEFS_CACHE_MD5_SIZE];
+} defs_cache_entry;
+
+struct grib_definitions_cache
+{
+    const unsigned char* image;
+    size_t size;
+    int mapped;
+    const defs_cache_entry* entries;
+    size_t count;
+};
+
+/* ---------- Reading ---------- */
+
+typedef struct defs_cache_reader
+{
+    const unsigned char* p;
+    const unsigned char* end;
+    int err;
+} defs_cache_reader;
+
+static void read_bytes(defs_cache_reader* r, void* v, size_t n)
+{
+    if (r->err || (size_t)(r->end - r->p) < n) {
+        r->err = GRIB_DECODING_ERROR;
+        memset(v, 0, n);
+        return;
+    }
+    memcpy(v, r->p, n);
+    r->p += n;
+}
+
+static uint32_t read_u32(defs_cache_reader* r)
+{
+    uint32_t v;
+    read_bytes(r, &v, sizeof(v));
+    return v;
+}
+
+/* Returns a copy of the string in buf, or NULL if it does not fit */
+static const char* read_string(defs_cache_reader* r, char* buf, size_t buflen)
+{
+    const uint32_t len = read_u32(r);
+    if (len >= buflen) {
+        r->err = GRIB_DECODING_ERROR;
+        return NULL;
+    }
+    read_bytes(r, buf, len);
+    buf[len] = 0;
+    return r->err ? NULL : buf;
+}
+
+static grib_concept_condition* read_condition(grib_context* c, defs_cache_reader* r)
+{
+    char name[1024], sval[1024];
+    grib_expression* expression = NULL;
+    grib_iarray* iarray         = NULL;
+    int64_t lval                = 0;
+    double dval                 = 0;
+
+    if (!read_string(r, name, sizeof(name)))
+        return NULL;
+
+    unsigned char kind = 0;
+    read_bytes(r, &kind, 1);
+    switch (kind) {
+        case DEFS_CACHE_LONG:
+            read_bytes(r, &lval, sizeof(lval));
+            if (!r->err)
+                expression = new_long_expression(c, (long)lval);
+            break;
+        case DEFS_CACHE_DOUBLE:
+            read_bytes(r, &dval, sizeof(dval));
+            if (!r->err)
+                expression = new_double_expression(c, dval);
+            break;
+        case DEFS_CACHE_STRING:
+            if (read_string(r, sval, sizeof(sval)))
+                expression = new_string_expression(c, sval);
+            break;
+        case DEFS_CACHE_FUNCTOR:
+            if (read_string(r, sval, sizeof(sval)))
+                expression = new_func_expression(c, sval, NULL);
+            break;
+        case DEFS_CACHE_IARRAY: {
+            const uint32_t n = read_u32(r);
+            if (r->err || n > (size_t)(r->end - r->p) / sizeof(int64_t)) {
+                r->err = GRIB_DECODING_ERROR;
+                break;
+            }
+            iarray = grib_iarray_new(n ? n : 1, 10);
+            for (uint32_t i = 0; i < n; i++) {
+                read_bytes(r, &lval, sizeof(lval));
+                grib_iarray_push(iarray, (long)lval);
+            }
+            break;
+        }
+        default:
+            r->err = GRIB_DECODING_ERROR;
+            break;
+    }
+
+    if (r->err) {
+        grib_expression_free(c, expression);
+        if (iarray)
+            grib_iarray_delete(iarray);
+        return NULL;
+    }
+    return grib_concept_condition_new(c, name, expression, iarray);
+}
+
+static void concept_list_delete(grib_context* c, grib_concept_value* v)
+{
+    while (v) {
+        grib_concept_value* next = v->next;
+        grib_concept_value_delete(c, v);
+        v = next;
+    }
+}
+
+static grib_concept_value* read_concept(grib_context* c, const grib_definitions_cache* cache, const defs_cache_entry* e)
+{
+    grib_concept_value* first = NULL;
+    grib_concept_value* last  = NULL;
+    char name[1024];
+    defs_cache_reader r;
+
+    r.p   = cache->image + e->data;
+    r.end = r.p + e->size;
+    r.err = 0;
+
+    const uint32_t count = read_u32(&r);
+    for (uint32_t i = 0; i < count && !r.err; i++) {
+        if (!read_string(&r, name, sizeof(name)))
+            break;
+        const uint32_t nconditions       = read_u32(&r);
+        grib_concept_condition* cfirst = NULL;
+        grib_concept_condition* clast  = NULL;
+        for (uint32_t j = 0; j < nconditions && !r.err; j++) {
+            grib_concept_condition* cond = read_condition(c, &r);
+            if (!cond)
+                break;
+            if (clast)
+                clast->next = cond;
+            else
+                cfirst = cond;
+            clast = cond;
+        }
+        grib_concept_value* v = grib_concept_value_new(c, name, cfirst);
+        if (last)
+            last->next = v;
+        else
+            first = v;
+        last = v;
+    }
+
+    if (r.err || r.p != r.end) {
+        concept_list_delete(c, first);
+        return NULL;
+    }
+    return first;
+}
+
+/* MD5 checksum of the contents of a file as a hexadecimal string (33 characters with the NUL) */
+static int file_md5(const char* filename, char* digest)
+{
+    unsigned char buf[65536];
+    size_t n = 0;
+    grib_md5_state md5;
+
+    FILE* f = codes_fopen(filename, "rb");
+    if (!f)
+        return GRIB_IO_PROBLEM;
+    grib_md5_init(&md5);
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        grib_md5_add(&md5, buf, n);
+    const int err = ferror(f) ? GRIB_IO_PROBLEM : GRIB_SUCCESS;
+    fclose(f);
+    grib_md5_end(&md5, digest);
+    return err;
+}
+
+/* The path of the file relative to the definitions directory containing it */
+static const char* relative_definitions_path(grib_context* c, const char* filename)
+{
+    for (const grib_string_list* dir = c->grib_definition_files_dir; dir; dir = dir->next) {
+        const size_t len = strlen(dir->value);
+        if (strncmp(filename, dir->value, len) == 0 && filename[len] == '/')
+            return filename + len + 1;
+    }
+    return NULL;
+}
+
+static const defs_cache_entry* find_entry(const grib_definitions_cache* cache, const char* path)
+{
+    size_t lo = 0, hi = cache->count;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        const int cmp    = strcmp((const char*)cache->image + cache->entries[mid].path, path);
+        if (cmp == 0)
+            return &cache->entries[mid];
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return NULL;
+}
+
+grib_concept_value* grib_definitions_cache_get_concept(grib_context* c, const char* filename)
+{
+    const grib_definitions_cache* cache = c->definitions_cache;
+    char md5[DEFS_CACHE_MD5_SIZE + 1] = {0,};
+
+    if (!cache)
+        return NULL;
+    const char* path = relative_definitions_path(c, filename);
+    if (!path)
+        return NULL;
+    const defs_cache_entry* e = find_entry(cache, path);
+    if (!e)
+        return NULL;
+
+    if (file_md5(filename, md5) != GRIB_SUCCESS || memcmp(md5, e->md5, DEFS_CACHE_MD5_SIZE) != 0) {
+        grib_context_log(c, GRIB_LOG_DEBUG, "Definitions cache: %s has changed, parsing it", filename);
+        return NULL;
+    }
+
+    grib_concept_value* v = read_concept(c, cache, e);
+    if (!v)
+        grib_context_log(c, GRIB_LOG_ERROR, "Definitions cache: Corrupted entry for %s", path);
+    else
+        grib_context_log(c, GRIB_LOG_DEBUG, "Definitions cache: Loaded %s", path);
+    return v;
+}
+
+grib_definitions_cache* grib_definitions_cache_open(grib_context* c, const char* path)
+{
+    struct stat st;
+    void* image = NULL;
+    int mapped  = 0;
+
+    FILE* f = codes_fopen(path, "rb");
+    if (!f) {
+        grib_context_log(c, GRIB_LOG_WARNING, "Definitions cache: Unable to open %s", path);
+        return NULL;
+    }
+    if (fstat(fileno(f), &st) != 0 || st.st_size < (off_t)sizeof(defs_cache_header)) {
+        grib_context_log(c, GRIB_LOG_WARNING, "Definitions cache: %s is not a definitions cache", path);
+        fclose(f);
+        return NULL;
+    }
+    const size_t size = st.st_size;
+
+#ifndef ECCODES_ON_WINDOWS
+    image = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+    if (image == MAP_FAILED)
+        image = NULL;
+    else
+        mapped = 1;
+#endif
+    if (!image) {
+        image = grib_context_malloc_persistent(c, size);
+        if (image && fread(image, 1, size, f) != size) {
+            grib_context_free_persistent(c, image);
+            image = NULL;
+        }
+    }
+    fclose(f);
+    if (!image) {
+        grib_context_log(c, GRIB_LOG_WARNING, "Definitions cache: Unable to read %s", path);
+        return NULL;
+    }
+
+    grib_definitions_cache* cache = (grib_definitions_cache*)grib_context_malloc_clear_persistent(c, sizeof(grib_definitions_cache));
+    cache->image   = (const unsigned char*)image;
+    cache->size    = size;
+    cache->mapped  = mapped;
+    cache->entries = (const defs_cache_entry*)(cache->image + sizeof(defs_cache_header));
+
+    const defs_cache_header* h = (const defs_cache_header*)cache->image;
+    int ok = memcmp(h->magic, DEFS_CACHE_MAGIC, sizeof(DEFS_CACHE_MAGIC)) == 0 &&
+             h->version == DEFS_CACHE_VERSION && h->bom == DEFS_CACHE_BOM &&
+             h->count <= (size - sizeof(defs_cache_header)) / sizeof(defs_cache_entry);
+    for (size_t i = 0; ok && i < h->count; i++) {
+        const defs_cache_entry* e = &cache->entries[i];
+        ok = e->path < size && memchr(cache->image + e->path, 0, size - e->path) != NULL &&
+             e->data <= size && e->size <= size - e->data;
+    }
+    if (!ok) {
+        grib_context_log(c, GRIB_LOG_WARNING, "Definitions cache: %s is not a valid definitions cache (version %d)",
+                         path, DEFS_CACHE_VERSION);
+        grib_definitions_cache_close(c, cache);
+        return NULL;
+    }
+    cache->count = h->count;
+
+    grib_context_log(c, GRIB_LOG_DEBUG, "Definitions cache: Using %s (%zu files)", path, cache->count);
+    return cache;
+}
+
+void grib_definitions_cache_close(grib_context* c, grib_definitions_cache* cache)
+{
+    if (!cache)
+        return;
+#ifndef ECCODES_ON_WINDOWS
+    if (cache->mapped)
+        munmap((void*)cache->image, cache->size);
+    else
+#endif
+        grib_context_free_persistent(c, (void*)cache->image);
+    grib_context_free_persistent(c, cache);
+}
+
+/* ---------- Writing ---------- */
+
+static void write_bytes(std::string& out, const void* v, size_t n)
+{
+    out.append((const char*)v, n);
+}
+
+static void write_u32(std::string& out, uint32_t v)
+{
+    write_bytes(out, &v, sizeof(v));
+}
+
+static void write_string(std::string& out, const char* s)
+{
+    const size_t len = strlen(s);
+    write_u32(out, (uint32_t)len);
+    write_bytes(out, s, len);
+}
+
+/* Only the constant expressions found in concept tables can be stored */
+static int write_condition(std::string& out, const grib_concept_condition* cond)
+{
+    const grib_expression* e = cond->expression;
+    unsigned char kind       = 0;
+    int err                  = 0;
+
+    write_string(out, cond->name);
+    if (!e) {
+        kind = DEFS_CACHE_IARRAY;
+        write_bytes(out, &kind, 1);
+        const size_t n = cond->iarray ? cond->iarray->n : 0;
+        write_u32(out, (uint32_t)n);
+        for (size_t i = 0; i < n; i++) {
+            const int64_t v = cond->iarray->v[i];
+            write_bytes(out, &v, sizeof(v));
+        }
+    }
+    else if (STR_EQUAL(e->class_name(), "long")) {
+        long lval = 0;
+        e->evaluate_long(NULL, &lval);
+        const int64_t v = lval;
+        kind            = DEFS_CACHE_LONG;
+        write_bytes(out, &kind, 1);
+        write_bytes(out, &v, sizeof(v));
+    }
+    else if (STR_EQUAL(e->class_name(), "double")) {
+        double v = 0;
+        e->evaluate_double(NULL, &v);
+        kind = DEFS_CACHE_DOUBLE;
+        write_bytes(out, &kind, 1);
+        write_bytes(out, &v, sizeof(v));
+    }
+    else if (STR_EQUAL(e->class_name(), "string")) {
+        size_t len    = 0;
+        const char* v = e->evaluate_string(NULL, NULL, &len, &err);
+        kind          = DEFS_CACHE_STRING;
+        write_bytes(out, &kind, 1);
+        write_string(out, v);
+    }
+    else if (STR_EQUAL(e->class_name(), "functor") &&
+             ((const eccodes::expression::Functor*)e)->args() == NULL) {
+        kind = DEFS_CACHE_FUNCTOR;
+        write_bytes(out, &kind, 1);
+        write_string(out, ((eccodes::expression::Functor*)e)->name());
+    }
+    else {
+        return GRIB_NOT_IMPLEMENTED;
+    }
+    return err;
+}
+
+static int write_concept(std::string& out, const grib_concept_value* concept)
+{
+    uint32_t count = 0;
+    for (const grib_concept_value* v = concept; v; v = v->next)
+        count++;
+    write_u32(out, count);
+
+    for (const grib_concept_value* v = concept; v; v = v->next) {
+        uint32_t nconditions = 0;
+        for (const grib_concept_condition* e = v->conditions; e; e = e->next)
+            nconditions++;
+        write_string(out, v->name);
+        write_u32(out, nconditions);
+        for (const grib_concept_condition* e = v->conditions; e; e = e->next) {
+            int err = write_condition(out, e);
+            if (err)
+                return err;
+        }
+    }
+    return GRIB_SUCCESS;
+}
+
+/* Concept tables start with a value name followed by '=' and '{' */
+static bool looks_like_concept_file(const char* filename)
+{
+    char buf[1024];
+    FILE* f = codes_fopen(filename, "r");
+    if (!f)
+        return false;
+
+    bool result = false;
+    while (fgets(buf, sizeof(buf), f)) {
+        const char* p = buf;
+        while (isspace(*p))
+            p++;
+        if (*p == 0 || *p == '#')
+            continue;
+        if (*p == '\'' || *p == '"') {
+            const char* q = strchr(p + 1, *p);
+            p             = q ? q + 1 : p + strlen(p);
+        }
+        else {
+            while (isalnum(*p) || *p == '_' || *p == '.' || *p == '-')
+                p++;
+        }
+        while (isspace(*p))
+            p++;
+        if (*p++ == '=') {
+            while (isspace(*p))
+                p++;
+            result = (*p == '{');
+        }
+        break;
+    }
+    fclose(f);
+    return result;
+}
+
+#ifndef ECCODES_ON_WINDOWS
+/* Relative paths of all the .def files below dir */
+static void list_definition_files(const std::string& dir, const std::string& rel, std::vector<std::string>& files)
+{
+    DIR* d = opendir(rel.empty() ? dir.c_str() : (dir + "/" + rel).c_str());
+    if (!d)
+        return;
+    struct dirent* de = NULL;
+    while ((de = readdir(d)) != NULL) {
+        const std::string name = de->d_name;
+        if (name == "." || name == "..")
+            continue;
+        const std::string path = rel.empty() ? name : rel + "/" + name;
+        const std::string full = dir + "/" + path;
+        struct stat st;
+        if (stat(full.c_str(), &st) != 0)
+            continue;
+        if (S_ISDIR(st.st_mode))
+            list_definition_files(dir, path, files);
+        else if (S_ISREG(st.st_mode) && name.size() > 4 && name.compare(name.size() - 4, 4, ".def") == 0)
+            files.push_back(path);
+    }
+    closedir(d);
+}
+#endif
+
+int grib_definitions_cache_compile(grib_context* c, const char* path, size_t* count)
+{
+#ifdef ECCODES_ON_WINDOWS
+    grib_context_log(c, GRIB_LOG_ERROR, "%s: Not supported on Windows", __func__);
+    return GRIB_NOT_IMPLEMENTED;
+#else
+    std::vector<std::string> dirs;
+    std::vector<std::pair<std::string, std::string> > files; /* relative and full path */
+    std::set<std::string> seen;
+    std::vector<defs_cache_entry> entries;
+    std::string strings, data;
+
+    if (!c)
+        c = grib_context_get_default();
+    if (!c->grib_definition_files_path)
+        return GRIB_NO_DEFINITIONS;
+    *count = 0;
+
+    const std::string defs_path = c->grib_definition_files_path;
+    size_t start = 0;
+    while (start <= defs_path.size()) {
+        size_t end = defs_path.find(ECC_PATH_DELIMITER_CHAR, start);
+        if (end == std::string::npos)
+            end = defs_path.size();
+        if (end > start)
+            dirs.push_back(defs_path.substr(start, end - start));
+        start = end + 1;
+    }
+
+    /* As when looking up definition files, the first directory has precedence */
+    for (const std::string& dir : dirs) {
+        std::vector<std::string> rels;
+        list_definition_files(dir, "", rels);
+        for (const std::string& rel : rels) {
+            if (seen.insert(rel).second)
+                files.emplace_back(rel, dir + "/" + rel);
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    for (const auto& file : files) {
+        const char* full = file.second.c_str();
+        if (!looks_like_concept_file(full))
+            continue;
+
+        grib_concept_value* concept = grib_parse_concept_file(c, full);
+        if (!concept)
+            continue;
+
+        defs_cache_entry e = {0,};
+        char md5[DEFS_CACHE_MD5_SIZE + 1] = {0,};
+        const size_t offset = data.size();
+        if (write_concept(data, concept) != GRIB_SUCCESS || file_md5(full, md5) != GRIB_SUCCESS) {
+            grib_context_log(c, GRIB_LOG_DEBUG, "Definitions cache: Cannot store %s", full);
+            data.resize(offset);
+        }
+        else {
+            memcpy(e.md5, md5, DEFS_CACHE_MD5_SIZE);
+            e.path = strings.size();
+            e.data = offset;
+            e.size = data.size() - offset;
+            strings.append(file.first.c_str(), file.first.size() + 1);
+            entries.push_back(e);
+        }
+        concept_list_delete(c, concept);
+    }
+
+    defs_cache_header header = {{0,},};
+    memcpy(header.magic, DEFS_CACHE_MAGIC, sizeof(DEFS_CACHE_MAGIC));
+    header.version = DEFS_CACHE_VERSION;
+    header.bom     = DEFS_CACHE_BOM;
+    header.count   = entries.size();
+
+    const uint64_t strings_offset = sizeof(header) + entries.size() * sizeof(defs_cache_entry);
+    const uint64_t data_offset    = strings_offset + strings.size();
+    for (defs_cache_entry& e : entries) {
+        e.path += strings_offset;
+        e.data += data_offset;
+    }
+
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        grib_context_log(c, GRIB_LOG_ERROR | GRIB_LOG_PERROR, "Definitions cache: Unable to create %s", path);
+        return GRIB_IO_PROBLEM;
+    }
+    int err = GRIB_SUCCESS;
+    if (fwrite(&header, sizeof(header), 1, f) != 1 ||
+        (!entries.empty() && fwrite(entries.data(), sizeof(defs_cache_entry), entries.size(), f) != entries.size()) ||
+        fwrite(strings.data(), 1, strings.size(), f) != strings.size() ||
+        fwrite(data.data(), 1, data.size(), f) != data.size())
+        err = GRIB_IO_PROBLEM;
+    if (fclose(f) != 0)
+        err = GRIB_IO_PROBLEM;
+    if (err) {
+        grib_context_log(c, GRIB_LOG_ERROR | GRIB_LOG_PERROR, "Definitions cache: Unable to write %s", path);
+        return err;
+    }
+
+    *count = entries.size();
+    return GRIB_SUCCESS;
+#endif
+}
@@ -40,6 +40,9 @@ static grib_handle* handle_of(grib_accessor* observed)
     return h;
 }
 
+/* The dependencies on an accessor are chained from it (observers_) and those of an accessor from it
+ * (observing_), so that adding, notifying and removing only visit the dependencies involved.
+ * All are also chained from the handle, which owns them */
 void grib_dependency_add(grib_accessor* observer, grib_accessor* observed)
 {
     grib_handle* h        = NULL;
@@ -55,125 +58,148 @@ void grib_dependency_add(grib_accessor* observer, grib_accessor* observed)
         return;
     }
     h = handle_of(observed);
-    d = h->dependencies;
+    d = observed->observers_;
 
     /* ECCODES_ASSERT(h == handle_of(observer)); */
 
     /* Check if already in list */
     while (d) {
-        if (d->observer == observer && d->observed == observed)
+        if (d->observer == observer)
             return;
         last = d;
-        d    = d->next;
+        d    = d->next_observer;
     }
 
-//     d = h->dependencies;
-//     while(d)
-//     {
-//         last = d;
-//         d = d->next;
-//     }
-
-    d = (grib_dependency*)grib_context_malloc_clear(h->context, sizeof(grib_dependency));
+    d = (grib_dependency*)grib_arena_malloc_clear(grib_handle_arena(h), sizeof(grib_dependency));
     ECCODES_ASSERT(d);
 
     d->observed = observed;
     d->observer = observer;
-    d->next     = 0;
 
     //printf("observe %p %p %s %s\n",(void*)observed,(void*)observer, observed->name,observer->name);
-//     d->next     = h->dependencies;
-//     h->dependencies = d;
 
+    /* Observers are notified in the order they were added */
     if (last)
-        last->next = d;
+        last->next_observer = d;
     else
-        h->dependencies = d;
+        observed->observers_ = d;
+
+    d->next_observed     = observer->observing_;
+    observer->observing_ = d;
+
+    d->next         = h->dependencies;
+    h->dependencies = d;
 }
 
 void grib_dependency_remove_observed(grib_accessor* observed)
 {
-    grib_handle* h     = handle_of(observed);
-    grib_dependency* d = h->dependencies;
+    grib_dependency* d = observed->observers_;
     /* printf("%s\n",observed->name); */
 
     while (d) {
-        if (d->observed == observed) {
-            /*  TODO: Notify observer...*/
-            d->observed = 0; /*printf("grib_dependency_remove_observed %s\n",observed->name); */
-        }
-        d = d->next;
+        /*  TODO: Notify observer...*/
+        d->observed = 0; /*printf("grib_dependency_remove_observed %s\n",observed->name); */
+        d = d->next_observer;
     }
+    observed->observers_ = NULL;
+}
+
+/* Invalidate values cached by accessors of the handle (e.g. concepts).
+ * Done both before and after the observers run as they may change other keys without notification */
+static void handle_changed(grib_handle* h)
+{
+    while (h->main)
+        h = h->main;
+    h->change_count++;
+}
+
+/* Whether values cached against h->change_count can be trusted. The count is only kept on
+ * the main handle, and handles with a main or a kid are being rebuilt (see action_class_section.cc):
+ * their keys are then changed without notification */
+int grib_handle_change_count_valid(const grib_handle* h)
+{
+    return !h->main && !h->kid;
 }
 
 /* TODO: Notification must go from outer blocks to inner block */
 
-int grib_dependency_notify_change(grib_accessor* observed)
+/* Dependencies are never freed before the handle, so that the list can still be followed
+ * if observers are removed while notified */
+static int notify_observers(grib_handle* h, grib_accessor* observed)
 {
-    grib_handle* h     = handle_of(observed);
-    grib_dependency* d = h->dependencies;
+    grib_dependency* d = observed->observers_;
     int ret            = GRIB_SUCCESS;
 
+    handle_changed(h);
+
     /*Do a two pass mark&sweep, in case some dependencies are added while we notify*/
     while (d) {
         d->run = (d->observed == observed && d->observer != 0);
-        d      = d->next;
+        d      = d->next_observer;
     }
 
-    d = h->dependencies;
+    d = observed->observers_;
     while (d) {
         if (d->run) {
             /*printf("grib_dependency_notify_change %s %s %p\n", observed->name, d->observer ? d->observer->name : "?", (void*)d->observer);*/
             if (d->observer && (ret = d->observer->notify_change(observed)) != GRIB_SUCCESS)
-                return ret;
+                break;
         }
-        d = d->next;
+        d = d->next_observer;
     }
+    handle_changed(h);
     return ret;
 }
 
+int grib_dependency_notify_change(grib_accessor* observed)
+{
+    return notify_observers(handle_of(observed), observed);
+}
+
 /* This version takes in the handle so does not need to work it out from the 'observed' */
 /* See ECC-778 */
 int grib_dependency_notify_change_h(grib_handle* h, grib_accessor* observed)
 {
-    grib_dependency* d = h->dependencies;
-    int ret            = GRIB_SUCCESS;
-
-    /*Do a two pass mark&sweep, in case some dependencies are added while we notify*/
-    while (d) {
-        d->run = (d->observed == observed && d->observer != 0);
-        d      = d->next;
-    }
+    return notify_observers(h, observed);
+}
 
-    d = h->dependencies;
-    while (d) {
-        if (d->run) {
-            /*printf("grib_dependency_notify_change %s %s %p\n",observed->name,d->observer ? d->observer->name : "?", (void*)d->observer);*/
-            if (d->observer && (ret = d->observer->notify_change(observed)) != GRIB_SUCCESS)
-                return ret;
-        }
-        d = d->next;
-    }
-    return ret;
+static void remove_deferred_rebuild(grib_handle* h, size_t i)
+{
+    h->deferred_count--;
+    for (; i < h->deferred_count; i++)
+        h->deferred[i] = h->deferred[i + 1];
 }
 
 void grib_dependency_remove_observer(grib_accessor* observer)
 {
-    grib_handle* h     = NULL;
     grib_dependency* d = NULL;
+    grib_handle* h     = NULL;
 
     if (!observer)
         return;
 
+    /* Nor is a section rebuild waiting for it run */
     h = handle_of(observer);
-    d = h->dependencies;
+    for (size_t i = h->deferred_count; i > 0; i--) {
+        if (h->deferred[i - 1].notified == observer)
+            remove_deferred_rebuild(h, i - 1);
+    }
 
+    d = observer->observing_;
     while (d) {
-        if (d->observer == observer) {
-            d->observer = 0;
+        /* Unlink from the observers of the accessor observed, keeping the link to the next
+         * one for a notification which may be going through it */
+        if (d->observed) {
+            grib_dependency** p = &d->observed->observers_;
+            while (*p && *p != d)
+                p = &(*p)->next_observer;
+            if (*p)
+                *p = d->next_observer;
         }
-        d = d->next;
+        d->observer = 0;
+        d           = d->next_observed;
     }
+    observer->observing_ = NULL;
 }
 
 void grib_dependency_observe_expression(grib_accessor* observer, grib_expression* e)
@@ -188,3 +214,141 @@ void grib_dependency_observe_arguments(grib_accessor* observer, grib_arguments*
         a = a->next_;
     }
 }
+
+/* Section rebuilds are held back while several values are set at once (see grib_set_values_silent),
+ * so that a section is rebuilt once whatever the number of keys it depends on in the batch.
+ * Only the rebuilds triggered by the keys of the batch themselves are deferred, when nothing else
+ * depends on them: keys set by the definitions in the meantime expect the new sections.
+ * They are kept on the handle by level of grib_set_values and run when the level has applied its values */
+int grib_dependency_defer_rebuild(grib_accessor* notified, grib_accessor* changed)
+{
+    grib_handle* h = handle_of(notified);
+    size_t i       = 0;
+
+    if (!h->defer_rebuilds || h->defer_rebuilds != h->values_stack || h->deferred_key != changed || h->kid)
+        return 0;
+
+    for (i = 0; i < h->deferred_count; i++) {
+        if (h->deferred[i].notified == notified && h->deferred[i].level == h->values_stack) {
+            /* A change of edition is handled differently by the rebuild */
+            if (!strcmp(changed->name_, "GRIBEditionNumber"))
+                h->deferred[i].changed = changed->name_;
+            return 1;
+        }
+    }
+    if (h->deferred_count == MAX_DEFERRED_REBUILDS)
+        return 0;
+
+    h->deferred[h->deferred_count].notified = notified;
+    h->deferred[h->deferred_count].changed  = changed->name_;
+    h->deferred[h->deferred_count].level    = h->values_stack;
+    h->deferred_count++;
+    return 1;
+}
+
+static int section_contains(const grib_section* s, const grib_accessor* a)
+{
+    const grib_section* p = a->parent_;
+    while (p) {
+        if (p == s)
+            return 1;
+        p = p->owner ? p->owner->parent_ : NULL;
+    }
+    return 0;
+}
+
+/* Only sections depend on the key */
+static int is_structural(const grib_accessor* a)
+{
+    const grib_dependency* d = a->observers_;
+    int found                = 0;
+
+    for (; d; d = d->next_observer) {
+        if (d->observer) {
+            if (!d->observer->sub_section_)
+                return 0;
+            found = 1;
+        }
+    }
+    return found;
+}
+
+/* Called before a key of the current level of grib_set_values is set. Returns 1 if the key must wait
+ * for the rebuilds deferred so far: meanwhile only other structural keys outside of the sections to
+ * rebuild are set, the others could be set differently once the sections have changed (e.g. bitsPerValue
+ * after packingType). Otherwise the rebuilds the key triggers are deferred if it is structural */
+int grib_dependency_defer_set(grib_handle* h, const char* name)
+{
+    grib_accessor* a = grib_find_accessor(h, name);
+    int pending      = 0;
+
+    h->deferred_key = NULL;
+    for (size_t i = 0; i < h->deferred_count; i++) {
+        if (h->deferred[i].level == h->values_stack) {
+            pending = 1;
+            if (a && section_contains(h->deferred[i].notified->sub_section_, a))
+                return 1;
+        }
+    }
+    if (a && is_structural(a))
+        h->deferred_key = a;
+    else if (pending)
+        return 1;
+
+    return 0;
+}
+
+/* Returns 1 if rebuilds are waiting for the current level of grib_set_values to apply its values */
+int grib_dependency_deferred_pending(const grib_handle* h)
+{
+    for (size_t i = 0; i < h->deferred_count; i++) {
+        if (h->deferred[i].level == h->values_stack)
+            return 1;
+    }
+    return 0;
+}
+
+/* Run the rebuilds deferred at a level, outer sections first: those inside are rebuilt with them */
+int grib_dependency_run_deferred_rebuilds(grib_handle* h, int level, size_t* count)
+{
+    int err   = GRIB_SUCCESS;
+    int saved = h->defer_rebuilds;
+
+    *count            = 0;
+    h->defer_rebuilds = 0;
+    h->deferred_key   = NULL;
+    while (err == GRIB_SUCCESS) {
+        grib_deferred_rebuild r;
+        grib_accessor* changed = NULL;
+        size_t next            = h->deferred_count;
+
+        for (size_t i = 0; i < h->deferred_count && next == h->deferred_count; i++) {
+            if (h->deferred[i].level != level)
+                continue;
+            next = i;
+            for (size_t j = 0; j < h->deferred_count; j++) {
+                if (j != i && h->deferred[j].level == level &&
+                    section_contains(h->deferred[j].notified->sub_section_, h->deferred[i].notified)) {
+                    next = h->deferred_count;
+                    break;
+                }
+            }
+        }
+        if (next == h->deferred_count)
+            break;
+
+        r = h->deferred[next];
+        remove_deferred_rebuild(h, next);
+        changed = grib_find_accessor(h, r.changed);
+        err     = r.notified->notify_change(changed ? changed : r.notified);
+        (*count)++;
+    }
+
+    /* Nothing is left behind on failure */
+    for (size_t i = h->deferred_count; i > 0; i--) {
+        if (h->deferred[i - 1].level == level)
+            remove_deferred_rebuild(h, i - 1);
+    }
+    h->defer_rebuilds = saved;
+    return err;
+}
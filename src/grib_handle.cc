@@ -37,14 +37,27 @@ static GRIB_INLINE int grib_inline_strcmp(const char* a, const char* b)
 
 grib_section* grib_section_create(grib_handle* h, grib_accessor* owner)
 {
-    grib_section* s = (grib_section*)grib_context_malloc_clear(h->context, sizeof(grib_section));
-    s->owner        = owner;
-    s->aclength     = NULL;
-    s->h            = h;
-    s->block        = (grib_block_of_accessors*)grib_context_malloc_clear(h->context, sizeof(grib_block_of_accessors));
+    grib_arena* arena = grib_handle_arena(h);
+    grib_section* s   = (grib_section*)grib_arena_malloc_clear(arena, sizeof(grib_section));
+    s->owner          = owner;
+    s->aclength       = NULL;
+    s->h              = h;
+    s->block          = (grib_block_of_accessors*)grib_arena_malloc_clear(arena, sizeof(grib_block_of_accessors));
     return s;
 }
 
+/* The arena holding the accessors, sections and dependencies of a handle.
+ * Handles created while reparsing (see action_class_section.cc) share the arena of their main handle
+ * as their sections are swapped into it. NULL if disabled (ECCODES_HANDLE_ARENA=0) */
+grib_arena* grib_handle_arena(grib_handle* h)
+{
+    while (h->main)
+        h = h->main;
+    if (!h->arena && h->context->handle_arena)
+        h->arena = grib_arena_new(h->context);
+    return h->arena;
+}
+
 static void update_sections(grib_section* s, grib_handle* h, long offset)
 {
     grib_accessor* a = s ? s->block->first : NULL;
@@ -111,9 +124,9 @@ void grib_section_delete(grib_context* c, grib_section* b)
         return;
 
     grib_empty_section(c, b);
-    grib_context_free(c, b->block);
+    grib_arena_free(b->block);
     /* printf("++++ deleted %p\n",b); */
-    grib_context_free(c, b);
+    grib_arena_free(b);
 }
 
 int grib_handle_delete(grib_handle* h)
@@ -126,16 +139,25 @@ int grib_handle_delete(grib_handle* h)
         if (h->kid != NULL)
             return GRIB_INTERNAL_ERROR;
 
+        /* The accessors still alive are deleted after the dependencies they are chained to */
         while (d) {
             n = d->next;
-            grib_context_free(ct, d);
+            if (d->observed)
+                d->observed->observers_ = NULL;
+            if (d->observer)
+                d->observer->observing_ = NULL;
+            grib_arena_free(d);
             d = n;
         }
         h->dependencies = 0;
 
+        grib_values_cache_delete(h);
         grib_buffer_delete(ct, h->buffer);
         grib_section_delete(ct, h->root);
+        grib_arena_delete(h->arena);
         grib_context_free(ct, h->gts_header);
+        if (h->mapped_file)
+            grib_mapped_file_release(ct, h->mapped_file);
 
         grib_context_log(ct, GRIB_LOG_DEBUG, "grib_handle_delete: deleting handle %p", (void*)h);
         grib_context_free(ct, h);
@@ -1162,6 +1184,58 @@ grib_handle* any_new_from_file(grib_context* c, FILE* f, int* error)
     return gl;
 }
 
+// The message is used in place in a mapping of the file. Sets mapped to 0 if the
+// message has to be read into a buffer instead
+static grib_handle* grib_handle_new_from_file_mmap(grib_context* c, FILE* f, int* mapped, int* error)
+{
+    const unsigned char* data = NULL;
+    size_t olen               = 0;
+    off_t offset              = 0;
+    grib_handle* gl           = NULL;
+    grib_mapped_file* m       = NULL;
+    off_t start               = grib_context_tell(c, f);
+
+    *mapped = 0;
+    m       = grib_mapped_file_acquire(c, f);
+    if (!m)
+        return NULL;
+
+    *mapped = 1;
+    *error  = wmo_read_grib_from_file_fast(f, &olen, &offset);
+    if (*error != GRIB_SUCCESS) {
+        grib_mapped_file_release(c, m);
+        if (*error == GRIB_END_OF_FILE)
+            *error = GRIB_SUCCESS;
+        return NULL;
+    }
+
+    data = grib_mapped_file_claim(m, offset, olen);
+    if (!data) {
+        // Already served from this mapping (e.g. the file was rewound): read it again
+        grib_mapped_file_release(c, m);
+        grib_context_seek(c, start, SEEK_SET, f);
+        *mapped = 0;
+        return NULL;
+    }
+
+    gl = grib_handle_new_from_message(c, data, olen);
+    if (!gl) {
+        *error = GRIB_DECODING_ERROR;
+        grib_context_log(c, GRIB_LOG_ERROR, "%s: Cannot create handle", __func__);
+        grib_mapped_file_release(c, m);
+        return NULL;
+    }
+
+    gl->offset      = offset;
+    gl->mapped_file = m;
+    gl->gts_header  = NULL;
+
+    grib_context_increment_handle_file_count(c);
+    grib_context_increment_handle_total_count(c);
+
+    return gl;
+}
+
 static grib_handle* grib_handle_new_from_file_no_multi(grib_context* c, FILE* f, int headers_only, int* error)
 {
     void* data              = NULL;
@@ -1175,6 +1249,13 @@ static grib_handle* grib_handle_new_from_file_no_multi(grib_context* c, FILE* f,
     if (c == NULL)
         c = grib_context_get_default();
 
+    if (c->io_mmap && !headers_only && !c->gts_header_on) {
+        int mapped = 0;
+        gl         = grib_handle_new_from_file_mmap(c, f, &mapped, error);
+        if (mapped)
+            return gl;
+    }
+
     gts_header_offset = grib_context_tell(c, f);
     data              = wmo_read_grib_from_file_malloc(f, headers_only, &olen, &offset, error);
     end_msg_offset    = grib_context_tell(c, f);
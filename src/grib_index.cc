@@ -11,6 +11,10 @@
 #include "grib_api_internal.h"
 #include <map>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #define UNDEF_LONG   -99999
 #define UNDEF_DOUBLE -99999
@@ -66,6 +70,80 @@ static long values_count = 0;
 
 static int codes_index_add_file_internal(grib_index* index, const char* filename, int message_type);
 
+/* Hash tables over the field tree and the values of the keys, so that adding a message
+ * or selecting a field does not walk the list of each level with strcmp.
+ * The strings are those of the tree and of the keys: nothing is copied */
+struct grib_index_lookup
+{
+    struct NodeKey
+    {
+        const grib_field_tree* head; /* first node of the list of a level */
+        std::string_view value;
+        bool operator==(const NodeKey& other) const { return head == other.head && value == other.value; }
+    };
+    struct NodeKeyHash
+    {
+        size_t operator()(const NodeKey& k) const
+        {
+            return std::hash<std::string_view>()(k.value) ^ (std::hash<const void*>()(k.head) * 31);
+        }
+    };
+
+    std::unordered_map<NodeKey, grib_field_tree*, NodeKeyHash> nodes;
+    std::unordered_map<const grib_field_tree*, grib_field_tree*> last_node; /* by head of list */
+    std::unordered_map<const grib_field_tree*, grib_field*> last_field;     /* by node */
+    std::vector<std::unordered_set<std::string_view>> values;              /* by key */
+    std::vector<grib_string_list*> last_value;                             /* by key */
+};
+
+static void grib_index_lookup_add_level(grib_index_lookup* lookup, grib_field_tree* head)
+{
+    for (grib_field_tree* node = head; node; node = node->next) {
+        if (node->value)
+            lookup->nodes.emplace(grib_index_lookup::NodeKey{ head, node->value }, node); /* first one wins */
+        if (node->next_level)
+            grib_index_lookup_add_level(lookup, node->next_level);
+        lookup->last_node[head] = node;
+    }
+}
+
+/* Tables are built from the tree the first time they are needed, whether the index
+ * was created from messages or read from a file */
+static grib_index_lookup* grib_index_lookup_get(grib_index* index)
+{
+    if (index->lookup)
+        return index->lookup;
+
+    grib_index_lookup* lookup = new grib_index_lookup();
+    if (index->fields)
+        grib_index_lookup_add_level(lookup, index->fields);
+    for (grib_index_key* key = index->keys; key; key = key->next) {
+        grib_string_list* last = key->values;
+        lookup->values.emplace_back();
+        for (grib_string_list* v = key->values; v; v = v->next) {
+            if (v->value)
+                lookup->values.back().insert(v->value);
+            last = v;
+        }
+        lookup->last_value.push_back(last);
+    }
+    index->lookup = lookup;
+    return lookup;
+}
+
+/* Tables must be dropped when the tree or the keys change other than through them */
+static void grib_index_lookup_delete(grib_index* index)
+{
+    delete index->lookup;
+    index->lookup = NULL;
+}
+
+static grib_field_tree* grib_index_lookup_find(const grib_index_lookup* lookup, const grib_field_tree* head, const char* value)
+{
+    auto it = lookup->nodes.find(grib_index_lookup::NodeKey{ head, value });
+    return it == lookup->nodes.end() ? NULL : it->second;
+}
+
 static char* get_key(char** keys, int* type)
 {
     char* key = NULL;
@@ -221,6 +299,7 @@ int grib_index_compress(grib_index* index)
     if (!index->keys->next)
         return 0;
 
+    grib_index_lookup_delete(index);
     err = grib_index_keys_compress(c, index, compress);
     if (err) return err;
 
@@ -761,6 +840,7 @@ static void grib_field_list_delete(grib_context* c, grib_field_list* field_list)
 void grib_index_delete(grib_index* index)
 {
     grib_file* file = index->files;
+    grib_index_lookup_delete(index);
     grib_index_key_delete(index->context, index->keys);
     grib_field_tree_delete(index->context, index->fields);
     grib_field_list_delete(index->context, index->fieldset);
@@ -1082,13 +1162,16 @@ static int codes_index_add_file_internal(grib_index* index, const char* filename
     grib_handle* h            = NULL;
     grib_field* field;
     grib_field_tree* field_tree;
+    grib_field_tree* level;
+    grib_index_lookup* lookup;
     grib_file* file = NULL;
     grib_context* c;
     bool warn_about_duplicates = true;
 
     if (!index)
         return GRIB_NULL_INDEX;
-    c = index->context;
+    c      = index->context;
+    lookup = grib_index_lookup_get(index);
 
     file = grib_file_open(filename, "r", &err);
 
@@ -1126,8 +1209,10 @@ static int codes_index_add_file_internal(grib_index* index, const char* filename
     std::map<off_t, grib_handle*> map_of_offsets;
     while ((h = new_message_from_file(message_type, c, file->handle, &err)) != NULL) {
         grib_string_list* v = 0;
+        size_t ikey         = 0;
         index_key           = index->keys;
-        field_tree          = index->fields;
+        level               = index->fields;
+        field_tree          = NULL;
         index_key->value[0] = 0;
         message_count++;
 
@@ -1201,49 +1286,44 @@ static int codes_index_add_file_internal(grib_index* index, const char* filename
                 return err;
             }
 
-            if (!index_key->values->value) {
-                index_key->values->value = grib_context_strdup(c, buf);
-                index_key->values_count++;
-            }
-            else {
-                v = index_key->values;
-                while (v->next && strcmp(v->value, buf))
-                    v = v->next;
-                if (strcmp(v->value, buf)) {
-                    index_key->values_count++;
-                    if (v->next)
-                        v = v->next;
-                    v->next        = (grib_string_list*)grib_context_malloc_clear(c, sizeof(grib_string_list));
-                    v->next->value = grib_context_strdup(c, buf);
+            if (lookup->values[ikey].count(buf) == 0) {
+                /* New value for this key: append it to the list */
+                v = lookup->last_value[ikey];
+                if (v->value) {
+                    v->next = (grib_string_list*)grib_context_malloc_clear(c, sizeof(grib_string_list));
+                    v       = v->next;
+                    lookup->last_value[ikey] = v;
                 }
+                v->value = grib_context_strdup(c, buf);
+                index_key->values_count++;
+                lookup->values[ikey].insert(v->value);
             }
 
-            if (!field_tree->value) {
-                field_tree->value = grib_context_strdup(c, buf);
-            }
-            else {
-                while (field_tree->next &&
-                       (field_tree->value == NULL ||
-                        strcmp(field_tree->value, buf)))
-                    field_tree = field_tree->next;
-
-                if (!field_tree->value || strcmp(field_tree->value, buf)) {
+            field_tree = grib_index_lookup_find(lookup, level, buf);
+            if (!field_tree) {
+                /* New value at this level of the tree: append a node to the list */
+                field_tree = lookup->last_node[level];
+                if (field_tree->value) {
                     field_tree->next =
                         (grib_field_tree*)grib_context_malloc_clear(c,
                                                                     sizeof(grib_field_tree));
-                    field_tree        = field_tree->next;
-                    field_tree->value = grib_context_strdup(c, buf);
+                    field_tree              = field_tree->next;
+                    lookup->last_node[level] = field_tree;
                 }
+                field_tree->value = grib_context_strdup(c, buf);
+                lookup->nodes.emplace(grib_index_lookup::NodeKey{ level, field_tree->value }, field_tree);
             }
 
             if (index_key->next) {
                 if (!field_tree->next_level) {
                     field_tree->next_level =
                         (grib_field_tree*)grib_context_malloc_clear(c, sizeof(grib_field_tree));
+                    lookup->last_node[field_tree->next_level] = field_tree->next_level;
                 }
-                field_tree = field_tree->next_level;
+                level = field_tree->next_level;
             }
             index_key = index_key->next;
+            ikey++;
         }
 
         field       = (grib_field*)grib_context_malloc_clear(c, sizeof(grib_field));
@@ -1268,14 +1348,19 @@ static int codes_index_add_file_internal(grib_index* index, const char* filename
             return err;
         field->length = length;
 
-        if (field_tree->field) {
-            grib_field* pfield = field_tree->field;
-            while (pfield->next)
-                pfield = pfield->next;
-            pfield->next = field;
+        {
+            grib_field*& last = lookup->last_field[field_tree];
+            if (!last && field_tree->field) {
+                last = field_tree->field;
+                while (last->next)
+                    last = last->next;
+            }
+            if (last)
+                last->next = field;
+            else
+                field_tree->field = field;
+            last = field;
         }
-        else
-            field_tree->field = field;
 
         grib_handle_delete(h);
     }/*foreach message*/
@@ -1709,10 +1794,12 @@ static int grib_index_execute(grib_index* index)
 {
     grib_index_key* keys = NULL;
     grib_field_tree* fields;
+    const grib_index_lookup* lookup;
 
     if (!index)
         return GRIB_INTERNAL_ERROR;
-    keys = index->keys;
+    keys   = index->keys;
+    lookup = grib_index_lookup_get(index);
 
     fields        = index->fields;
     index->rewind = 0;
@@ -1728,9 +1815,8 @@ static int grib_index_execute(grib_index* index)
             return GRIB_NOT_FOUND;
         }
 
-        while (fields && strcmp(fields->value, value))
-            fields = fields->next;
-        if (fields && !strcmp(fields->value, value)) {
+        fields = grib_index_lookup_find(lookup, fields, value);
+        if (fields) {
             if (fields->next_level) {
                 keys   = keys->next;
                 fields = fields->next_level;
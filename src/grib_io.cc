@@ -9,6 +9,11 @@
  */
 
 #include "grib_api_internal.h"
+#include <unordered_set>
+
+#ifndef ECCODES_ON_WINDOWS
+#include <sys/mman.h>
+#endif
 
 #if GRIB_PTHREADS
 static pthread_once_t once    = PTHREAD_ONCE_INIT;
@@ -1231,6 +1236,108 @@ int wmo_read_bufr_from_file_fast(FILE* f, size_t* msg_len, off_t* msg_offset)
     *msg_len = sizeof(buffer);
     return ecc_wmo_read_any_from_file(f, buffer, msg_len, msg_offset, /*no_alloc=*/1, 0, 1, 0, 0);
 }
+// Memory-mapped files (see codes_io_mmap_on)
+// A file is mapped once while handles reference it. The mapping is private and writable so
+// a handle changing its message in place only changes its own copy of the pages.
+// Each message offset is served once per mapping so a message read again is not one a
+// previous handle may have modified.
+struct grib_mapped_file
+{
+    unsigned char* data;
+    size_t length;
+    dev_t dev;
+    ino_t ino;
+    time_t mtime;
+    int refcount;
+    std::unordered_set<off_t> used_offsets;
+    grib_mapped_file* next;
+};
+
+static grib_mapped_file* mapped_files = NULL;
+
+grib_mapped_file* grib_mapped_file_acquire(grib_context* c, FILE* f)
+{
+#ifndef ECCODES_ON_WINDOWS
+    grib_mapped_file* m = NULL;
+    struct stat st;
+    void* data = NULL;
+
+    if (fstat(fileno(f), &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+        return NULL;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex2);
+    for (m = mapped_files; m; m = m->next) {
+        if (m->dev == st.st_dev && m->ino == st.st_ino && m->length == (size_t)st.st_size && m->mtime == st.st_mtime) {
+            m->refcount++;
+            GRIB_MUTEX_UNLOCK(&mutex2);
+            return m;
+        }
+    }
+
+    data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(f), 0);
+    if (data == MAP_FAILED) {
+        GRIB_MUTEX_UNLOCK(&mutex2);
+        grib_context_log(c, GRIB_LOG_DEBUG, "%s: Cannot map file (%s)", __func__, strerror(errno));
+        return NULL;
+    }
+
+    m           = new grib_mapped_file();
+    m->data     = (unsigned char*)data;
+    m->length   = st.st_size;
+    m->dev      = st.st_dev;
+    m->ino      = st.st_ino;
+    m->mtime    = st.st_mtime;
+    m->refcount = 1;
+    m->next     = mapped_files;
+    mapped_files = m;
+    GRIB_MUTEX_UNLOCK(&mutex2);
+    return m;
+#else
+    return NULL;
+#endif
+}
+
+const unsigned char* grib_mapped_file_claim(grib_mapped_file* m, off_t offset, size_t length)
+{
+    const unsigned char* result = NULL;
+
+    if (offset < 0 || (size_t)offset > m->length || length > m->length - offset)
+        return NULL;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex2);
+    if (m->used_offsets.insert(offset).second)
+        result = m->data + offset;
+    GRIB_MUTEX_UNLOCK(&mutex2);
+    return result;
+}
+
+void grib_mapped_file_release(grib_context* c, grib_mapped_file* m)
+{
+#ifndef ECCODES_ON_WINDOWS
+    grib_mapped_file** p = NULL;
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex2);
+    if (--m->refcount > 0) {
+        GRIB_MUTEX_UNLOCK(&mutex2);
+        return;
+    }
+    for (p = &mapped_files; *p; p = &(*p)->next) {
+        if (*p == m) {
+            *p = m->next;
+            break;
+        }
+    }
+    GRIB_MUTEX_UNLOCK(&mutex2);
+
+    if (munmap(m->data, m->length) != 0)
+        grib_context_log(c, GRIB_LOG_ERROR, "%s: Cannot unmap file (%s)", __func__, strerror(errno));
+    delete m;
+#endif
+}
+
 int wmo_read_gts_from_file_fast(FILE* f, size_t* msg_len, off_t* msg_offset)
 {
     //TODO(masn): Needs proper implementation; no malloc
@@ -1917,3 +2024,186 @@ int codes_extract_offsets_sizes_malloc(
 {
     return codes_extract_offsets_malloc_internal(c, filename, product, offsets, sizes, number_of_elements, strict_mode);
 }
+
+// Messages of a file handed out to the workers of codes_file_parallel_foreach
+typedef struct foreach_job
+{
+    grib_context* context;
+    const char* filename;
+    const off_t* offsets;
+    const size_t* sizes;
+    int num_messages;
+    int ordered;
+    grib_foreach_proc proc;
+    void* data;
+
+    int next;      // Next message to decode
+    int next_call; // If ordered, next message the callback is called for
+    int err;       // First error: stops all workers
+#if GRIB_PTHREADS
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+#endif
+} foreach_job;
+
+#if GRIB_PTHREADS
+#define FOREACH_LOCK(job)      pthread_mutex_lock(&(job)->mutex)
+#define FOREACH_UNLOCK(job)    pthread_mutex_unlock(&(job)->mutex)
+#define FOREACH_WAIT(job)      pthread_cond_wait(&(job)->cond, &(job)->mutex)
+#define FOREACH_BROADCAST(job) pthread_cond_broadcast(&(job)->cond)
+#else
+#define FOREACH_LOCK(job)
+#define FOREACH_UNLOCK(job)
+#define FOREACH_WAIT(job)
+#define FOREACH_BROADCAST(job)
+#endif
+
+static grib_handle* foreach_read_message(foreach_job* job, FILE* f, int i, int* err)
+{
+    grib_context* c     = job->context;
+    grib_handle* h      = NULL;
+    size_t size         = job->sizes[i];
+    unsigned char* data = (unsigned char*)grib_context_malloc(c, size);
+
+    if (!data) {
+        *err = GRIB_OUT_OF_MEMORY;
+        return NULL;
+    }
+    if (fseeko(f, job->offsets[i], SEEK_SET) != 0 || fread(data, 1, size, f) != size) {
+        grib_context_log(c, GRIB_LOG_ERROR, "%s: Unable to read message %d of \"%s\"", __func__, i + 1, job->filename);
+        grib_context_free(c, data);
+        *err = GRIB_IO_PROBLEM;
+        return NULL;
+    }
+
+    h = grib_handle_new_from_message(c, data, size);
+    if (!h) {
+        grib_context_log(c, GRIB_LOG_ERROR, "%s: Unable to create handle for message %d of \"%s\"", __func__, i + 1, job->filename);
+        grib_context_free(c, data);
+        *err = GRIB_DECODING_ERROR;
+        return NULL;
+    }
+    h->buffer->property = CODES_MY_BUFFER;
+    h->offset           = job->offsets[i];
+    *err                = GRIB_SUCCESS;
+    return h;
+}
+
+// Each worker has its own FILE and decodes the next message not taken by another worker
+static void* foreach_worker(void* arg)
+{
+    foreach_job* job = (foreach_job*)arg;
+    grib_handle* h   = NULL;
+    int err = 0, i = 0;
+    FILE* f = fopen(job->filename, "rb");
+
+    if (!f) {
+        grib_context_log(job->context, GRIB_LOG_ERROR, "%s: Unable to read file \"%s\"", __func__, job->filename);
+        FOREACH_LOCK(job);
+        if (!job->err) job->err = GRIB_IO_PROBLEM;
+        FOREACH_BROADCAST(job);
+        FOREACH_UNLOCK(job);
+        return NULL;
+    }
+
+    for (;;) {
+        FOREACH_LOCK(job);
+        if (job->err || job->next >= job->num_messages) {
+            FOREACH_UNLOCK(job);
+            break;
+        }
+        i = job->next++;
+        FOREACH_UNLOCK(job);
+
+        h = foreach_read_message(job, f, i, &err);
+
+        if (job->ordered) {
+            // Messages are handed out in order so message i-1 is already being processed
+            FOREACH_LOCK(job);
+            while (job->next_call != i && !job->err)
+                FOREACH_WAIT(job);
+            if (job->err) err = job->err;
+            FOREACH_UNLOCK(job);
+        }
+
+        if (!err)
+            err = job->proc(h, i, job->data);
+        grib_handle_delete(h);
+
+        FOREACH_LOCK(job);
+        if (err && !job->err) job->err = err;
+        job->next_call++;
+        FOREACH_BROADCAST(job);
+        FOREACH_UNLOCK(job);
+    }
+
+    fclose(f);
+    return NULL;
+}
+
+int codes_file_parallel_foreach(grib_context* c, const char* filename, ProductKind product,
+                                int nthreads, int ordered, grib_foreach_proc proc, void* data)
+{
+    off_t* offsets   = NULL;
+    size_t* sizes    = NULL;
+    int num_messages = 0, err = 0;
+    foreach_job job;
+
+    if (!c) c = grib_context_get_default();
+    if (!filename || !proc)
+        return GRIB_INVALID_ARGUMENT;
+
+    err = codes_extract_offsets_sizes_malloc(c, filename, product, &offsets, &sizes, &num_messages, /*strict_mode=*/1);
+    if (err) {
+        free(offsets);
+        free(sizes);
+        return err;
+    }
+
+    job.context      = c;
+    job.filename     = filename;
+    job.offsets      = offsets;
+    job.sizes        = sizes;
+    job.num_messages = num_messages;
+    job.ordered      = ordered;
+    job.proc         = proc;
+    job.data         = data;
+    job.next         = 0;
+    job.next_call    = 0;
+    job.err          = 0;
+
+    if (nthreads <= 0) {
+#ifndef ECCODES_ON_WINDOWS
+        nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    }
+    if (nthreads > num_messages) nthreads = num_messages;
+    if (nthreads < 1) nthreads = 1;
+
+#if GRIB_PTHREADS
+    {
+        // The calling thread is one of the workers
+        pthread_t* workers = (pthread_t*)grib_context_malloc(c, nthreads * sizeof(pthread_t));
+        int nworkers       = 0, i = 0;
+        pthread_mutex_init(&job.mutex, NULL);
+        pthread_cond_init(&job.cond, NULL);
+        for (i = 1; i < nthreads; i++) {
+            if (pthread_create(&workers[nworkers], NULL, foreach_worker, &job) == 0)
+                nworkers++;
+        }
+        foreach_worker(&job);
+        for (i = 0; i < nworkers; i++)
+            pthread_join(workers[i], NULL);
+        pthread_cond_destroy(&job.cond);
+        pthread_mutex_destroy(&job.mutex);
+        grib_context_free(c, workers);
+    }
+#else
+    // Built without thread support: messages are processed in order by the calling thread
+    foreach_worker(&job);
+#endif
+
+    free(offsets);
+    free(sizes);
+    return job.err;
+}
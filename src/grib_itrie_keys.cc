@@ -297,11 +297,13 @@ static void init_mutex()
 }
 #endif
 
+// Keys are only ever added: inserts are serialised by the mutex and publish a node or an id
+// once complete so that grib_hash_keys_get_id finds existing keys without locking
 struct grib_itrie
 {
-    grib_itrie* next[SIZE];
+    std::atomic<grib_itrie*> next[SIZE];
     grib_context* context;
-    int id;
+    std::atomic<int> id;
     int* count;
 };
 
@@ -348,7 +350,7 @@ static int grib_hash_keys_insert(grib_itrie* t, const char* key)
 
     while (*k && t) {
         last = t;
-        t    = t->next[mapping[(int)*k]];
+        t    = t->next[mapping[(int)*k]].load(std::memory_order_relaxed);
         if (t)
             k++;
     }
@@ -356,19 +358,22 @@ static int grib_hash_keys_insert(grib_itrie* t, const char* key)
     if (*k != 0) {
         t = last;
         while (*k) {
-            int j      = mapping[(int)*k++];
-            t->next[j] = grib_hash_keys_new(t->context, count);
-            t          = t->next[j];
+            int j         = mapping[(int)*k++];
+            grib_itrie* n = grib_hash_keys_new(t->context, count);
+            t->next[j].store(n, std::memory_order_release);
+            t = n;
         }
     }
-    if (*(t->count) + TOTAL_KEYWORDS < ACCESSORS_ARRAY_SIZE) {
-        t->id = *(t->count);
-        (*(t->count))++;
-    }
-    else {
-        grib_context_log(t->context, GRIB_LOG_ERROR,
-                         "grib_hash_keys_insert: too many accessors, increase ACCESSORS_ARRAY_SIZE\n");
-        ECCODES_ASSERT(*(t->count) + TOTAL_KEYWORDS < ACCESSORS_ARRAY_SIZE);
+    if (t->id.load(std::memory_order_relaxed) == -1) { /* Not inserted by another thread since it was looked up */
+        if (*(t->count) + TOTAL_KEYWORDS < ACCESSORS_ARRAY_SIZE) {
+            t->id.store(*(t->count), std::memory_order_release);
+            (*(t->count))++;
+        }
+        else {
+            grib_context_log(t->context, GRIB_LOG_ERROR,
+                             "grib_hash_keys_insert: too many accessors, increase ACCESSORS_ARRAY_SIZE\n");
+            ECCODES_ASSERT(*(t->count) + TOTAL_KEYWORDS < ACCESSORS_ARRAY_SIZE);
+        }
     }
 
     GRIB_MUTEX_UNLOCK(&mutex);
@@ -391,22 +396,16 @@ int grib_hash_keys_get_id(grib_itrie* t, const char* key)
     {
         const char* k    = key;
         grib_itrie* last = t;
-
-        GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
-        GRIB_MUTEX_LOCK(&mutex);
+        int id           = -1;
 
         while (*k && t)
-            t = t->next[mapping[(int)*k++]];
+            t = t->next[mapping[(int)*k++]].load(std::memory_order_acquire);
 
-        if (t != NULL && t->id != -1) {
-            GRIB_MUTEX_UNLOCK(&mutex);
-            return t->id + TOTAL_KEYWORDS + 1;
-        }
-        else {
-            int ret = grib_hash_keys_insert(last, key);
-            GRIB_MUTEX_UNLOCK(&mutex);
-            return ret + TOTAL_KEYWORDS + 1;
-        }
+        if (t != NULL)
+            id = t->id.load(std::memory_order_acquire);
+        if (id == -1)
+            id = grib_hash_keys_insert(last, key);
+        return id + TOTAL_KEYWORDS + 1;
     }
 }
 
@@ -383,3 +383,193 @@ void* grib_buffer_realloc(const grib_context* c, void* p, size_t s)
  */
 
 #endif
+
+/* Per-handle arena.
+ * The accessors, sections and dependencies of a handle are carved out of large chunks which
+ * are released all at once when the handle is deleted. Objects freed before that go to a free
+ * list per size class and are reused by the same arena (e.g. when a section is rebuilt).
+ * Released chunks are kept in a per-thread pool for the next handle.
+ * Every allocation is preceded by a header naming its arena so that grib_arena_free works
+ * on memory from any arena as well as on objects which were allocated without one.
+ */
+#define ARENA_ALIGN           16
+#define ARENA_CHUNK_SIZE      (64 * 1024)
+#define ARENA_MAX_OBJECT_SIZE 2048
+#define ARENA_NUM_CLASSES     (ARENA_MAX_OBJECT_SIZE / ARENA_ALIGN + 1)
+#define ARENA_POOL_MAX_CHUNKS 256 /* 16MB per thread */
+
+typedef struct arena_chunk
+{
+    struct arena_chunk* next;
+    size_t pad;
+} arena_chunk;
+
+typedef struct arena_header
+{
+    grib_arena* arena; /* NULL when allocated with malloc */
+    size_t size_class;
+} arena_header;
+
+typedef struct arena_free_object
+{
+    struct arena_free_object* next;
+} arena_free_object;
+
+struct grib_arena
+{
+    arena_chunk* chunks;
+    char* next;
+    size_t left;
+    arena_free_object* free_list[ARENA_NUM_CLASSES];
+};
+
+namespace {
+struct arena_pool
+{
+    arena_chunk* chunks = NULL;
+    size_t count        = 0;
+    ~arena_pool()
+    {
+        while (chunks) {
+            arena_chunk* n = chunks->next;
+            free(chunks);
+            chunks = n;
+        }
+    }
+};
+}  // namespace
+
+static thread_local arena_pool pool;
+static thread_local grib_arena* current_arena = NULL;
+
+grib_arena* grib_arena_new(grib_context* c)
+{
+    grib_arena* a = (grib_arena*)calloc(1, sizeof(grib_arena));
+    if (!a)
+        grib_context_log(c, GRIB_LOG_ERROR, "%s: Unable to allocate %zu bytes", __func__, sizeof(grib_arena));
+    return a;
+}
+
+void grib_arena_delete(grib_arena* a)
+{
+    if (!a)
+        return;
+    while (a->chunks) {
+        arena_chunk* n = a->chunks->next;
+        if (pool.count < ARENA_POOL_MAX_CHUNKS) {
+            a->chunks->next = pool.chunks;
+            pool.chunks     = a->chunks;
+            pool.count++;
+        }
+        else {
+            free(a->chunks);
+        }
+        a->chunks = n;
+    }
+    free(a);
+}
+
+static int arena_new_chunk(grib_arena* a)
+{
+    arena_chunk* chunk = pool.chunks;
+    if (chunk) {
+        pool.chunks = chunk->next;
+        pool.count--;
+    }
+    else {
+        chunk = (arena_chunk*)malloc(ARENA_CHUNK_SIZE);
+        if (!chunk)
+            return GRIB_OUT_OF_MEMORY;
+    }
+    chunk->next = a->chunks;
+    a->chunks   = chunk;
+    a->next     = (char*)chunk + sizeof(arena_chunk);
+    a->left     = ARENA_CHUNK_SIZE - sizeof(arena_chunk);
+    return GRIB_SUCCESS;
+}
+
+void* grib_arena_malloc(grib_arena* a, size_t size)
+{
+    arena_header* h   = NULL;
+    size_t size_class = (size + ARENA_ALIGN - 1) / ARENA_ALIGN;
+
+    if (!a || size > ARENA_MAX_OBJECT_SIZE) {
+        h = (arena_header*)malloc(sizeof(arena_header) + size);
+        if (!h)
+            return NULL;
+        h->arena = NULL;
+        return h + 1;
+    }
+
+    if (a->free_list[size_class]) {
+        arena_free_object* o     = a->free_list[size_class];
+        a->free_list[size_class] = o->next;
+        return o;
+    }
+
+    const size_t needed = sizeof(arena_header) + size_class * ARENA_ALIGN;
+    if (a->left < needed && arena_new_chunk(a) != GRIB_SUCCESS)
+        return NULL;
+
+    h = (arena_header*)a->next;
+    a->next += needed;
+    a->left -= needed;
+    h->arena      = a;
+    h->size_class = size_class;
+    return h + 1;
+}
+
+void* grib_arena_malloc_clear(grib_arena* a, size_t size)
+{
+    void* p = grib_arena_malloc(a, size);
+    if (p)
+        memset(p, 0, size);
+    return p;
+}
+
+char* grib_arena_strdup(grib_arena* a, const char* s)
+{
+    const size_t len = strlen(s) + 1;
+    char* p          = (char*)grib_arena_malloc(a, len);
+    if (p)
+        memcpy(p, s, len);
+    return p;
+}
+
+void grib_arena_free(void* p)
+{
+    arena_header* h = NULL;
+    if (!p)
+        return;
+    h = (arena_header*)p - 1;
+    if (h->arena) {
+        arena_free_object* o               = (arena_free_object*)p;
+        o->next                            = h->arena->free_list[h->size_class];
+        h->arena->free_list[h->size_class] = o;
+    }
+    else {
+        free(h);
+    }
+}
+
+/* The arena used by grib_accessor::operator new. See grib_accessor_factory */
+grib_arena* grib_arena_current()
+{
+    return current_arena;
+}
+
+grib_arena* grib_arena_set_current(grib_arena* a)
+{
+    grib_arena* previous = current_arena;
+    current_arena        = a;
+    return previous;
+}
+
+/* Number of chunks taken by the arena so far, e.g. to check that freed objects are reused */
+size_t grib_arena_num_chunks(const grib_arena* a)
+{
+    size_t n = 0;
+    for (const arena_chunk* chunk = a ? a->chunks : NULL; chunk; chunk = chunk->next)
+        n++;
+    return n;
+}
@@ -552,7 +552,13 @@ GRIB_INLINE static int grib_inline_strcmp(const char* a, const char* b)
 
 grib_action_file* grib_find_action_file(const char* fname, grib_action_file_list* afl)
 {
-    grib_action_file* act = afl->first;
+    grib_action_file* act = NULL;
+    if (afl->index) {
+        act = (grib_action_file*)grib_trie_get(afl->index, fname);
+        if (act && grib_inline_strcmp(act->filename, fname) == 0)
+            return act;
+    }
+    act = afl->first;
     while (act) {
         if (grib_inline_strcmp(act->filename, fname) == 0)
             return act;
@@ -568,6 +574,8 @@ static void grib_push_action_file(grib_action_file* af, grib_action_file_list* a
     else
         afl->last->next = af;
     afl->last = af;
+    if (afl->index)
+        grib_trie_insert(afl->index, af->filename, af);
 }
 
 #define MAXINCLUDE 10
@@ -780,6 +788,15 @@ grib_concept_value* grib_parse_concept_file(grib_context* gc, const char* filena
     gc                  = gc ? gc : grib_context_get_default();
     grib_parser_context = gc;
 
+    if (gc->definitions_cache) {
+        grib_concept_value* cached = grib_definitions_cache_get_concept(gc, filename);
+        if (cached) {
+            GRIB_MUTEX_UNLOCK(&mutex_file);
+            return cached;
+        }
+    }
+
+    grib_parser_concept = 0;
     if (parse(gc, filename) == 0) {
         GRIB_MUTEX_UNLOCK(&mutex_file);
         return grib_parser_concept;
@@ -829,17 +846,26 @@ grib_action* grib_parse_file(grib_context* gc, const char* filename)
 {
     grib_action_file* af;
 
+    gc = gc ? gc : grib_context_get_default();
+
+    /* Files are only indexed once parsed: look up without locking */
+    if (gc->grib_reader && gc->grib_reader->index) {
+        af = (grib_action_file*)grib_trie_get(gc->grib_reader->index, filename);
+        if (af && grib_inline_strcmp(af->filename, filename) == 0)
+            return af->root;
+    }
+
     GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
     GRIB_MUTEX_LOCK(&mutex_file);
 
     af = 0;
 
-    gc = gc ? gc : grib_context_get_default();
-
     grib_parser_context = gc;
 
-    if (!gc->grib_reader)
-        gc->grib_reader = (grib_action_file_list*)grib_context_malloc_clear_persistent(gc, sizeof(grib_action_file_list));
+    if (!gc->grib_reader) {
+        gc->grib_reader        = (grib_action_file_list*)grib_context_malloc_clear_persistent(gc, sizeof(grib_action_file_list));
+        gc->grib_reader->index = grib_trie_new(gc);
+    }
     else {
         af = grib_find_action_file(filename, gc->grib_reader);
     }
@@ -99,35 +99,36 @@ static void rebuild_hash_keys(grib_handle* h, grib_section* s)
 
 static grib_accessor* search_and_cache(grib_handle* h, const char* name, const char* the_namespace);
 
-static grib_accessor* _search_and_cache(grib_handle* h, const char* name, const char* the_namespace)
+static grib_accessor* _search_and_cache_id(grib_handle* h, const char* name, const char* the_namespace, int id)
 {
-    if (h->use_trie) {
-        grib_accessor* a = NULL;
-        int id           = -1;
+    grib_accessor* a = NULL;
 
-        if (h->trie_invalid && h->kid == NULL) {
-            int i = 0;
-            for (i = 0; i < ACCESSORS_ARRAY_SIZE; i++)
-                h->accessors[i] = NULL;
+    if (h->trie_invalid && h->kid == NULL) {
+        int i = 0;
+        for (i = 0; i < ACCESSORS_ARRAY_SIZE; i++)
+            h->accessors[i] = NULL;
 
-            if (h->root)
-                rebuild_hash_keys(h, h->root);
+        if (h->root)
+            rebuild_hash_keys(h, h->root);
 
-            h->trie_invalid = 0;
-            id              = grib_hash_keys_get_id(h->context->keys, name);
-        }
-        else {
-            id = grib_hash_keys_get_id(h->context->keys, name);
+        h->trie_invalid = 0;
+    }
+    else {
+        if ((a = h->accessors[id]) != NULL &&
+            (the_namespace == NULL || matching(a, name, the_namespace)))
+            return a;
+    }
 
-            if ((a = h->accessors[id]) != NULL &&
-                (the_namespace == NULL || matching(a, name, the_namespace)))
-                return a;
-        }
+    a                = search(h->root, name, the_namespace);
+    h->accessors[id] = a;
 
-        a                = search(h->root, name, the_namespace);
-        h->accessors[id] = a;
+    return a;
+}
 
-        return a;
+static grib_accessor* _search_and_cache(grib_handle* h, const char* name, const char* the_namespace)
+{
+    if (h->use_trie) {
+        return _search_and_cache_id(h, name, the_namespace, grib_hash_keys_get_id(h->context->keys, name));
     }
     else {
         return search(h->root, name, the_namespace);
@@ -640,3 +641,138 @@ grib_accessor* grib_find_accessor_fast(grib_handle* h, const char* name)
 
     return a;
 }
+
+#if GRIB_PTHREADS
+static pthread_once_t once   = PTHREAD_ONCE_INIT;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void init_mutex()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+#elif GRIB_OMP_THREADS
+static int once = 0;
+static omp_nest_lock_t mutex;
+
+static void init_mutex()
+{
+    GRIB_OMP_CRITICAL(lock_grib_query_c)
+    {
+        if (once == 0) {
+            omp_init_nest_lock(&mutex);
+            once = 1;
+        }
+    }
+}
+#endif
+
+// Key references are only ever added: an id handed out by codes_key_id stays valid
+// until the context is deleted, so the lookups by id do not lock
+int codes_key_id(grib_context* c, const char* key)
+{
+    grib_key_ref* ref = NULL;
+    const char* p     = NULL;
+    int id            = -1;
+    int count         = 0;
+    int i             = 0;
+
+    if (!c)
+        c = grib_context_get_default();
+    if (!key || *key == 0 || key[0] == '/')
+        return GRIB_INVALID_ARGUMENT; /* Conditions match several accessors */
+
+    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
+    GRIB_MUTEX_LOCK(&mutex);
+
+    count = c->key_refs_count.load(std::memory_order_relaxed);
+    for (i = 0; i < count; i++) {
+        if (STR_EQUAL(c->key_refs[i]->key, key)) {
+            id = i;
+            break;
+        }
+    }
+
+    if (id < 0 && count >= MAX_NUM_KEY_REFS) {
+        grib_context_log(c, GRIB_LOG_ERROR, "%s: Too many keys (max=%d)", __func__, MAX_NUM_KEY_REFS);
+        id = GRIB_OUT_OF_MEMORY;
+    }
+
+    if (id == -1) {
+        ref      = (grib_key_ref*)grib_context_malloc_clear_persistent(c, sizeof(grib_key_ref));
+        ref->key = grib_context_strdup_persistent(c, key);
+
+        p = strchr(key, '.');
+        if (key[0] == '#' || strstr(key, "->")) {
+            /* Ranks and attributes are resolved by grib_find_accessor */
+            ref->hash_id = -1;
+        }
+        else if (p) {
+            size_t len = p - key;
+            if (len >= MAX_NAMESPACE_LEN) {
+                ref->hash_id = -1;
+            }
+            else {
+                ref->name_space = (char*)grib_context_malloc_clear_persistent(c, len + 1);
+                memcpy(ref->name_space, key, len);
+                ref->name    = grib_context_strdup_persistent(c, p + 1);
+                ref->hash_id = grib_hash_keys_get_id(c->keys, ref->name);
+            }
+        }
+        else {
+            ref->name    = grib_context_strdup_persistent(c, key);
+            ref->hash_id = grib_hash_keys_get_id(c->keys, ref->name);
+        }
+
+        id              = count;
+        c->key_refs[id] = ref;
+        c->key_refs_count.store(id + 1, std::memory_order_release);
+    }
+
+    GRIB_MUTEX_UNLOCK(&mutex);
+    return id;
+}
+
+/* Same search as grib_find_accessor with the key already split and hashed by codes_key_id */
+grib_accessor* grib_find_accessor_by_id(const grib_handle* ch, int id)
+{
+    grib_handle* h          = (grib_handle*)ch;
+    const grib_key_ref* ref = NULL;
+    grib_accessor* a        = NULL;
+    DEBUG_ASSERT(h);
+
+    if (id < 0 || id >= h->context->key_refs_count.load(std::memory_order_acquire))
+        return NULL;
+
+    ref = h->context->key_refs[id];
+    if (ref->hash_id < 0)
+        return grib_find_accessor(h, ref->key);
+
+    if (h->use_trie)
+        a = _search_and_cache_id(h, ref->name, ref->name_space, ref->hash_id);
+    else
+        a = search(h->root, ref->name, ref->name_space);
+
+    if (a == NULL && h->main)
+        a = grib_find_accessor_by_id(h->main, id);
+
+    return a;
+}
+
+void grib_key_refs_delete(grib_context* c)
+{
+    const int count = c->key_refs_count.load(std::memory_order_acquire);
+    int i           = 0;
+    for (i = 0; i < count; i++) {
+        grib_key_ref* ref = c->key_refs[i];
+        grib_context_free_persistent(c, ref->key);
+        grib_context_free_persistent(c, ref->name);
+        grib_context_free_persistent(c, ref->name_space);
+        grib_context_free_persistent(c, ref);
+        c->key_refs[i] = NULL;
+    }
+    c->key_refs_count.store(0, std::memory_order_relaxed);
+}
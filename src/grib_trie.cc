@@ -316,13 +316,15 @@ static void init_mutex()
 }
 #endif
 
+// Nodes are never removed until the whole trie is deleted. Inserts are serialised by the mutex
+// and publish a node or a value only once it is complete, so grib_trie_get does not lock
 struct grib_trie
 {
-    grib_trie* next[SIZE];
+    std::atomic<grib_trie*> next[SIZE];
     grib_context* context;
     int first;
     int last;
-    void* data;
+    std::atomic<void*> data;
 };
 
 grib_trie* grib_trie_new(grib_context* c)
@@ -365,7 +367,7 @@ void grib_trie_delete(grib_trie* t)
         int i;
         for (i = t->first; i <= t->last; i++)
             if (t->next[i]) {
-                grib_context_free(t->context, t->next[i]->data);
+                grib_context_free(t->context, t->next[i].load()->data);
                 grib_trie_delete(t->next[i]);
             }
 #ifdef RECYCLE_TRIE
@@ -405,14 +407,14 @@ void* grib_trie_insert(grib_trie* t, const char* key, void* data)
     while (*k && t) {
         last = t;
         DebugCheckBounds((int)*k, key);
-        t = t->next[mapping[(int)*k]];
+        t = t->next[mapping[(int)*k]].load(std::memory_order_relaxed);
         if (t)
             k++;
     }
 
     if (*k == 0) {
-        old     = t->data;
-        t->data = data;
+        old = t->data.load(std::memory_order_relaxed);
+        t->data.store(data, std::memory_order_release);
     }
     else {
         t = last;
@@ -424,10 +426,12 @@ void* grib_trie_insert(grib_trie* t, const char* key, void* data)
                 t->first = j;
             if (j > t->last)
                 t->last = j;
-            t = t->next[j] = grib_trie_new(t->context);
+            grib_trie* n = grib_trie_new(t->context);
+            t->next[j].store(n, std::memory_order_release);
+            t = n;
         }
-        old     = t->data;
-        t->data = data;
+        old = t->data.load(std::memory_order_relaxed);
+        t->data.store(data, std::memory_order_release);
     }
     GRIB_MUTEX_UNLOCK(&mutex);
     return data == old ? NULL : old;
@@ -442,7 +446,7 @@ void* grib_trie_insert_no_replace(grib_trie* t, const char* key, void* data)
     while (*k && t) {
         last = t;
         DebugCheckBounds((int)*k, key);
-        t = t->next[mapping[(int)*k]];
+        t = t->next[mapping[(int)*k]].load(std::memory_order_relaxed);
         if (t)
             k++;
     }
@@ -457,32 +461,29 @@ void* grib_trie_insert_no_replace(grib_trie* t, const char* key, void* data)
                 t->first = j;
             if (j > t->last)
                 t->last = j;
-            t = t->next[j] = grib_trie_new(t->context);
+            grib_trie* n = grib_trie_new(t->context);
+            t->next[j].store(n, std::memory_order_release);
+            t = n;
         }
     }
 
-    if (!t->data)
-        t->data = data;
+    if (!t->data.load(std::memory_order_relaxed))
+        t->data.store(data, std::memory_order_release);
 
-    return t->data;
+    return t->data.load(std::memory_order_relaxed);
 }
 
 void* grib_trie_get(grib_trie* t, const char* key)
 {
     const char* k = key;
-    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
-    GRIB_MUTEX_LOCK(&mutex);
 
     while (*k && t) {
         DebugCheckBounds((int)*k, key);
-        t = t->next[mapping[(int)*k++]];
+        t = t->next[mapping[(int)*k++]].load(std::memory_order_acquire);
     }
 
-    if (*k == 0 && t != NULL && t->data != NULL) {
-        GRIB_MUTEX_UNLOCK(&mutex);
-        return t->data;
-    }
-    GRIB_MUTEX_UNLOCK(&mutex);
+    if (*k == 0 && t != NULL)
+        return t->data.load(std::memory_order_acquire);
     return NULL;
 }
 
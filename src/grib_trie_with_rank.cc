@@ -288,34 +288,6 @@ static const size_t NUM_MAPPINGS = sizeof(mapping) / sizeof(mapping[0]);
 
 #define SIZE 39
 
-#if GRIB_PTHREADS
-static pthread_once_t once   = PTHREAD_ONCE_INIT;
-static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
-
-static void init_mutex()
-{
-    pthread_mutexattr_t attr;
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
-    pthread_mutex_init(&mutex, &attr);
-    pthread_mutexattr_destroy(&attr);
-}
-#elif GRIB_OMP_THREADS
-static int once = 0;
-static omp_nest_lock_t mutex;
-
-static void init_mutex()
-{
-    GRIB_OMP_CRITICAL(lock_grib_trie_with_rank_c)
-    {
-        if (once == 0) {
-            omp_init_nest_lock(&mutex);
-            once = 1;
-        }
-    }
-}
-#endif
-
 /*
 struct grib_trie_with_rank_list {
     grib_trie_with_rank_list* next;
@@ -324,6 +296,8 @@ struct grib_trie_with_rank_list {
 };
 */
 
+// A trie with rank holds the accessors of one handle, which is only used by one thread at a time,
+// so it is not locked
 struct grib_trie_with_rank
 {
     grib_trie_with_rank* next[SIZE];
@@ -364,7 +338,7 @@ static void _grib_trie_with_rank_delete_container(grib_trie_with_rank* t)
     DEBUG_ASSERT(t);
     for (i = t->first; i <= t->last; i++)
         if (t->next[i]) {
-            grib_trie_with_rank_delete_container(t->next[i]);
+            _grib_trie_with_rank_delete_container(t->next[i]);
         }
     grib_oarray_delete(t->objs);
     /* grib_trie_with_rank_delete_container_list(t->context,t->list); */
@@ -376,10 +350,7 @@ static void _grib_trie_with_rank_delete_container(grib_trie_with_rank* t)
 }
 void grib_trie_with_rank_delete_container(grib_trie_with_rank* t)
 {
-    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
-    GRIB_MUTEX_LOCK(&mutex);
     _grib_trie_with_rank_delete_container(t);
-    GRIB_MUTEX_UNLOCK(&mutex);
 }
 
 #ifdef TRIE_WITH_RANK_OLD
@@ -456,9 +427,6 @@ int grib_trie_with_rank_insert(grib_trie_with_rank* t, const char* key, void* da
     DEBUG_ASSERT(t);
     if (!t) return -1;
 
-    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
-    GRIB_MUTEX_LOCK(&mutex);
-
     while (*k && t) {
         last = t;
         DebugCheckBounds((int)*k, key);
@@ -484,7 +452,6 @@ int grib_trie_with_rank_insert(grib_trie_with_rank* t, const char* key, void* da
         t->objs = grib_oarray_new(100, 1000);
     grib_oarray_push(t->objs, data);
     /* grib_trie_with_rank_insert_in_list(t,data); */
-    GRIB_MUTEX_UNLOCK(&mutex);
     return (int)t->objs->n;
 }
 
@@ -505,24 +472,16 @@ static void *grib_trie_with_rank_get_from_list(grib_trie_with_rank_list* list,in
 void* grib_trie_with_rank_get(grib_trie_with_rank* t, const char* key, int rank)
 {
     const char* k = key;
-    void* data;
-    GRIB_MUTEX_INIT_ONCE(&once, &init_mutex);
 
     if (rank < 0)
         return NULL;
 
-    GRIB_MUTEX_LOCK(&mutex);
-
     while (*k && t) {
         DebugCheckBounds((int)*k, key);
         t = t->next[mapping[(int)*k++]];
     }
 
-    if (*k == 0 && t != NULL) {
-        data = grib_oarray_get(t->objs, rank - 1);
-        GRIB_MUTEX_UNLOCK(&mutex);
-        return data;
-    }
-    GRIB_MUTEX_UNLOCK(&mutex);
+    if (*k == 0 && t != NULL)
+        return grib_oarray_get(t->objs, rank - 1);
     return NULL;
 }
@@ -2146,6 +2146,53 @@ int grib_is_earth_oblate(const grib_handle* h)
     return 0;
 }
 
+// Minimum and maximum of an array in a single pass, using several independent
+// accumulators so the compiler can keep them in vector registers.
+// The result is identical to the plain scalar loop starting from val[0]: NaNs are skipped
+// unless val[0] is one, and of several equal values (0 and -0) the first one is returned
+void grib_get_min_max(const double* val, size_t n_vals, double* min, double* max)
+{
+    const size_t nlanes = 4;
+    double lmin[nlanes], lmax[nlanes];
+    size_t i = 0, k = 0;
+
+    DEBUG_ASSERT(n_vals > 0);
+    for (k = 0; k < nlanes; k++)
+        lmin[k] = lmax[k] = val[0];
+
+    for (i = 0; i + nlanes <= n_vals; i += nlanes) {
+        for (k = 0; k < nlanes; k++) {
+            const double v = val[i + k];
+            lmax[k]        = v > lmax[k] ? v : lmax[k];
+            lmin[k]        = v < lmin[k] ? v : lmin[k];
+        }
+    }
+    for (; i < n_vals; i++) {
+        const double v = val[i];
+        lmax[0]        = v > lmax[0] ? v : lmax[0];
+        lmin[0]        = v < lmin[0] ? v : lmin[0];
+    }
+
+    *max = lmax[0];
+    *min = lmin[0];
+    for (k = 1; k < nlanes; k++) {
+        if (lmax[k] > *max) *max = lmax[k];
+        if (lmin[k] < *min) *min = lmin[k];
+    }
+
+    // Zero is the only value with two representations. Return the one seen first
+    if (*max == 0) {
+        for (i = 0; i < n_vals; i++) {
+            if (val[i] == 0) { *max = val[i]; break; }
+        }
+    }
+    if (*min == 0) {
+        for (i = 0; i < n_vals; i++) {
+            if (val[i] == 0) { *min = val[i]; break; }
+        }
+    }
+}
+
 int grib_check_data_values_minmax(grib_handle* h, const double min_val, const double max_val)
 {
     int result = GRIB_SUCCESS;
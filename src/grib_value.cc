@@ -15,8 +15,10 @@
 #include "grib_value.h"
 //#include "grib_accessor.h"
 #include <float.h>
+#include <algorithm>
 #include <limits>
 #include <type_traits>
+#include <vector>
 
 /* Note: A fast cut-down version of strcmp which does NOT return -1 */
 /* 0 means input strings are equal and 1 means not equal */
@@ -120,31 +122,35 @@ int grib_set_long_internal(grib_handle* h, const char* name, long val)
     return GRIB_NOT_FOUND;
 }
 
-int grib_set_long(grib_handle* h, const char* name, long val)
+// Set an accessor found by name or by id. See codes_set_long_by_id
+static int set_long_accessor(grib_handle* h, grib_accessor* a, const char* name, long val)
 {
-    int ret          = GRIB_SUCCESS;
-    grib_accessor* a = NULL;
-    size_t l         = 1;
+    int ret  = GRIB_SUCCESS;
+    size_t l = 1;
 
-    a = grib_find_accessor(h, name);
+    if (h->context->debug) {
+        if (strcmp(name, a->name_)!=0)
+            fprintf(stderr, "ECCODES DEBUG grib_set_long h=%p %s=%ld (a->name_=%s)\n", (void*)h, name, val, a->name_);
+        else
+            fprintf(stderr, "ECCODES DEBUG grib_set_long h=%p %s=%ld\n", (void*)h, name, val);
+    }
 
-    if (a) {
-        if (h->context->debug) {
-            if (strcmp(name, a->name_)!=0)
-                fprintf(stderr, "ECCODES DEBUG grib_set_long h=%p %s=%ld (a->name_=%s)\n", (void*)h, name, val, a->name_);
-            else
-                fprintf(stderr, "ECCODES DEBUG grib_set_long h=%p %s=%ld\n", (void*)h, name, val);
-        }
+    if (a->flags_ & GRIB_ACCESSOR_FLAG_READ_ONLY)
+        return GRIB_READ_ONLY;
 
-        if (a->flags_ & GRIB_ACCESSOR_FLAG_READ_ONLY)
-            return GRIB_READ_ONLY;
+    ret = a->pack_long(&val, &l);
+    if (ret == GRIB_SUCCESS)
+        return grib_dependency_notify_change(a);
 
-        ret = a->pack_long(&val, &l);
-        if (ret == GRIB_SUCCESS)
-            return grib_dependency_notify_change(a);
+    return ret;
+}
 
-        return ret;
-    }
+int grib_set_long(grib_handle* h, const char* name, long val)
+{
+    grib_accessor* a = grib_find_accessor(h, name);
+
+    if (a)
+        return set_long_accessor(h, a, name, val);
 
     if (h->context->debug) {
         fprintf(stderr, "ECCODES DEBUG grib_set_long h=%p %s=%ld (Key not found)\n", (void*)h, name, val);
@@ -352,31 +358,35 @@ int grib_copy_namespace(grib_handle* dest, const char* name, grib_handle* src)
     return error_code;
 }
 
-int grib_set_double(grib_handle* h, const char* name, double val)
+// Set an accessor found by name or by id. See codes_set_double_by_id
+static int set_double_accessor(grib_handle* h, grib_accessor* a, const char* name, double val)
 {
-    int ret          = GRIB_SUCCESS;
-    grib_accessor* a = NULL;
-    size_t l         = 1;
+    int ret  = GRIB_SUCCESS;
+    size_t l = 1;
 
-    a = grib_find_accessor(h, name);
+    if (h->context->debug) {
+        if (strcmp(name, a->name_)!=0)
+            fprintf(stderr, "ECCODES DEBUG grib_set_double h=%p %s=%.10g (a->name_=%s)\n", (void*)h, name, val, a->name_);
+        else
+            fprintf(stderr, "ECCODES DEBUG grib_set_double h=%p %s=%.10g\n", (void*)h, name, val);
+    }
 
-    if (a) {
-        if (h->context->debug) {
-            if (strcmp(name, a->name_)!=0)
-                fprintf(stderr, "ECCODES DEBUG grib_set_double h=%p %s=%.10g (a->name_=%s)\n", (void*)h, name, val, a->name_);
-            else
-                fprintf(stderr, "ECCODES DEBUG grib_set_double h=%p %s=%.10g\n", (void*)h, name, val);
-        }
+    if (a->flags_ & GRIB_ACCESSOR_FLAG_READ_ONLY)
+        return GRIB_READ_ONLY;
 
-        if (a->flags_ & GRIB_ACCESSOR_FLAG_READ_ONLY)
-            return GRIB_READ_ONLY;
+    ret = a->pack_double(&val, &l);
+    if (ret == GRIB_SUCCESS)
+        return grib_dependency_notify_change(a);
 
-        ret = a->pack_double(&val, &l);
-        if (ret == GRIB_SUCCESS)
-            return grib_dependency_notify_change(a);
+    return ret;
+}
 
-        return ret;
-    }
+int grib_set_double(grib_handle* h, const char* name, double val)
+{
+    grib_accessor* a = grib_find_accessor(h, name);
+
+    if (a)
+        return set_double_accessor(h, a, name, val);
     return GRIB_NOT_FOUND;
 }
 
@@ -480,35 +490,39 @@ static void postprocess_packingType_change(grib_handle* h, const char* keyname,
     }
 }
 
-int grib_set_string(grib_handle* h, const char* name, const char* val, size_t* length)
+// Set an accessor found by name or by id. See codes_set_string_by_id
+static int set_string_accessor(grib_handle* h, grib_accessor* a, const char* name, const char* val, size_t* length)
 {
-    int ret          = 0;
-    grib_accessor* a = NULL;
+    int ret = 0;
 
     int processed = preprocess_packingType_change(h, name, val);
     if (processed)
         return GRIB_SUCCESS;  // Dealt with - no further action needed
 
-    a = grib_find_accessor(h, name);
-
-    if (a) {
-        if (h->context->debug) {
-            if (strcmp(name, a->name_)!=0)
-                fprintf(stderr, "ECCODES DEBUG grib_set_string h=%p %s=|%s| (a->name_=%s)\n", (void*)h, name, val, a->name_);
-            else
-                fprintf(stderr, "ECCODES DEBUG grib_set_string h=%p %s=|%s|\n", (void*)h, name, val);
-        }
+    if (h->context->debug) {
+        if (strcmp(name, a->name_)!=0)
+            fprintf(stderr, "ECCODES DEBUG grib_set_string h=%p %s=|%s| (a->name_=%s)\n", (void*)h, name, val, a->name_);
+        else
+            fprintf(stderr, "ECCODES DEBUG grib_set_string h=%p %s=|%s|\n", (void*)h, name, val);
+    }
 
-        if (a->flags_ & GRIB_ACCESSOR_FLAG_READ_ONLY)
-            return GRIB_READ_ONLY;
+    if (a->flags_ & GRIB_ACCESSOR_FLAG_READ_ONLY)
+        return GRIB_READ_ONLY;
 
-        ret = a->pack_string(val, length);
-        if (ret == GRIB_SUCCESS) {
-            postprocess_packingType_change(h, name, val);
-            return grib_dependency_notify_change(a);
-        }
-        return ret;
+    ret = a->pack_string(val, length);
+    if (ret == GRIB_SUCCESS) {
+        postprocess_packingType_change(h, name, val);
+        return grib_dependency_notify_change(a);
     }
+    return ret;
+}
+
+int grib_set_string(grib_handle* h, const char* name, const char* val, size_t* length)
+{
+    grib_accessor* a = grib_find_accessor(h, name);
+
+    if (a)
+        return set_string_accessor(h, a, name, val, length);
 
     if (h->context->debug) {
         fprintf(stderr, "ECCODES DEBUG grib_set_string %s=|%s| (Key not found)\n", name, val);
@@ -1087,6 +1101,98 @@ int grib_get_float(const grib_handle* h, const char* name, float* val)
     return ret;
 }
 
+// Decoded values cache (see codes_values_cache_on)
+//
+// The arrays unpacked from the data accessors and the latitudes/longitudes are kept with the handle.
+// They are valid for as long as the change count of the handle, bumped by grib_dependency_notify_change
+// whenever a key changes, stays the same
+struct grib_values_cache_entry
+{
+    const grib_accessor* a;
+    unsigned long change_count;
+    bool has_dvalues;
+    bool has_fvalues;
+    std::vector<double> dvalues;
+    std::vector<float> fvalues;
+};
+
+struct grib_values_cache
+{
+    std::vector<grib_values_cache_entry> entries;
+};
+
+static bool values_cache_applies(const grib_handle* h, const grib_accessor* a)
+{
+    if (!h->context->values_cache || !grib_handle_change_count_valid(h) || h->product_kind != PRODUCT_GRIB)
+        return false;
+    // The arrays of accessors sharing a name are concatenated, their elements are read from the newest
+    if (a->same_)
+        return false;
+    const char* cn = a->class_name_;
+    return strncmp(cn, "data_", 5) == 0 || strcmp(cn, "latitudes") == 0 || strcmp(cn, "longitudes") == 0;
+}
+
+template <typename T>
+static std::vector<T>& values_cache_array(grib_values_cache_entry& e)
+{
+    if constexpr (std::is_same<T, double>::value)
+        return e.dvalues;
+    else
+        return e.fvalues;
+}
+
+template <typename T>
+static bool& values_cache_has(grib_values_cache_entry& e)
+{
+    if constexpr (std::is_same<T, double>::value)
+        return e.has_dvalues;
+    else
+        return e.has_fvalues;
+}
+
+template <typename T>
+static const std::vector<T>* values_cache_get(const grib_handle* h, const grib_accessor* a)
+{
+    if (!h->values_cache || !values_cache_applies(h, a))
+        return NULL;
+    for (grib_values_cache_entry& e : h->values_cache->entries) {
+        if (e.a == a && e.change_count == h->change_count && values_cache_has<T>(e))
+            return &values_cache_array<T>(e);
+    }
+    return NULL;
+}
+
+template <typename T>
+static void values_cache_put(const grib_handle* ch, const grib_accessor* a, const T* val, size_t len)
+{
+    grib_handle* h = (grib_handle*)ch;
+    if (!values_cache_applies(h, a))
+        return;
+    if (!h->values_cache)
+        h->values_cache = new grib_values_cache;
+
+    // Drop the arrays decoded before the last change
+    std::vector<grib_values_cache_entry>& entries = h->values_cache->entries;
+    const unsigned long change_count              = h->change_count;
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [change_count](const grib_values_cache_entry& e) { return e.change_count != change_count; }),
+                  entries.end());
+
+    auto it = std::find_if(entries.begin(), entries.end(), [a](const grib_values_cache_entry& e) { return e.a == a; });
+    if (it == entries.end()) {
+        entries.push_back({ a, change_count, false, false, {}, {} });
+        it = entries.end() - 1;
+    }
+    values_cache_array<T>(*it).assign(val, val + len);
+    values_cache_has<T>(*it) = true;
+}
+
+void grib_values_cache_delete(grib_handle* h)
+{
+    delete h->values_cache;
+    h->values_cache = NULL;
+}
+
 int grib_get_double_element_internal(grib_handle* h, const char* name, int i, double* val)
 {
     int ret = grib_get_double_element(h, name, i, val);
@@ -1104,6 +1210,11 @@ int grib_get_double_element(const grib_handle* h, const char* name, int i, doubl
     grib_accessor* act = grib_find_accessor(h, name);
 
     if (act) {
+        const std::vector<double>* cached = values_cache_get<double>(h, act);
+        if (cached && i >= 0 && (size_t)i < cached->size()) {
+            *val = (*cached)[i];
+            return GRIB_SUCCESS;
+        }
         return act->unpack_double_element(i, val);
     }
     return GRIB_NOT_FOUND;
@@ -1113,6 +1224,11 @@ int grib_get_float_element(const grib_handle* h, const char* name, int i, float*
     grib_accessor* act = grib_find_accessor(h, name);
 
     if (act) {
+        const std::vector<float>* cached = values_cache_get<float>(h, act);
+        if (cached && i >= 0 && (size_t)i < cached->size()) {
+            *val = (*cached)[i];
+            return GRIB_SUCCESS;
+        }
         return act->unpack_float_element(i, val);
     }
     return GRIB_NOT_FOUND;
@@ -1141,11 +1257,29 @@ int grib_get_float_element_set_internal(grib_handle* h, const char* name, const
     return ret;
 }
 
+// Serve the elements from the decoded values cache if all the indexes are within the array
+template <typename T>
+static bool values_cache_get_elements(const grib_handle* h, const grib_accessor* a, const size_t* index_array, size_t len, T* val_array)
+{
+    const std::vector<T>* cached = values_cache_get<T>(h, a);
+    if (!cached)
+        return false;
+    for (size_t i = 0; i < len; i++) {
+        if (index_array[i] >= cached->size())
+            return false;
+    }
+    for (size_t i = 0; i < len; i++)
+        val_array[i] = (*cached)[index_array[i]];
+    return true;
+}
+
 int grib_get_double_element_set(const grib_handle* h, const char* name, const size_t* index_array, size_t len, double* val_array)
 {
     grib_accessor* acc = grib_find_accessor(h, name);
 
     if (acc) {
+        if (values_cache_get_elements<double>(h, acc, index_array, len, val_array))
+            return GRIB_SUCCESS;
         return acc->unpack_double_element_set(index_array, len, val_array);
     }
     return GRIB_NOT_FOUND;
@@ -1155,6 +1289,8 @@ int grib_get_float_element_set(const grib_handle* h, const char* name, const siz
     grib_accessor* acc = grib_find_accessor(h, name);
 
     if (acc) {
+        if (values_cache_get_elements<float>(h, acc, index_array, len, val_array))
+            return GRIB_SUCCESS;
         return acc->unpack_float_element_set(index_array, len, val_array);
     }
     return GRIB_NOT_FOUND;
@@ -1189,6 +1325,14 @@ int grib_get_double_elements(const grib_handle* h, const char* name, const int*
         }
     }
 
+    const std::vector<double>* cached = values_cache_get<double>(h, act);
+    if (cached && cached->size() == size) {
+        for (j = 0; j < len; j++) {
+            val_array[j] = (*cached)[index_array[j]];
+        }
+        return GRIB_SUCCESS;
+    }
+
     num_bytes = size * sizeof(double);
     values    = (double*)grib_context_malloc(h->context, num_bytes);
     if (!values) {
@@ -1201,6 +1345,7 @@ int grib_get_double_elements(const grib_handle* h, const char* name, const int*
         for (j = 0; j < len; j++) {
             val_array[j] = values[index_array[j]];
         }
+        values_cache_put<double>(h, act, values, size);
     }
 
     grib_context_free(h->context, values);
@@ -1246,6 +1391,57 @@ int grib_get_string(const grib_handle* h, const char* name, char* val, size_t* l
     }
 }
 
+/* By id: the key is resolved once with codes_key_id. See grib_find_accessor_by_id */
+int codes_get_long_by_id(const grib_handle* h, int id, long* val)
+{
+    size_t length    = 1;
+    grib_accessor* a = grib_find_accessor_by_id(h, id);
+    if (!a)
+        return GRIB_NOT_FOUND;
+    return a->unpack_long(val, &length);
+}
+
+int codes_get_double_by_id(const grib_handle* h, int id, double* val)
+{
+    size_t length    = 1;
+    grib_accessor* a = grib_find_accessor_by_id(h, id);
+    if (!a)
+        return GRIB_NOT_FOUND;
+    return a->unpack_double(val, &length);
+}
+
+int codes_get_string_by_id(const grib_handle* h, int id, char* val, size_t* length)
+{
+    grib_accessor* a = grib_find_accessor_by_id(h, id);
+    if (!a)
+        return GRIB_NOT_FOUND;
+    return a->unpack_string(val, length);
+}
+
+int codes_set_long_by_id(grib_handle* h, int id, long val)
+{
+    grib_accessor* a = grib_find_accessor_by_id(h, id);
+    if (!a)
+        return GRIB_NOT_FOUND;
+    return set_long_accessor(h, a, a->name_, val);
+}
+
+int codes_set_double_by_id(grib_handle* h, int id, double val)
+{
+    grib_accessor* a = grib_find_accessor_by_id(h, id);
+    if (!a)
+        return GRIB_NOT_FOUND;
+    return set_double_accessor(h, a, a->name_, val);
+}
+
+int codes_set_string_by_id(grib_handle* h, int id, const char* val, size_t* length)
+{
+    grib_accessor* a = grib_find_accessor_by_id(h, id);
+    if (!a)
+        return GRIB_NOT_FOUND;
+    return set_string_accessor(h, a, a->name_, val, length);
+}
+
 // int grib_get_bytes_internal(const grib_handle* h, const char* name, unsigned char* val, size_t* length)
 // {
 //     int ret = grib_get_bytes(h, name, val, length);
@@ -1356,8 +1552,17 @@ int grib_get_double_array(const grib_handle* h, const char* name, double* val, s
             return a->unpack_double(val, length);
         }
         else {
+            const std::vector<double>* cached = values_cache_get<double>(h, a);
+            if (cached && cached->size() <= len) {
+                std::copy(cached->begin(), cached->end(), val);
+                *length = cached->size();
+                return GRIB_SUCCESS;
+            }
             *length = 0;
-            return _grib_get_array_internal<double>(h, a, val, len, length);
+            ret     = _grib_get_array_internal<double>(h, a, val, len, length);
+            if (ret == GRIB_SUCCESS)
+                values_cache_put<double>(h, a, val, *length);
+            return ret;
         }
     }
 }
@@ -1375,8 +1580,17 @@ int grib_get_float_array(const grib_handle* h, const char* name, float* val, siz
     }
     ECCODES_ASSERT(name[0]!='/');
     ECCODES_ASSERT(name[0]!='#');
+    const std::vector<float>* cached = values_cache_get<float>(h, a);
+    if (cached && cached->size() <= len) {
+        std::copy(cached->begin(), cached->end(), val);
+        *length = cached->size();
+        return GRIB_SUCCESS;
+    }
     *length = 0;
-    return _grib_get_array_internal<float>(h,a,val,len,length);
+    int ret = _grib_get_array_internal<float>(h,a,val,len,length);
+    if (ret == GRIB_SUCCESS)
+        values_cache_put<float>(h, a, val, *length);
+    return ret;
 }
 
 template <>
@@ -1476,8 +1690,11 @@ int grib_get_size(const grib_handle* ch, const char* name, size_t* size)
             *size      = count;
             return ret;
         }
-        else
-            return grib_get_size_acc(h, a, size);
+        if (const std::vector<double>* cached = values_cache_get<double>(h, a)) {
+            *size = cached->size();
+            return GRIB_SUCCESS;
+        }
+        return grib_get_size_acc(h, a, size);
     }
 }
 
@@ -1791,16 +2008,22 @@ int grib_set_values(grib_handle* h, grib_values* args, size_t count)
 int grib_set_values_silent(grib_handle* h, grib_values* args, size_t count, int silent)
 {
     int i, error = 0;
-    int err = 0;
-    size_t len;
-    int more  = 1;
-    int stack = h->values_stack++;
+    int err = 0, rebuild_err = 0;
+    size_t len, rebuilt = 0;
+    int more                 = 1;
+    int stack                = h->values_stack++;
+    int defer                = h->defer_rebuilds;
+    grib_accessor* defer_key = h->deferred_key;
 
     ECCODES_ASSERT(h->values_stack < MAX_SET_VALUES - 1);
 
     h->values[stack]       = args;
     h->values_count[stack] = count;
 
+    /* A section depending on several keys of the batch is rebuilt once. See grib_dependency_defer_set */
+    if (h->context->deferred_rebuilds && !h->main)
+        h->defer_rebuilds = h->values_stack;
+
     if (h->context->debug) {
         for (i = 0; i < count; i++) {
             grib_print_values("ECCODES DEBUG about to set key/value pair", &args[i], stderr, 1);
@@ -1815,6 +2038,8 @@ int grib_set_values_silent(grib_handle* h, grib_values* args, size_t count, int
         for (i = 0; i < count; i++) {
             if (args[i].error != GRIB_NOT_FOUND)
                 continue;
+            if (h->defer_rebuilds == h->values_stack && grib_dependency_defer_set(h, args[i].name))
+                continue;
 
             switch (args[i].type) {
                 case GRIB_TYPE_LONG:
@@ -1851,6 +2076,19 @@ int grib_set_values_silent(grib_handle* h, grib_values* args, size_t count, int
             }
             // if (args[i].error != GRIB_SUCCESS)
             //   grib_context_log(h->context,GRIB_LOG_ERROR,"Unable to set %s (%s)",args[i].name,grib_get_error_message(args[i].error));
+
+            h->deferred_key = NULL;
+
+            /* It may be settable once the pending sections of this level are rebuilt */
+            if (args[i].error != GRIB_SUCCESS && h->defer_rebuilds == h->values_stack && grib_dependency_deferred_pending(h))
+                args[i].error = GRIB_NOT_FOUND;
+        }
+        if (h->defer_rebuilds == h->values_stack && !rebuild_err) {
+            rebuild_err = grib_dependency_run_deferred_rebuilds(h, h->values_stack, &rebuilt);
+            if (rebuild_err)
+                h->defer_rebuilds = defer;
+            if (rebuilt)
+                more = 1;
         }
     }
 
@@ -1858,6 +2096,8 @@ int grib_set_values_silent(grib_handle* h, grib_values* args, size_t count, int
     h->values_count[stack] = 0;
 
     h->values_stack--;
+    h->defer_rebuilds = defer;
+    h->deferred_key   = defer_key;
 
     for (i = 0; i < count; i++) {
         if (args[i].error != GRIB_SUCCESS) {
@@ -1870,6 +2110,13 @@ int grib_set_values_silent(grib_handle* h, grib_values* args, size_t count, int
             err = err == GRIB_SUCCESS ? args[i].error : err;
         }
     }
+    if (rebuild_err) {
+        if (!silent)
+            grib_context_log(h->context, GRIB_LOG_ERROR, "grib_set_values: Unable to rebuild sections: %s",
+                             grib_get_error_message(rebuild_err));
+        if (err == GRIB_SUCCESS)
+            err = rebuild_err;
+    }
 
     return err;
 }
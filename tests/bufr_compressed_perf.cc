@@ -0,0 +1,111 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Decoding timings for compressed BUFR on a radiance-like message: latitude, longitude and
+ * a replicated brightness temperature for every channel, some of them missing
+ * Build with -DENABLE_TIMER=ON
+ */
+
+#include "grib_api_internal.h"
+
+#if ECCODES_TIMER
+
+static void usage(const char* prog)
+{
+    printf("usage: %s repetitions [numberOfSubsets [numberOfChannels]]\n", prog);
+    exit(1);
+}
+
+static void print_timer(grib_timer* t, int repeat)
+{
+    printf("%s : %g cpu\n", t->name_, t->timer_ / repeat);
+}
+
+static grib_handle* create_radiances(grib_context* c, long numberOfSubsets, long numberOfChannels)
+{
+    long descriptors[] = { 1007, 5001, 6001, 101000 + numberOfChannels, 12163 };
+    double* values     = (double*)grib_context_malloc(c, numberOfSubsets * sizeof(double));
+    grib_handle* h     = codes_bufr_handle_new_from_samples(c, "BUFR4");
+    char key[64]       = {0,};
+    long i, k;
+
+    ECCODES_ASSERT(h && values);
+    GRIB_CHECK(grib_set_long(h, "numberOfSubsets", numberOfSubsets), 0);
+    GRIB_CHECK(grib_set_long(h, "compressedData", 1), 0);
+    GRIB_CHECK(grib_set_long_array(h, "unexpandedDescriptors", descriptors, 5), 0);
+
+    for (i = 0; i < numberOfSubsets; i++)
+        values[i] = -90 + 180.0 * i / numberOfSubsets;
+    GRIB_CHECK(grib_set_double_array(h, "latitude", values, numberOfSubsets), 0);
+    for (i = 0; i < numberOfSubsets; i++)
+        values[i] = -180 + 360.0 * i / numberOfSubsets;
+    GRIB_CHECK(grib_set_double_array(h, "longitude", values, numberOfSubsets), 0);
+
+    srand(1);
+    for (k = 1; k <= numberOfChannels; k++) {
+        for (i = 0; i < numberOfSubsets; i++)
+            values[i] = (rand() % 7 == 0) ? GRIB_MISSING_DOUBLE : 180 + (rand() % 12000) * 0.01;
+        snprintf(key, sizeof(key), "#%ld#brightnessTemperature", k);
+        GRIB_CHECK(grib_set_double_array(h, key, values, numberOfSubsets), 0);
+    }
+    GRIB_CHECK(grib_set_long(h, "pack", 1), 0);
+
+    grib_context_free(c, values);
+    return h;
+}
+
+int main(int argc, char* argv[])
+{
+    grib_context* c       = grib_context_get_default();
+    grib_handle* h        = NULL;
+    const void* message   = NULL;
+    size_t size           = 0;
+    int repeat            = 0;
+    int count             = 0;
+    long numberOfSubsets  = 5000;
+    long numberOfChannels = 100;
+    grib_timer* tds;
+
+    if (argc < 2) usage(argv[0]);
+    repeat = atoi(argv[1]);
+    if (repeat < 1) usage(argv[0]);
+    if (argc > 2) numberOfSubsets = atol(argv[2]);
+    if (argc > 3) numberOfChannels = atol(argv[3]);
+    if (numberOfSubsets < 1 || numberOfChannels < 1 || numberOfChannels > 255) usage(argv[0]);
+
+    h = create_radiances(c, numberOfSubsets, numberOfChannels);
+    GRIB_CHECK(grib_get_message(h, &message, &size), 0);
+
+    tds = grib_get_timer(c, "decoding compressed", 0, 0);
+    for (count = 0; count < repeat; count++) {
+        grib_handle* hd = grib_handle_new_from_message(c, message, size);
+        ECCODES_ASSERT(hd);
+        grib_timer_start(tds);
+        GRIB_CHECK(grib_set_long(hd, "unpack", 1), 0);
+        grib_timer_stop(tds, 0);
+        grib_handle_delete(hd);
+    }
+
+    printf("--------------------------------\n");
+    printf("- numberOfSubsets=%ld numberOfChannels=%ld size=%zu\n", numberOfSubsets, numberOfChannels, size);
+    print_timer(tds, repeat);
+
+    grib_handle_delete(h);
+    return 0;
+}
+#else
+
+int main(int argc, char* argv[])
+{
+    return 0;
+}
+
+#endif
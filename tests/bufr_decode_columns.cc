@@ -0,0 +1,171 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+#include "eccodes.h"
+#include <math.h>
+#include <string.h>
+#undef NDEBUG
+#include <assert.h>
+
+#define NUM_CODES 4
+
+// Check the columns decoded without keys against the values of the ranked keys
+// e.g. #1#latitude, #2#latitude etc. once the message is unpacked
+static void check_column(codes_handle* h, const char* name, const double* column, size_t length, long compressed, long num_subsets)
+{
+    char key[128] = {0,};
+    size_t n = 0, count = 0;
+    int rank = 0;
+
+    // Number of occurrences
+    for (rank = 1;; ++rank) {
+        snprintf(key, sizeof(key), "#%d#%s", rank, name);
+        if (codes_get_size(h, key, &n) != CODES_SUCCESS) break;
+        count += compressed ? num_subsets : n;
+    }
+    const int num_ranks = rank - 1;
+    assert(count == length);
+
+    for (rank = 1; rank <= num_ranks; ++rank) {
+        double* values = NULL;
+        snprintf(key, sizeof(key), "#%d#%s", rank, name);
+        CODES_CHECK(codes_get_size(h, key, &n), 0);
+        values = (double*)malloc(n * sizeof(double));
+        CODES_CHECK(codes_get_double_array(h, key, values, &n), 0);
+        if (compressed) {
+            for (long s = 0; s < num_subsets; ++s) {
+                const double expected = values[n == 1 ? 0 : s];
+                assert(column[s * num_ranks + rank - 1] == expected);
+            }
+        }
+        else {
+            assert(n == 1);
+            assert(column[rank - 1] == values[0]);
+        }
+        free(values);
+    }
+}
+
+// A message with a string descriptor, the columns of which cannot be decoded as numbers
+static void check_string_descriptor(long string_code)
+{
+    const long descriptors[] = { string_code, 5001 };
+    const long latitude      = 5001;
+    codes_handle* h          = codes_bufr_handle_new_from_samples(NULL, "BUFR4");
+    double* column           = NULL;
+    size_t len               = 0;
+    assert(h);
+
+    CODES_CHECK(codes_set_long_array(h, "unexpandedDescriptors", descriptors, 2), 0);
+    len = strlen("READING");
+    CODES_CHECK(codes_set_string(h, "stationOrSiteName", "READING", &len), 0);
+    CODES_CHECK(codes_set_double(h, "latitude", 51.44), 0);
+    CODES_CHECK(codes_set_long(h, "pack", 1), 0);
+
+    len = 0;
+    assert(codes_bufr_decode_columns(h, &string_code, 1, NULL, &len) == CODES_WRONG_TYPE);
+
+    len = 0;
+    CODES_CHECK(codes_bufr_decode_columns(h, &latitude, 1, NULL, &len), 0);
+    assert(len == 1);
+    column = (double*)malloc(len * sizeof(double));
+    CODES_CHECK(codes_bufr_decode_columns(h, &latitude, 1, &column, &len), 0);
+    assert(len == 1 && fabs(column[0] - 51.44) < 1e-9);
+
+    free(column);
+    codes_handle_delete(h);
+}
+
+static int has_descriptor(codes_handle* h, long code)
+{
+    long* descriptors = NULL;
+    size_t n = 0, i = 0;
+    int found = 0;
+
+    CODES_CHECK(codes_get_size(h, "expandedDescriptors", &n), 0);
+    descriptors = (long*)malloc(n * sizeof(long));
+    CODES_CHECK(codes_get_long_array(h, "expandedDescriptors", descriptors, &n), 0);
+    for (i = 0; i < n && !found; ++i)
+        found = (descriptors[i] == code);
+    free(descriptors);
+    return found;
+}
+
+int main(int argc, char* argv[])
+{
+    const long codes[NUM_CODES]        = { 5001, 6001, 12101, 4004 };
+    const char* names[NUM_CODES]       = { "latitude", "longitude", "airTemperature", "hour" };
+    const long string_code             = 1015; // stationOrSiteName
+    FILE* in                           = NULL;
+    codes_handle* h                    = NULL;
+    int err                            = 0;
+
+    assert(argc == 2);
+    check_string_descriptor(string_code);
+
+    in = fopen(argv[1], "rb");
+    assert(in);
+
+    while ((h = codes_handle_new_from_file(NULL, in, PRODUCT_BUFR, &err)) != NULL || err != CODES_SUCCESS) {
+        double* columns[NUM_CODES] = {0,};
+        size_t lengths[NUM_CODES]  = {0,};
+        size_t too_small[NUM_CODES] = {0,};
+        long compressed = 0, num_subsets = 0;
+        size_t i = 0;
+
+        CODES_CHECK(codes_get_long(h, "compressedData", &compressed), 0);
+        CODES_CHECK(codes_get_long(h, "numberOfSubsets", &num_subsets), 0);
+
+        // First count the values then decode them
+        CODES_CHECK(codes_bufr_decode_columns(h, codes, NUM_CODES, NULL, lengths), 0);
+        for (i = 0; i < NUM_CODES; ++i) {
+            columns[i] = (double*)malloc((lengths[i] + 1) * sizeof(double));
+            too_small[i] = lengths[i] ? lengths[i] - 1 : 0;
+        }
+        CODES_CHECK(codes_bufr_decode_columns(h, codes, NUM_CODES, columns, lengths), 0);
+
+        // No data keys have been created
+        assert(codes_is_defined(h, "#1#latitude") == 0);
+
+        // Arrays too small
+        for (i = 0; i < NUM_CODES; ++i) {
+            if (lengths[i]) {
+                err = codes_bufr_decode_columns(h, codes, NUM_CODES, columns, too_small);
+                assert(err == CODES_ARRAY_TOO_SMALL);
+                assert(too_small[i] == lengths[i]);
+                break;
+            }
+        }
+
+        // String descriptors are not supported, absent ones give empty columns
+        {
+            size_t len = 0;
+            err = codes_bufr_decode_columns(h, &string_code, 1, NULL, &len);
+            if (has_descriptor(h, string_code)) {
+                assert(err == CODES_WRONG_TYPE);
+            }
+            else {
+                assert(err == CODES_SUCCESS && len == 0);
+            }
+        }
+
+        // The data keys are still created on request
+        CODES_CHECK(codes_set_long(h, "unpack", 1), 0);
+        for (i = 0; i < NUM_CODES; ++i) {
+            check_column(h, names[i], columns[i], lengths[i], compressed, num_subsets);
+            free(columns[i]);
+        }
+
+        codes_handle_delete(h);
+    }
+    fclose(in);
+
+    return 0;
+}
@@ -0,0 +1,18 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="bufr_decode_columns_test"
+
+# Uncompressed and compressed messages with several subsets
+for f in syno_multi.bufr temp_101.bufr aaen_55.bufr mhen_55.bufr ship_11.bufr; do
+    $EXEC ${test_dir}/bufr_decode_columns ${data_dir}/bufr/$f
+done
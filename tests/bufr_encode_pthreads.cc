@@ -9,6 +9,8 @@
  */
 /*
  * Test for ECC-604: Each thread creates a new BUFR handle, optionaly clone it and/or write it out
+ * With -s the work is repeated with 1, 2, 4, ... up to numThreads threads and the timings are
+ * reported to check how decoding scales with the number of threads
  */
 #include <time.h>
 #include <pthread.h>
@@ -25,6 +27,7 @@ static char* INPUT_FILE           = NULL;
 int opt_dump                      = 0; /* If 1 then dump handle to /dev/null */
 int opt_clone                     = 0; /* If 1 then clone source handle */
 int opt_write                     = 0; /* If 1 write handle to file */
+int opt_scaling                   = 0; /* If 1 time the work for an increasing number of threads */
 
 static int encode_file(char* template_file, char* output_file)
 {
@@ -95,19 +98,70 @@ struct v
 
 void* runner(void* ptr); /* the thread */
 
-int main(int argc, char** argv)
+static void run(size_t num_threads, int parallel)
 {
     size_t i;
     int thread_counter = 0;
+    pthread_t* workers = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
+    for (i = 0; i < num_threads; i++) {
+        struct v* data = (struct v*)malloc(sizeof(struct v));
+        data->number   = i;
+        data->data     = NULL;
+
+        if (parallel) {
+            /* Now we will create the thread passing it data as an argument */
+            pthread_create(&workers[thread_counter], NULL, runner, data);
+            /*pthread_join(workers[thread_counter], NULL);*/
+            thread_counter++;
+        }
+        else {
+            do_stuff(data);
+            free(data);
+        }
+    }
+
+    if (parallel) {
+        for (i = 0; i < num_threads; i++) {
+            pthread_join(workers[i], NULL);
+        }
+    }
+    free(workers);
+}
+
+static double elapsed_seconds(const struct timespec* start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/* Each thread does the same work: with no contention the time stays the same as threads are added */
+static void run_scaling(size_t max_threads)
+{
+    size_t n;
+    double t1 = 0;
+    for (n = 1; n <= max_threads; n *= 2) {
+        struct timespec start;
+        double t;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        run(n, 1);
+        t = elapsed_seconds(&start);
+        if (n == 1) t1 = t;
+        printf("Threads: %3zu  time: %8.3fs  throughput: %6.2fx\n", n, t, t1 * n / t);
+    }
+}
+
+int main(int argc, char** argv)
+{
     int parallel = 1, index = 0, c = 0;
     const char* prog = argv[0];
     char* mode;
-    if (argc < 5 || argc > 7) {
+    if (argc < 5 || argc > 8) {
         fprintf(stderr, "Usage:\n\t%s [options] seq file numRuns numIter\nOr\n\t%s [options] par file numThreads numIter\n", prog, prog);
         return 1;
     }
 
-    while ((c = getopt(argc, argv, "dcw")) != -1) {
+    while ((c = getopt(argc, argv, "dcws")) != -1) {
         switch (c) {
             case 'd':
                 opt_dump = 1;
@@ -118,6 +172,9 @@ int main(int argc, char** argv)
             case 'w':
                 opt_write = 1;
                 break;
+            case 's':
+                opt_scaling = 1;
+                break;
         }
     }
     index               = optind;
@@ -137,31 +194,10 @@ int main(int argc, char** argv)
         printf("Running sequentially in %ld runs. %ld iterations\n", NUM_THREADS, FILES_PER_ITERATION);
     }
 
-    {
-        pthread_t* workers = (pthread_t*)malloc(NUM_THREADS * sizeof(pthread_t));
-        for (i = 0; i < NUM_THREADS; i++) {
-            struct v* data = (struct v*)malloc(sizeof(struct v));
-            data->number   = i;
-            data->data     = NULL;
-
-            if (parallel) {
-                /* Now we will create the thread passing it data as an argument */
-                pthread_create(&workers[thread_counter], NULL, runner, data);
-                /*pthread_join(workers[thread_counter], NULL);*/
-                thread_counter++;
-            }
-            else {
-                do_stuff(data);
-            }
-        }
-
-        if (parallel) {
-            for (i = 0; i < NUM_THREADS; i++) {
-                pthread_join(workers[i], NULL);
-            }
-        }
-        free(workers);
-    }
+    if (parallel && opt_scaling)
+        run_scaling(NUM_THREADS);
+    else
+        run(NUM_THREADS, parallel);
 
     return 0;
 }
@@ -198,5 +234,6 @@ void do_stuff(void* ptr)
     strftime(stime, 32, "%H:%M:%S", &result); /* Try to get milliseconds here too*/
     /* asctime_r(&result, stime); */
 
-    printf("%s: Worker %ld finished.\n", stime, data->number);
+    if (!opt_scaling)
+        printf("%s: Worker %ld finished.\n", stime, data->number);
 }
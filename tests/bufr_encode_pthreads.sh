@@ -52,6 +52,12 @@ process()
     time $PROG -c par $input $NUM_THREADS $NUM_ITER
     # Nothing to validate as there is no output
 }
+scaling()
+{
+    input=$1
+    # Timings of decoding with 1, 2, 4 threads
+    $PROG -s par $input 4 $NUM_ITER
+}
 ###################################################
 rm -fr $temp_dir
 mkdir -p $temp_dir
@@ -64,6 +70,8 @@ for bf in ${bufr_files}; do
     process $b
 done
 
+scaling ${data_dir}/bufr/synop_multi_subset.bufr
+
 # Clean up
 cd $test_dir
 rm -fr $temp_dir
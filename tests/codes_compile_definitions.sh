@@ -0,0 +1,62 @@
+#!/bin/sh
+# (C) Copyright 2005- ECMWF.
+#
+# This software is licensed under the terms of the Apache Licence Version 2.0
+# which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+# virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+#
+
+. ./include.ctest.sh
+
+label="codes_compile_definitions_test"
+tempCache=temp.$label.cache
+tempGrib=temp.$label.grib
+tempDir=temp.$label.dir
+tempRef=temp.$label.ref
+tempOut=temp.$label.out
+
+${tools_dir}/codes_compile_definitions $tempCache
+[ -s $tempCache ]
+
+# Concepts read from the cache are the same as those parsed
+keys="paramId,shortName,name,units,cfVarName,typeOfLevel,stepType"
+for f in GRIB1.tmpl GRIB2.tmpl reduced_gg_pl_32_grib2.tmpl; do
+    ${tools_dir}/grib_get -p $keys $ECCODES_SAMPLES_PATH/$f > $tempRef
+    ECCODES_DEFINITION_CACHE=$tempCache ${tools_dir}/grib_get -p $keys $ECCODES_SAMPLES_PATH/$f > $tempOut
+    diff $tempRef $tempOut
+done
+
+${tools_dir}/grib_set -s paramId=167 $ECCODES_SAMPLES_PATH/GRIB2.tmpl $tempGrib
+result=$(ECCODES_DEFINITION_CACHE=$tempCache ${tools_dir}/grib_get -p shortName $tempGrib)
+[ "$result" = "2t" ]
+
+# A definition file which differs from the one compiled is parsed
+mkdir -p $tempDir/grib2
+sed -e "s/^'2t' = {/'xt2' = {/" $ECCODES_DEFINITION_PATH/grib2/shortName.def > $tempDir/grib2/shortName.def
+result=$(ECCODES_EXTRA_DEFINITION_PATH=`pwd`/$tempDir ECCODES_DEFINITION_CACHE=$tempCache ${tools_dir}/grib_get -p shortName $tempGrib)
+[ "$result" = "xt2" ]
+
+# Missing or invalid cache
+result=$(ECCODES_DEFINITION_CACHE=nonexistent ${tools_dir}/grib_get -p shortName $tempGrib)
+[ "$result" = "2t" ]
+echo "not a cache" > $tempOut
+result=$(ECCODES_DEFINITION_CACHE=$tempOut ${tools_dir}/grib_get -p shortName $tempGrib)
+[ "$result" = "2t" ]
+
+# Failing cases
+set +e
+${tools_dir}/codes_compile_definitions
+status=$?
+set -e
+[ $status -eq 1 ]
+
+set +e
+${tools_dir}/codes_compile_definitions /
+status=$?
+set -e
+[ $status -eq 1 ]
+
+# Clean up
+rm -rf $tempCache $tempGrib $tempDir $tempRef $tempOut
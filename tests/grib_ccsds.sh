@@ -200,5 +200,23 @@ if [ $HAVE_JPEG -eq 1 ]; then
   ${tools_dir}/grib_compare -c data:n $outfile1 $outfile2
 fi
 
+# Random access to single values
+# ------------------------------
+sample_grib2=$ECCODES_SAMPLES_PATH/gg_sfc_grib2.tmpl
+${tools_dir}/grib_set -s packingType=grid_ccsds $sample_grib2 $outfile1
+for i in 0 1 4095 4096 9000 13279; do
+  res1=`${tools_dir}/grib_get -F%.6f -i $i -p shortName $sample_grib2`
+  res2=`${tools_dir}/grib_get -F%.6f -i $i -p shortName $outfile1`
+  [ "$res1" = "$res2" ]
+done
+res1=`${tools_dir}/grib_ls -l 45,0,4 -p shortName $sample_grib2 | grep -v grib2`
+res2=`${tools_dir}/grib_ls -l 45,0,4 -p shortName $outfile1 | grep -v grib2`
+[ "$res1" = "$res2" ]
+set +e
+${tools_dir}/grib_get -i 13280 -p shortName $outfile1 > $logfile 2>&1
+status=$?
+set -e
+[ $status -ne 0 ]
+
 # Clean up
 rm -f $outfile1 $outfile2 $logfile
@@ -0,0 +1,125 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+/*
+ * Encoding/decoding timings for grid_simple on an octahedral O1280 field (6599680 points)
+ * Build with -DENABLE_TIMER=ON
+ */
+
+#include "grib_api_internal.h"
+
+#if ECCODES_TIMER
+
+static void usage(const char* prog)
+{
+    printf("usage: %s repetitions [bitsPerValue ...]\n", prog);
+    exit(1);
+}
+
+static void print_timer(grib_timer* t, int repeat)
+{
+    printf("%s : %g cpu\n", t->name_, t->timer_ / repeat);
+}
+
+/* Octahedral reduced Gaussian grid: 20 points on the row nearest the pole, 4 more on each following row */
+static grib_handle* create_octahedral_field(grib_context* c, long N, double** values, size_t* nvalues)
+{
+    long* pl         = (long*)grib_context_malloc(c, 2 * N * sizeof(long));
+    size_t numPoints = 0;
+    grib_handle* h   = grib_handle_new_from_samples(c, "reduced_gg_pl_1280_grib2");
+    long i;
+
+    ECCODES_ASSERT(h);
+    for (i = 0; i < N; i++) {
+        pl[i] = pl[2 * N - 1 - i] = 20 + 4 * i;
+    }
+    for (i = 0; i < 2 * N; i++)
+        numPoints += pl[i];
+
+    GRIB_CHECK(grib_set_long(h, "N", N), 0);
+    GRIB_CHECK(grib_set_long_array(h, "pl", pl, 2 * N), 0);
+    GRIB_CHECK(grib_set_long(h, "numberOfDataPoints", numPoints), 0);
+
+    /* Smooth temperature-like field */
+    *values = (double*)grib_context_malloc(c, numPoints * sizeof(double));
+    for (i = 0; i < (long)numPoints; i++)
+        (*values)[i] = 273.15 + 25 * sin(i * 1.0e-4) + 5 * cos(i * 3.0e-3);
+    *nvalues = numPoints;
+
+    grib_context_free(c, pl);
+    return h;
+}
+
+int main(int argc, char* argv[])
+{
+    grib_context* c     = grib_context_get_default();
+    grib_handle* h      = NULL;
+    double* values      = NULL;
+    size_t nvalues      = 0;
+    int repeat          = 0;
+    int count           = 0;
+    int i               = 0;
+    long defaultBpv[]   = { 12, 16, 24 };
+    long* bitsPerValues = defaultBpv;
+    int nbpv            = 3;
+    grib_timer *tes, *tds;
+
+    if (argc < 2) usage(argv[0]);
+    repeat = atoi(argv[1]);
+    if (repeat < 1) usage(argv[0]);
+    if (argc > 2) {
+        nbpv          = argc - 2;
+        bitsPerValues = (long*)grib_context_malloc(c, nbpv * sizeof(long));
+        for (i = 0; i < nbpv; i++)
+            bitsPerValues[i] = atol(argv[i + 2]);
+    }
+
+    h = create_octahedral_field(c, 1280, &values, &nvalues);
+
+    for (i = 0; i < nbpv; i++) {
+        char name[80] = {0,};
+        snprintf(name, sizeof(name), "encoding simple %ld bits", bitsPerValues[i]);
+        tes = grib_get_timer(c, name, 0, 0);
+        snprintf(name, sizeof(name), "decoding simple %ld bits", bitsPerValues[i]);
+        tds = grib_get_timer(c, name, 0, 0);
+
+        GRIB_CHECK(grib_set_long(h, "bitsPerValue", bitsPerValues[i]), 0);
+
+        grib_timer_start(tes);
+        for (count = 0; count < repeat; count++)
+            GRIB_CHECK(grib_set_double_array(h, "values", values, nvalues), 0);
+        grib_timer_stop(tes, 0);
+
+        grib_timer_start(tds);
+        for (count = 0; count < repeat; count++)
+            GRIB_CHECK(grib_get_double_array(h, "values", values, &nvalues), 0);
+        grib_timer_stop(tds, 0);
+
+        printf("--------------------------------\n");
+        printf("- O1280 numberOfValues=%zu bitsPerValue=%ld\n", nvalues, bitsPerValues[i]);
+        print_timer(tes, repeat);
+        print_timer(tds, repeat);
+    }
+
+    grib_handle_delete(h);
+    grib_context_free(c, values);
+    if (bitsPerValues != defaultBpv)
+        grib_context_free(c, bitsPerValues);
+
+    return 0;
+}
+#else
+
+int main(int argc, char* argv[])
+{
+    return 0;
+}
+
+#endif
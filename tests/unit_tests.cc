@@ -9,7 +9,11 @@
  */
 
 #include "grib_api_internal.h"
+#include "grib_bits_any_endian_simple.h"
+#include "geo/nearest/grib_nearest_kdtree.h"
 #include "eccodes.h"
+#include <algorithm>
+#include <string>
 
 #define NUMBER(x) (sizeof(x) / sizeof(x[0]))
 
@@ -94,6 +98,56 @@ static void test_grib_nearest_smaller_ieeefloat()
     check_float_representation(7.85, 7.8499999046325, IEEE_FLOAT);
 }
 
+/* Squared chord length between two points on the unit sphere */
+static double chord2(double lat1, double lon1, double lat2, double lon2)
+{
+    const double d2r = 0.01745329251994329576; /* pi over 180 */
+    const double dx  = cos(lat1 * d2r) * cos(lon1 * d2r) - cos(lat2 * d2r) * cos(lon2 * d2r);
+    const double dy  = cos(lat1 * d2r) * sin(lon1 * d2r) - cos(lat2 * d2r) * sin(lon2 * d2r);
+    const double dz  = sin(lat1 * d2r) - sin(lat2 * d2r);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+static void test_nearest_kdtree()
+{
+    printf("Running %s ...\n", __func__);
+
+    const size_t n = 5000;
+    std::vector<double> lats(n), lons(n);
+    srand(42);
+    for (size_t i = 0; i < n; ++i) {
+        lats[i] = -90.0 + 180.0 * rand() / RAND_MAX;
+        lons[i] = 360.0 * rand() / RAND_MAX;
+    }
+    /* Duplicates must come out in the order of their index */
+    lats[100] = lats[4000] = lats[2000];
+    lons[100] = lons[4000] = lons[2000];
+
+    eccodes::geo_nearest::KdTree tree(lats.data(), lons.data(), n);
+    ECCODES_ASSERT(tree.size() == n);
+    ECCODES_ASSERT(std::is_sorted(tree.sorted_lats().begin(), tree.sorted_lats().end()));
+
+    for (int q = 0; q < 500; ++q) {
+        const double lat = (q == 0) ? lats[2000] : -90.0 + 180.0 * rand() / RAND_MAX;
+        const double lon = (q == 0) ? lons[2000] : -180.0 + 540.0 * rand() / RAND_MAX;
+        size_t found[4] = {0,};
+        ECCODES_ASSERT(tree.find(lat, lon, 4, found) == 4);
+
+        /* Compare with a brute force search */
+        std::vector<size_t> all(n);
+        for (size_t i = 0; i < n; ++i)
+            all[i] = i;
+        std::stable_sort(all.begin(), all.end(), [&](size_t a, size_t b) {
+            return chord2(lat, lon, lats[a], lons[a]) < chord2(lat, lon, lats[b], lons[b]);
+        });
+        for (int k = 0; k < 4; ++k)
+            ECCODES_ASSERT(found[k] == all[k]);
+        if (q == 0) {
+            ECCODES_ASSERT(found[0] == 100 && found[1] == 2000 && found[2] == 4000);
+        }
+    }
+}
+
 static void test_gaussian_latitudes(int order)
 {
     printf("Running %s ...\n", __func__);
@@ -114,6 +168,669 @@ static void test_gaussian_latitudes(int order)
     free(lats);
 }
 
+static void test_gaussian_latitudes_cache()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c    = grib_context_get_default();
+    const int order    = 1100;
+    const int num      = 2 * order;
+    const int nthreads = c->gaussian_threads;
+    double* lats1      = (double*)malloc(sizeof(double) * num);
+    double* lats2      = (double*)malloc(sizeof(double) * num);
+
+    /* Roots shared between threads */
+    grib_gaussian_latitudes_cache_delete(c);
+    c->gaussian_threads = 3;
+    ECCODES_ASSERT(grib_get_gaussian_latitudes(order, lats1) == GRIB_SUCCESS);
+    ECCODES_ASSERT(c->gaussian_latitudes_cache != NULL);
+
+    /* From the cache */
+    c->gaussian_threads = 1;
+    ECCODES_ASSERT(grib_get_gaussian_latitudes(order, lats2) == GRIB_SUCCESS);
+    ECCODES_ASSERT(memcmp(lats1, lats2, sizeof(double) * num) == 0);
+
+    /* Computed again by a single thread */
+    grib_gaussian_latitudes_cache_delete(c);
+    ECCODES_ASSERT(grib_get_gaussian_latitudes(order, lats2) == GRIB_SUCCESS);
+    ECCODES_ASSERT(memcmp(lats1, lats2, sizeof(double) * num) == 0);
+
+    c->gaussian_threads = nthreads;
+    free(lats1);
+    free(lats2);
+}
+
+static void iterate_lats_lons(grib_handle* h, std::vector<double>& lats, std::vector<double>& lons)
+{
+    int err = 0;
+    double lat = 0, lon = 0, value = 0;
+    grib_iterator* iter = grib_iterator_new(h, GRIB_GEOITERATOR_NO_VALUES, &err);
+    ECCODES_ASSERT(!err && iter);
+    lats.clear();
+    lons.clear();
+    while (grib_iterator_next(iter, &lat, &lon, &value)) {
+        lats.push_back(lat);
+        lons.push_back(lon);
+    }
+    grib_iterator_delete(iter);
+}
+
+static void test_iterator_geometry_cache()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c       = grib_context_get_default();
+    const int cache_mb    = c->geometry_cache_size;
+    const char* samples[] = { "reduced_gg_pl_32_grib2", "reduced_gg_pl_48_grib2" };
+    std::vector<double> lats[2], lons[2], cached_lats, cached_lons;
+    char md5[2][64]       = {{0,},};
+
+    /* Reference geometries, not cached */
+    c->geometry_cache_size = 0;
+    for (int k = 0; k < 2; k++) {
+        size_t len     = sizeof(md5[k]);
+        grib_handle* h = grib_handle_new_from_samples(c, samples[k]);
+        ECCODES_ASSERT(h);
+        ECCODES_ASSERT(grib_get_string(h, "md5GridSection", md5[k], &len) == GRIB_SUCCESS);
+        iterate_lats_lons(h, lats[k], lons[k]);
+        grib_handle_delete(h);
+    }
+    ECCODES_ASSERT(!STR_EQUAL(md5[0], md5[1]));
+
+    /* The grids alternate so that each handle must find its own geometry, and the
+     * second pass takes them from the cache after the handles which made them are gone */
+    c->geometry_cache_size = 16;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int k = 0; k < 2; k++) {
+            grib_handle* h = grib_handle_new_from_samples(c, samples[k]);
+            ECCODES_ASSERT(h);
+            iterate_lats_lons(h, cached_lats, cached_lons);
+            ECCODES_ASSERT(c->geometry_cache != NULL);
+            ECCODES_ASSERT(cached_lats == lats[k] && cached_lons == lons[k]);
+            grib_handle_delete(h);
+        }
+    }
+
+    grib_iterator_geometry_cache_delete(c);
+    c->geometry_cache_size = cache_mb;
+}
+
+static void check_values_elements(grib_handle* h)
+{
+    size_t n = 0;
+    double val = 0;
+    ECCODES_ASSERT(grib_get_size(h, "values", &n) == GRIB_SUCCESS);
+    std::vector<double> values(n), elements(n);
+    std::vector<size_t> index(n);
+    ECCODES_ASSERT(grib_get_double_array(h, "values", values.data(), &n) == GRIB_SUCCESS);
+
+    for (size_t i = 0; i < n; i++) {
+        ECCODES_ASSERT(grib_get_double_element(h, "values", i, &val) == GRIB_SUCCESS);
+        ECCODES_ASSERT(val == values[i]);
+        index[i] = n - 1 - i;
+    }
+    ECCODES_ASSERT(grib_get_double_element_set(h, "values", index.data(), n, elements.data()) == GRIB_SUCCESS);
+    for (size_t i = 0; i < n; i++) {
+        ECCODES_ASSERT(elements[i] == values[n - 1 - i]);
+    }
+    ECCODES_ASSERT(grib_get_double_element(h, "values", n, &val) == GRIB_INVALID_ARGUMENT);
+}
+
+static void test_data_apply_bitmap_elements()
+{
+    printf("Running %s ...\n", __func__);
+
+    const char* samples[] = { "reduced_gg_pl_32_grib1", "reduced_gg_pl_32_grib2" };
+    grib_context* c       = grib_context_get_default();
+
+    for (const char* sample : samples) {
+        grib_handle* h = grib_handle_new_from_samples(c, sample);
+        size_t n       = 0;
+        ECCODES_ASSERT(h);
+        ECCODES_ASSERT(grib_get_size(h, "values", &n) == GRIB_SUCCESS);
+        ECCODES_ASSERT(grib_set_long(h, "bitmapPresent", 1) == GRIB_SUCCESS);
+        ECCODES_ASSERT(grib_set_double(h, "missingValue", 9999) == GRIB_SUCCESS);
+
+        /* Runs of missing values across the words of the bitmap index */
+        std::vector<double> values(n);
+        for (size_t i = 0; i < n; i++)
+            values[i] = (i % 7 == 0 || (i / 100) % 3 == 1) ? 9999 : i % 50;
+        ECCODES_ASSERT(grib_set_double_array(h, "values", values.data(), n) == GRIB_SUCCESS);
+        check_values_elements(h);
+
+        /* The index is rebuilt when the bitmap changes */
+        for (size_t i = 0; i < n; i++)
+            values[i] = (i % 3 == 0) ? 9999 : i % 40;
+        ECCODES_ASSERT(grib_set_double_array(h, "values", values.data(), n) == GRIB_SUCCESS);
+        check_values_elements(h);
+
+        grib_handle_delete(h);
+    }
+}
+
+static void test_second_order_elements()
+{
+    printf("Running %s ...\n", __func__);
+
+    struct { const char* sample; const char* packingType; } cases[] = {
+        { "reduced_gg_pl_32_grib2", "grid_complex" },
+        { "reduced_gg_pl_32_grib2", "grid_complex_spatial_differencing" },
+        { "reduced_gg_pl_32_grib1", "grid_second_order_no_SPD" },
+        { "reduced_gg_pl_32_grib1", "grid_second_order_SPD1" },
+        { "reduced_gg_pl_32_grib1", "grid_second_order_SPD2" },
+        { "reduced_gg_pl_32_grib1", "grid_second_order_SPD3" },
+    };
+    grib_context* c = grib_context_get_default();
+
+    for (const auto& t : cases) {
+        for (int with_missing = 0; with_missing < 2; with_missing++) {
+            grib_handle* h = grib_handle_new_from_samples(c, t.sample);
+            size_t n = 0, len = strlen(t.packingType);
+            ECCODES_ASSERT(h);
+            ECCODES_ASSERT(grib_get_size(h, "values", &n) == GRIB_SUCCESS);
+            ECCODES_ASSERT(grib_set_double(h, "missingValue", 9999) == GRIB_SUCCESS);
+            ECCODES_ASSERT(grib_set_long(h, "bitsPerValue", 16) == GRIB_SUCCESS);
+
+            std::vector<double> values(n);
+            for (size_t i = 0; i < n; i++) {
+                values[i] = 280 + 20 * sin(i * 0.01) + (i % 17) * 0.1;
+                if (with_missing && (i % 31 == 0 || (i / 200) % 4 == 1))
+                    values[i] = 9999;
+            }
+            ECCODES_ASSERT(grib_set_double_array(h, "values", values.data(), n) == GRIB_SUCCESS);
+            ECCODES_ASSERT(grib_set_string(h, "packingType", t.packingType, &len) == GRIB_SUCCESS);
+            check_values_elements(h);
+
+            grib_handle_delete(h);
+        }
+    }
+}
+
+static void test_values_cache()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c = grib_context_get_default();
+    grib_handle* h  = grib_handle_new_from_samples(c, "reduced_gg_pl_32_grib2");
+    size_t n = 0, len = 0;
+    double val = 0;
+    ECCODES_ASSERT(h);
+    ECCODES_ASSERT(grib_get_size(h, "values", &n) == GRIB_SUCCESS);
+    std::vector<double> values(n), decoded(n);
+
+    codes_values_cache_on(c);
+    for (size_t i = 0; i < n; i++)
+        values[i] = i % 100;
+    ECCODES_ASSERT(grib_set_double_array(h, "values", values.data(), n) == GRIB_SUCCESS);
+    len = n;
+    ECCODES_ASSERT(grib_get_double_array(h, "values", decoded.data(), &len) == GRIB_SUCCESS);
+    ECCODES_ASSERT(h->values_cache != NULL);
+    ECCODES_ASSERT(decoded == values);
+    ECCODES_ASSERT(grib_get_double_element(h, "values", 42, &val) == GRIB_SUCCESS && val == 42);
+
+    /* A new field and a change of scaling are both seen */
+    for (size_t i = 0; i < n; i++)
+        values[i] = i % 10;
+    ECCODES_ASSERT(grib_set_double_array(h, "values", values.data(), n) == GRIB_SUCCESS);
+    len = n;
+    ECCODES_ASSERT(grib_get_double_array(h, "values", decoded.data(), &len) == GRIB_SUCCESS);
+    ECCODES_ASSERT(decoded == values);
+    ECCODES_ASSERT(grib_set_long(h, "decimalScaleFactor", 1) == GRIB_SUCCESS);
+    ECCODES_ASSERT(grib_get_double_element(h, "values", 9, &val) == GRIB_SUCCESS);
+    ECCODES_ASSERT(fabs(val - 0.9) < 1e-9);
+
+    /* Too small a buffer is still an error */
+    len = n - 1;
+    ECCODES_ASSERT(grib_get_double_array(h, "values", decoded.data(), &len) == GRIB_ARRAY_TOO_SMALL);
+
+    codes_values_cache_off(c);
+    grib_handle_delete(h);
+}
+
+// Accessors sharing their name (e.g. the fields of a multi-field message) are not cached:
+// the values read with and without the cache are the same
+static void test_values_cache_multi_field()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c = grib_context_get_default();
+    grib_handle* h[2] = { grib_handle_new_from_samples(c, "reduced_gg_pl_32_grib2"),
+                          grib_handle_new_from_samples(c, "reduced_gg_pl_32_grib2") };
+    size_t n = 0;
+    ECCODES_ASSERT(h[0] && h[1]);
+    ECCODES_ASSERT(grib_get_size(h[0], "values", &n) == GRIB_SUCCESS);
+    std::vector<double> field(n);
+    for (int k = 0; k < 2; k++) {
+        for (size_t i = 0; i < n; i++)
+            field[i] = k * 1000 + i % 100;
+        ECCODES_ASSERT(grib_set_double_array(h[k], "values", field.data(), n) == GRIB_SUCCESS);
+    }
+
+    // Chain the fields as the parser does for repeated sections: the newest accessor comes first
+    grib_accessor* a = grib_find_accessor(h[1], "values");
+    ECCODES_ASSERT(a && !a->same_);
+    a->same_ = grib_find_accessor(h[0], "values");
+
+    std::vector<double> values[2], elements[2], elements_int[2];
+    std::vector<size_t> index  = { 0, 7, 42, 99, 100 };
+    std::vector<int> index_int = { 0, 7, 42, 99, 100 };
+    for (int cached = 0; cached < 2; cached++) {
+        if (cached)
+            codes_values_cache_on(c);
+        size_t len = 2 * n;
+        values[cached].resize(len);
+        elements[cached].resize(index.size() + 1);
+        elements_int[cached].resize(index.size());
+        // Each getter is called twice, so that the second call can read what the first one stored
+        for (int pass = 0; pass < 2; pass++) {
+            ECCODES_ASSERT(grib_get_double_array(h[1], "values", values[cached].data(), &len) == GRIB_SUCCESS);
+            ECCODES_ASSERT(len == 2 * n);
+            ECCODES_ASSERT(grib_get_double_elements(h[1], "values", index_int.data(), index_int.size(), elements_int[cached].data()) == GRIB_SUCCESS);
+            ECCODES_ASSERT(grib_get_double_element_set(h[1], "values", index.data(), index.size(), elements[cached].data()) == GRIB_SUCCESS);
+            ECCODES_ASSERT(grib_get_double_element(h[1], "values", 42, &elements[cached][index.size()]) == GRIB_SUCCESS);
+        }
+    }
+    ECCODES_ASSERT(values[0] == values[1]);
+    ECCODES_ASSERT(elements[0] == elements[1]);
+    ECCODES_ASSERT(elements_int[0] == elements_int[1]);
+    ECCODES_ASSERT(values[1][42] == 42 && values[1][n + 42] == 1042);
+    ECCODES_ASSERT(elements[1][index.size()] == 1042); // from the newest field
+
+    a->same_ = NULL;
+    codes_values_cache_off(c);
+    grib_handle_delete(h[0]);
+    grib_handle_delete(h[1]);
+}
+
+static void test_statistics()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c = grib_context_get_default();
+    grib_handle* h  = grib_handle_new_from_samples(c, "reduced_gg_pl_32_grib2");
+    const double missing = 9999;
+    size_t n = 0, count = 0;
+    double sum = 0, m2 = 0, m3 = 0, m4 = 0, mean = 0, val = 0, lo = missing, hi = -missing;
+    ECCODES_ASSERT(h);
+    ECCODES_ASSERT(grib_get_size(h, "values", &n) == GRIB_SUCCESS);
+    std::vector<double> values(n);
+
+    /* A field with missing values, over several blocks of the single pass */
+    ECCODES_ASSERT(grib_set_long(h, "bitmapPresent", 1) == GRIB_SUCCESS);
+    ECCODES_ASSERT(grib_set_double(h, "missingValue", missing) == GRIB_SUCCESS);
+    for (size_t i = 0; i < n; i++)
+        values[i] = (i % 7 == 0) ? missing : (double)((i * 37) % 101) - 50;
+    ECCODES_ASSERT(grib_set_double_array(h, "values", values.data(), n) == GRIB_SUCCESS);
+
+    for (size_t i = 0; i < n; i++) {
+        if (values[i] == missing) continue;
+        sum += values[i];
+        if (values[i] < lo) lo = values[i];
+        if (values[i] > hi) hi = values[i];
+        count++;
+    }
+    mean = sum / count;
+    for (size_t i = 0; i < n; i++) {
+        if (values[i] == missing) continue;
+        double d = values[i] - mean;
+        m2 += d * d / count;
+        m3 += d * d * d / count;
+        m4 += d * d * d * d / count;
+    }
+
+    ECCODES_ASSERT(grib_get_double(h, "max", &val) == GRIB_SUCCESS && val == hi);
+    ECCODES_ASSERT(grib_get_double(h, "min", &val) == GRIB_SUCCESS && val == lo);
+    ECCODES_ASSERT(grib_get_double(h, "average", &val) == GRIB_SUCCESS && fabs(val - mean) < 1e-9);
+    ECCODES_ASSERT(grib_get_double(h, "standardDeviation", &val) == GRIB_SUCCESS && fabs(val - sqrt(m2)) < 1e-9);
+    ECCODES_ASSERT(grib_get_double(h, "skewness", &val) == GRIB_SUCCESS && fabs(val - m3 / (m2 * sqrt(m2))) < 1e-9);
+    ECCODES_ASSERT(grib_get_double(h, "kurtosis", &val) == GRIB_SUCCESS && fabs(val - (m4 / (m2 * m2) - 3)) < 1e-9);
+    ECCODES_ASSERT(grib_get_double(h, "numberOfMissing", &val) == GRIB_SUCCESS && val == n - count);
+
+    /* All values missing (ECC-649) */
+    for (size_t i = 0; i < n; i++)
+        values[i] = missing;
+    ECCODES_ASSERT(grib_set_double_array(h, "values", values.data(), n) == GRIB_SUCCESS);
+    ECCODES_ASSERT(grib_get_double(h, "max", &val) == GRIB_SUCCESS && val == missing);
+    ECCODES_ASSERT(grib_get_double(h, "standardDeviation", &val) == GRIB_SUCCESS && val == 0);
+
+    grib_handle_delete(h);
+}
+
+static size_t count_observers(const grib_accessor* observed, const grib_accessor* observer)
+{
+    size_t count = 0;
+    for (const grib_dependency* d = observed->observers_; d; d = d->next_observer)
+        if (d->observer == observer && d->observed == observed) count++;
+    return count;
+}
+
+static void test_dependencies()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c = grib_context_get_default();
+    grib_handle* h  = grib_handle_new_from_samples(c, "GRIB2");
+    ECCODES_ASSERT(h);
+    grib_accessor* observed = grib_find_accessor(h, "centre");
+    grib_accessor* observer = grib_find_accessor(h, "dataDate");
+    ECCODES_ASSERT(observed && observer);
+
+    /* Added once only, and seen from both ends */
+    grib_dependency_add(observer, observed);
+    grib_dependency_add(observer, observed);
+    ECCODES_ASSERT(count_observers(observed, observer) == 1);
+    ECCODES_ASSERT(observer->observing_ && observer->observing_->observed == observed);
+    ECCODES_ASSERT(grib_dependency_notify_change(observed) == GRIB_SUCCESS);
+
+    /* A removed observer is no longer notified */
+    grib_dependency_remove_observer(observer);
+    ECCODES_ASSERT(count_observers(observed, observer) == 0);
+    ECCODES_ASSERT(observer->observing_ == NULL);
+    ECCODES_ASSERT(grib_set_long(h, "centre", 98) == GRIB_SUCCESS);
+
+    grib_dependency_remove_observed(observed);
+    ECCODES_ASSERT(observed->observers_ == NULL);
+
+    grib_handle_delete(h);
+}
+
+static void test_deferred_rebuilds()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c = grib_context_get_default();
+    const void* msg[2];
+    size_t size[2];
+    grib_handle* h[2];
+    long val = 0;
+
+    for (int i = 0; i < 2; i++) {
+        char keys[] = "productDefinitionTemplateNumber=8,productDefinitionTemplateNumber=11,perturbationNumber=3,typeOfFirstFixedSurface=103";
+        grib_values values[8];
+        int count = 8;
+        ECCODES_ASSERT(parse_keyval_string(NULL, keys, 1, GRIB_TYPE_UNDEFINED, values, &count) == GRIB_SUCCESS);
+        if (i) codes_deferred_rebuilds_on(c);
+        h[i] = grib_handle_new_from_samples(c, "GRIB2");
+        ECCODES_ASSERT(h[i]);
+        ECCODES_ASSERT(grib_set_values(h[i], values, count) == GRIB_SUCCESS);
+        ECCODES_ASSERT(h[i]->deferred_count == 0 && h[i]->defer_rebuilds == 0);
+        ECCODES_ASSERT(grib_get_message(h[i], &msg[i], &size[i]) == GRIB_SUCCESS);
+        codes_deferred_rebuilds_off(c);
+    }
+
+    /* Same message whether the sections are rebuilt on every change or once */
+    ECCODES_ASSERT(grib_get_long(h[1], "productDefinitionTemplateNumber", &val) == GRIB_SUCCESS && val == 11);
+    ECCODES_ASSERT(grib_get_long(h[1], "perturbationNumber", &val) == GRIB_SUCCESS && val == 3);
+    ECCODES_ASSERT(size[0] == size[1] && memcmp(msg[0], msg[1], size[0]) == 0);
+
+    grib_handle_delete(h[0]);
+    grib_handle_delete(h[1]);
+
+    /* Within a level of grib_set_values the rebuild is recorded and only run when the level is done */
+    grib_handle* hd = grib_handle_new_from_samples(c, "GRIB2");
+    size_t rebuilt  = 0;
+    ECCODES_ASSERT(hd);
+    hd->values_stack   = 1;
+    hd->defer_rebuilds = 1;
+    ECCODES_ASSERT(grib_dependency_defer_set(hd, "productDefinitionTemplateNumber") == 0);
+    ECCODES_ASSERT(grib_set_long(hd, "productDefinitionTemplateNumber", 11) == GRIB_SUCCESS);
+    ECCODES_ASSERT(hd->deferred_count == 1 && hd->deferred[0].level == 1 && grib_dependency_deferred_pending(hd));
+    ECCODES_ASSERT(grib_get_long(hd, "perturbationNumber", &val) == GRIB_NOT_FOUND);
+    hd->values_stack = 2; /* nothing pending for a nested level */
+    ECCODES_ASSERT(!grib_dependency_deferred_pending(hd));
+    hd->values_stack = 1;
+    ECCODES_ASSERT(grib_dependency_run_deferred_rebuilds(hd, 1, &rebuilt) == GRIB_SUCCESS);
+    ECCODES_ASSERT(rebuilt == 1 && hd->deferred_count == 0);
+    ECCODES_ASSERT(grib_get_long(hd, "perturbationNumber", &val) == GRIB_SUCCESS);
+    hd->values_stack   = 0;
+    hd->defer_rebuilds = 0;
+    grib_handle_delete(hd);
+}
+
+static void test_key_ids()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c = grib_context_get_default();
+    char str[64]    = {0,};
+    size_t len      = sizeof(str);
+    long val = 0, val2 = 0;
+    double dval = 0;
+
+    const int id_short = codes_key_id(c, "shortName");
+    const int id_param = codes_key_id(c, "paramId");
+    const int id_ls    = codes_key_id(c, "ls.shortName");
+    const int id_pdtn  = codes_key_id(c, "productDefinitionTemplateNumber");
+    const int id_pert  = codes_key_id(c, "perturbationNumber");
+    const int id_none  = codes_key_id(c, "thisKeyDoesNotExist");
+    ECCODES_ASSERT(id_short >= 0 && id_param >= 0 && id_ls >= 0 && id_pdtn >= 0 && id_pert >= 0 && id_none >= 0);
+    ECCODES_ASSERT(codes_key_id(c, "shortName") == id_short);
+    ECCODES_ASSERT(id_ls != id_short);
+    ECCODES_ASSERT(codes_key_id(c, "/shortName=2t/paramId") < 0);
+
+    grib_handle* h = grib_handle_new_from_samples(c, "GRIB2");
+    ECCODES_ASSERT(h);
+
+    /* Same values as by name */
+    ECCODES_ASSERT(codes_set_long_by_id(h, id_param, 167) == GRIB_SUCCESS);
+    ECCODES_ASSERT(codes_get_string_by_id(h, id_short, str, &len) == GRIB_SUCCESS && STR_EQUAL(str, "2t"));
+    len = sizeof(str);
+    ECCODES_ASSERT(codes_get_string_by_id(h, id_ls, str, &len) == GRIB_SUCCESS && STR_EQUAL(str, "2t"));
+    ECCODES_ASSERT(codes_get_double_by_id(h, id_param, &dval) == GRIB_SUCCESS && dval == 167);
+
+    /* The ids survive a change of the structure of the message */
+    ECCODES_ASSERT(codes_set_long_by_id(h, id_pdtn, 1) == GRIB_SUCCESS);
+    ECCODES_ASSERT(codes_set_long_by_id(h, id_pert, 5) == GRIB_SUCCESS);
+    ECCODES_ASSERT(codes_get_long_by_id(h, id_pert, &val) == GRIB_SUCCESS && val == 5);
+    ECCODES_ASSERT(grib_get_long(h, "perturbationNumber", &val2) == GRIB_SUCCESS && val2 == val);
+    ECCODES_ASSERT(codes_set_long_by_id(h, id_pdtn, 0) == GRIB_SUCCESS);
+    ECCODES_ASSERT(codes_get_long_by_id(h, id_pert, &val) == GRIB_NOT_FOUND);
+
+    ECCODES_ASSERT(codes_get_long_by_id(h, id_none, &val) == GRIB_NOT_FOUND);
+    ECCODES_ASSERT(codes_get_long_by_id(h, -1, &val) == GRIB_NOT_FOUND);
+    ECCODES_ASSERT(codes_get_long_by_id(h, c->key_refs_count.load(), &val) == GRIB_NOT_FOUND);
+
+    /* Same checks of packingType as by name: a constant field is not changed to second order */
+    const int id_packing = codes_key_id(c, "packingType");
+    len = strlen("grid_second_order");
+    ECCODES_ASSERT(codes_set_string_by_id(h, id_packing, "grid_second_order", &len) == GRIB_SUCCESS);
+    len = sizeof(str);
+    ECCODES_ASSERT(codes_get_string_by_id(h, id_packing, str, &len) == GRIB_SUCCESS && STR_EQUAL(str, "grid_simple"));
+
+    grib_handle_delete(h);
+}
+
+static void test_bufr_elements_table()
+{
+    printf("Running %s ...\n", __func__);
+
+    int err          = 0;
+    grib_handle* h   = codes_bufr_handle_new_from_samples(NULL, "BUFR4");
+    ECCODES_ASSERT(h);
+    grib_accessor* a = grib_find_accessor(h, "elementsTable");
+    ECCODES_ASSERT(a);
+
+    bufr_descriptor* d = accessor_bufr_elements_table_get_descriptor(a, 12101, &err);
+    ECCODES_ASSERT(!err && d);
+    ECCODES_ASSERT(STR_EQUAL(d->shortName, "airTemperature") && STR_EQUAL(d->units, "K"));
+    ECCODES_ASSERT(d->type == BUFR_DESCRIPTOR_TYPE_DOUBLE);
+    ECCODES_ASSERT(d->scale == 2 && d->reference == 0 && d->width == 16 && d->factor == 0.01);
+    grib_context_free(h->context, d);
+
+    /* Element codes which are not in the table */
+    d = accessor_bufr_elements_table_get_descriptor(a, 12255, &err);
+    ECCODES_ASSERT(err == GRIB_NOT_FOUND && d->type == BUFR_DESCRIPTOR_TYPE_UNKNOWN);
+    grib_context_free(h->context, d);
+    err = 0;
+    d   = accessor_bufr_elements_table_get_descriptor(a, 12999, &err);
+    ECCODES_ASSERT(err == GRIB_NOT_FOUND);
+    grib_context_free(h->context, d);
+
+    /* The table kept by the accessor is looked up again once the tables version changes: 001024 is not in version 13 */
+    d = accessor_bufr_elements_table_get_descriptor(a, 1024, &err);
+    ECCODES_ASSERT(!err && STR_EQUAL(d->shortName, "windSpeedSource"));
+    grib_context_free(h->context, d);
+    ECCODES_ASSERT(grib_set_long(h, "masterTablesVersionNumber", 13) == GRIB_SUCCESS);
+    ECCODES_ASSERT(a == grib_find_accessor(h, "elementsTable"));
+    d = accessor_bufr_elements_table_get_descriptor(a, 1024, &err);
+    ECCODES_ASSERT(err == GRIB_NOT_FOUND);
+    grib_context_free(h->context, d);
+    grib_handle_delete(h);
+
+    /* Local elements, see bufr/tables/0/local/1/98/0/element.table */
+    h = codes_bufr_handle_new_from_samples(NULL, "BUFR4_local");
+    ECCODES_ASSERT(h);
+    a   = grib_find_accessor(h, "elementsTable");
+    err = 0;
+    d   = accessor_bufr_elements_table_get_descriptor(a, 1192, &err);
+    ECCODES_ASSERT(err == GRIB_NOT_FOUND);
+    grib_context_free(h->context, d);
+    ECCODES_ASSERT(grib_set_long(h, "bufrHeaderCentre", 98) == GRIB_SUCCESS);
+    ECCODES_ASSERT(grib_set_long(h, "masterTablesVersionNumber", 28) == GRIB_SUCCESS);
+    ECCODES_ASSERT(grib_set_long(h, "localTablesVersionNumber", 1) == GRIB_SUCCESS);
+    a   = grib_find_accessor(h, "elementsTable");
+    err = 0;
+    d   = accessor_bufr_elements_table_get_descriptor(a, 1192, &err);
+    ECCODES_ASSERT(!err && STR_EQUAL(d->shortName, "modelVersionNumber") && STR_EQUAL(d->units, "CODE TABLE"));
+    ECCODES_ASSERT(d->type == BUFR_DESCRIPTOR_TYPE_TABLE && d->width == 8);
+    grib_context_free(h->context, d);
+    /* Master elements are still there */
+    d = accessor_bufr_elements_table_get_descriptor(a, 12101, &err);
+    ECCODES_ASSERT(!err && STR_EQUAL(d->shortName, "airTemperature"));
+    grib_context_free(h->context, d);
+
+    grib_handle_delete(h);
+}
+
+// The accessors of a section and its sub-sections, in order
+static void collect_accessors(grib_section* s, std::vector<grib_accessor*>& accessors)
+{
+    for (grib_accessor* a = s && s->block ? s->block->first : NULL; a; a = a->next_) {
+        accessors.push_back(a);
+        collect_accessors(a->sub_section_, accessors);
+    }
+}
+
+static void test_template_cache()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c = grib_context_get_default();
+    std::vector<grib_accessor*> accessors1, accessors2;
+    int checked = 0;
+
+    /* The second handle takes template.4.11 from the template action */
+    grib_handle* h1 = grib_handle_new_from_samples(c, "GRIB2");
+    grib_handle* h2 = grib_handle_new_from_samples(c, "GRIB2");
+    ECCODES_ASSERT(h1 && h2);
+    ECCODES_ASSERT(grib_set_long(h1, "productDefinitionTemplateNumber", 11) == GRIB_SUCCESS);
+    ECCODES_ASSERT(grib_set_long(h2, "productDefinitionTemplateNumber", 11) == GRIB_SUCCESS);
+    ECCODES_ASSERT(grib_is_defined(h2, "numberOfTimeRanges"));
+
+    collect_accessors(h1->root, accessors1);
+    collect_accessors(h2->root, accessors2);
+    ECCODES_ASSERT(accessors1.size() == accessors2.size());
+    for (size_t i = 0; i < accessors1.size(); i++) {
+        ECCODES_ASSERT(accessors1[i]->creator_ == accessors2[i]->creator_);
+        ECCODES_ASSERT(STR_EQUAL(accessors1[i]->name_, accessors2[i]->name_));
+    }
+
+    /* The key ids remembered by the actions after the rebuilds are those of their names */
+    for (grib_accessor* a : accessors2) {
+        const grib_action* creator = a->creator_;
+        if (!creator || creator->name != a->all_names_[0] || *a->all_names_[0] == '_')
+            continue;
+        const int key_id = creator->key_id.load();
+        if (key_id) {
+            ECCODES_ASSERT(key_id - 1 == grib_hash_keys_get_id(c->keys, a->all_names_[0]));
+            checked++;
+        }
+    }
+    ECCODES_ASSERT(checked > 0);
+
+    grib_handle_delete(h1);
+    grib_handle_delete(h2);
+}
+
+// Change the structure of the message back and forth: the sections rebuilt each time
+static void rebuild_sections(grib_handle* h, int count)
+{
+    for (int i = 0; i < count; i++) {
+        size_t len = 0;
+        const char* packing = (i % 2) ? "grid_ieee" : "grid_simple";
+        len = strlen(packing);
+        ECCODES_ASSERT(grib_set_string(h, "packingType", packing, &len) == GRIB_SUCCESS);
+        ECCODES_ASSERT(grib_set_long(h, "productDefinitionTemplateNumber", (i % 2) ? 1 : 0) == GRIB_SUCCESS);
+    }
+}
+
+static void check_bufr_unpack(grib_context* c, const void* msg, size_t size)
+{
+    char name[64] = {0,};
+    size_t len    = sizeof(name);
+    double lat    = 0;
+
+    grib_handle* h = grib_handle_new_from_message(c, msg, size);
+    ECCODES_ASSERT(h);
+    ECCODES_ASSERT(grib_set_long(h, "unpack", 1) == GRIB_SUCCESS);
+    ECCODES_ASSERT((h->arena != NULL) == (c->handle_arena != 0));
+    ECCODES_ASSERT(grib_get_double(h, "latitude", &lat) == GRIB_SUCCESS && fabs(lat - 51.44) < 1e-9);
+    ECCODES_ASSERT(grib_get_string(h, "stationOrSiteName", name, &len) == GRIB_SUCCESS && STR_EQUAL(name, "READING"));
+    grib_handle_delete(h);
+}
+
+static void test_handle_arena()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c        = grib_context_get_default();
+    const int handle_arena = c->handle_arena;
+    const void* msg        = NULL;
+    size_t size            = 0;
+    size_t len             = 0;
+    long pdtn              = 0;
+
+    /* The accessors and sections freed by a rebuild are reused by the next one:
+     * a hundred rebuilds take less room than the handle itself */
+    c->handle_arena = 1;
+    grib_handle* h  = grib_handle_new_from_samples(c, "GRIB2");
+    ECCODES_ASSERT(h);
+    rebuild_sections(h, 2);
+    ECCODES_ASSERT(h->arena != NULL);
+    const size_t num_chunks = grib_arena_num_chunks(h->arena);
+    rebuild_sections(h, 100);
+    ECCODES_ASSERT(grib_arena_num_chunks(h->arena) < 2 * num_chunks);
+    ECCODES_ASSERT(grib_get_long(h, "productDefinitionTemplateNumber", &pdtn) == GRIB_SUCCESS && pdtn == 1);
+    grib_handle_delete(h);
+
+    /* ECCODES_HANDLE_ARENA=0: everything comes from malloc */
+    c->handle_arena = 0;
+    h               = grib_handle_new_from_samples(c, "GRIB2");
+    ECCODES_ASSERT(h);
+    rebuild_sections(h, 10);
+    ECCODES_ASSERT(h->arena == NULL);
+    ECCODES_ASSERT(grib_get_long(h, "productDefinitionTemplateNumber", &pdtn) == GRIB_SUCCESS && pdtn == 1);
+    grib_handle_delete(h);
+
+    /* BUFR data keys, with and without the arena */
+    h = codes_bufr_handle_new_from_samples(c, "BUFR4");
+    ECCODES_ASSERT(h);
+    ECCODES_ASSERT(grib_set_long(h, "unpack", 1) == GRIB_SUCCESS);
+    ECCODES_ASSERT(grib_set_double(h, "latitude", 51.44) == GRIB_SUCCESS);
+    len = strlen("READING");
+    ECCODES_ASSERT(grib_set_string(h, "stationOrSiteName", "READING", &len) == GRIB_SUCCESS);
+    ECCODES_ASSERT(grib_set_long(h, "pack", 1) == GRIB_SUCCESS);
+    ECCODES_ASSERT(grib_get_message(h, &msg, &size) == GRIB_SUCCESS);
+    for (int i = 0; i < 2; i++) {
+        c->handle_arena = i;
+        for (int k = 0; k < 5; k++)
+            check_bufr_unpack(c, msg, size);
+    }
+    grib_handle_delete(h);
+
+    c->handle_arena = handle_arena;
+}
+
 static void test_grib_get_reduced_row_legacy()
 {
     printf("Running %s ...\n", __func__);
@@ -319,6 +1036,85 @@ static void test_concept_condition_strings()
     grib_handle_delete(h);
 }
 
+static void test_concept_match_index()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c              = grib_context_get_default();
+    grib_concept_value* concepts = NULL;
+    grib_concept_value* last     = NULL;
+    const long nentries          = 40;
+    char name[32];
+
+    // Entries 0..39 test discipline=i%2 and parameterNumber=i/2. Entry 10 only tests parameterNumber
+    for (long i = 0; i < nentries; i++) {
+        grib_concept_condition* cond = grib_concept_condition_new(c, "parameterNumber", new_long_expression(c, i / 2), NULL);
+        if (i != 10)
+            cond->next = grib_concept_condition_new(c, "discipline", new_long_expression(c, i % 2), NULL);
+        snprintf(name, sizeof(name), "%ld", i);
+        grib_concept_value* v = grib_concept_value_new(c, name, cond);
+        if (last) last->next = v;
+        else concepts = v;
+        last = v;
+    }
+
+    grib_concept_match_index* index = grib_concept_match_index_new(c, concepts);
+    ECCODES_ASSERT(index);
+
+    const char* keys[MAX_CONCEPT_INDEX_KEYS];
+    ECCODES_ASSERT(grib_concept_match_index_keys(index, keys) == 2);
+    ECCODES_ASSERT(STR_EQUAL(keys[0], "parameterNumber") && STR_EQUAL(keys[1], "discipline"));
+
+    // Entry 10 does not test all the keys so is a candidate whatever their values, in list order
+    long values[MAX_CONCEPT_INDEX_KEYS] = {3, 0,};
+    size_t count                        = 0;
+    grib_concept_value* const* candidates = grib_concept_match_index_candidates(index, values, &count);
+    ECCODES_ASSERT(count == 2);
+    ECCODES_ASSERT(STR_EQUAL(candidates[0]->name, "6") && STR_EQUAL(candidates[1]->name, "10"));
+
+    values[0]  = 6;
+    values[1]  = 1;
+    candidates = grib_concept_match_index_candidates(index, values, &count);
+    ECCODES_ASSERT(count == 2);
+    ECCODES_ASSERT(STR_EQUAL(candidates[0]->name, "10") && STR_EQUAL(candidates[1]->name, "13"));
+
+    candidates = grib_concept_match_index_candidates(index, NULL, &count);
+    ECCODES_ASSERT(count == 1 && STR_EQUAL(candidates[0]->name, "10"));
+    grib_concept_match_index_delete(c, index);
+
+    // Drop the discipline test from the second half: it is no longer selective enough to be a key.
+    // The last entry now only tests discipline
+    grib_concept_value* v = concepts;
+    for (long i = 0; i < nentries; i++, v = v->next) {
+        if (i >= nentries / 2 && v->conditions->next) {
+            grib_concept_condition_delete(c, v->conditions->next);
+            v->conditions->next = NULL;
+        }
+        if (i == nentries - 1) {
+            grib_concept_condition_delete(c, v->conditions);
+            v->conditions = grib_concept_condition_new(c, "discipline", new_long_expression(c, 0), NULL);
+        }
+    }
+    index = grib_concept_match_index_new(c, concepts);
+    ECCODES_ASSERT(index);
+    ECCODES_ASSERT(grib_concept_match_index_keys(index, keys) == 1);
+    values[0]  = 0;
+    candidates = grib_concept_match_index_candidates(index, values, &count);
+    ECCODES_ASSERT(count == 3);
+    ECCODES_ASSERT(STR_EQUAL(candidates[0]->name, "0") && STR_EQUAL(candidates[1]->name, "1"));
+    ECCODES_ASSERT(STR_EQUAL(candidates[2]->name, "39"));
+    values[0]  = 1000;
+    candidates = grib_concept_match_index_candidates(index, values, &count);
+    ECCODES_ASSERT(count == 1 && STR_EQUAL(candidates[0]->name, "39"));
+    grib_concept_match_index_delete(c, index);
+
+    while (concepts) {
+        grib_concept_value* n = concepts->next;
+        grib_concept_value_delete(c, concepts);
+        concepts = n;
+    }
+}
+
 static void test_string_trimming()
 {
     printf("Running %s ...\n", __func__);
@@ -482,6 +1278,155 @@ static void test_grib_binary_search()
     ECCODES_ASSERT(idx_lower == 1 && idx_upper == 2);
 }
 
+// Slow reference: read one bit at a time
+static unsigned long decode_bits_reference(const unsigned char* p, long bitp, long nbits)
+{
+    unsigned long lvalue = 0;
+    for (long j = 0; j < nbits; j++) {
+        lvalue <<= 1;
+        if (grib_get_bit(p, bitp + j)) lvalue += 1;
+    }
+    return lvalue;
+}
+
+template <typename T>
+static void check_decode_array(const unsigned char* buf, long bitp, long bpv, size_t n_vals)
+{
+    const double reference_value = -273.15, s = 0.125, d = 0.1;
+    T* val   = (T*)malloc(n_vals * sizeof(T));
+    long pos = bitp;
+
+    grib_decode_array<T>(buf, &pos, bpv, reference_value, s, d, n_vals, val);
+    ECCODES_ASSERT(pos == bitp + bpv * (long)n_vals);
+    for (size_t i = 0; i < n_vals; i++) {
+        const unsigned long lvalue = decode_bits_reference(buf, bitp + i * bpv, bpv);
+        const T expected           = ((lvalue * s) + reference_value) * d;
+        ECCODES_ASSERT(memcmp(&val[i], &expected, sizeof(T)) == 0);
+    }
+    free(val);
+}
+
+static void test_grib_decode_array()
+{
+    printf("Running %s ...\n", __func__);
+
+    const size_t counts[] = { 1, 2, 7, 64, 1001 };
+    srand(1);
+    for (long bpv = 1; bpv <= 64; bpv++) {
+        for (long bitp = 0; bitp < 8; bitp++) {
+            for (size_t k = 0; k < NUMBER(counts); k++) {
+                const size_t n_vals = counts[k];
+                // Exact size so any read past the end of the packed data shows up under valgrind/ASan
+                const size_t nbytes = (bitp + bpv * n_vals + 7) / 8;
+                unsigned char* buf  = (unsigned char*)malloc(nbytes);
+                for (size_t i = 0; i < nbytes; i++)
+                    buf[i] = rand() & 0xff;
+                check_decode_array<double>(buf, bitp, bpv, n_vals);
+                check_decode_array<float>(buf, bitp, bpv, n_vals);
+                free(buf);
+            }
+        }
+    }
+}
+
+// Compare with the sequential decoder, including the all-ones (missing) values. Widths of more than
+// GRIB_DECODE_WINDOW_MAX_BITS bits are read by grib_decode_bits_at
+static void test_grib_decode_each()
+{
+    printf("Running %s ...\n", __func__);
+
+    const size_t n_vals = 37;
+    srand(2);
+    for (long bpv = 1; bpv <= 63; bpv++) {
+        const unsigned long all_ones = (1UL << bpv) - 1;
+        for (long bitp = 0; bitp < 8; bitp++) {
+            const size_t nbytes    = (bitp + bpv * n_vals + 7) / 8;
+            unsigned char* buf     = (unsigned char*)calloc(nbytes, 1);
+            unsigned long* encoded = (unsigned long*)malloc(n_vals * sizeof(unsigned long));
+            long pos               = bitp;
+            size_t count           = 0;
+
+            for (size_t i = 0; i < n_vals; i++) {
+                const unsigned long r = ((unsigned long)rand() << 31) ^ ((unsigned long)rand() << 62) ^ rand();
+                encoded[i]            = (i % 3 == 0) ? all_ones : (r & all_ones);
+                grib_encode_unsigned_longb(buf, encoded[i], &pos, bpv);
+            }
+
+            pos = bitp;
+            grib_decode_each(buf, bitp, bpv, n_vals, [&](size_t i, unsigned long lvalue) {
+                ECCODES_ASSERT(i == count++);
+                ECCODES_ASSERT(lvalue == encoded[i]);
+                ECCODES_ASSERT(lvalue == grib_decode_size_t(buf, &pos, bpv));
+            });
+            ECCODES_ASSERT(count == n_vals);
+            ECCODES_ASSERT(pos == bitp + bpv * (long)n_vals);
+
+            free(encoded);
+            free(buf);
+        }
+    }
+}
+
+static void test_grib_encode_double_array()
+{
+    printf("Running %s ...\n", __func__);
+
+    const double reference_value = -10.0, d = 100.0, divisor = 0.25;
+    const size_t n_vals          = 333;
+    double* values               = (double*)malloc(n_vals * sizeof(double));
+    srand(2);
+    for (long bpv = 1; bpv <= 63; bpv++) {
+        const double range = pow(2.0, bpv) - 1;
+        for (size_t i = 0; i < n_vals; i++)
+            values[i] = ((rand() / (double)RAND_MAX) * range / divisor + reference_value) / d;
+        for (long bitp = 0; bitp < 8; bitp++) {
+            if (bpv % 8 == 0 && bitp > 0) continue; // octet-aligned widths always start on an octet
+            const size_t nbytes     = (bitp + bpv * n_vals + 7) / 8;
+            unsigned char* expected = (unsigned char*)malloc(nbytes);
+            unsigned char* actual   = (unsigned char*)malloc(nbytes);
+            long off_expected = bitp, off_actual = bitp;
+            // Bits outside the encoded range must survive
+            memset(expected, 0xa5, nbytes);
+            memset(actual, 0xa5, nbytes);
+            for (size_t i = 0; i < n_vals; i++) {
+                const unsigned long v = (unsigned long)((((values[i] * d) - reference_value) * divisor) + 0.5);
+                grib_encode_unsigned_longb(expected, v, &off_expected, bpv);
+            }
+            grib_encode_double_array(n_vals, values, bpv, reference_value, d, divisor, actual, &off_actual);
+            ECCODES_ASSERT(off_actual == off_expected);
+            ECCODES_ASSERT(memcmp(actual, expected, nbytes) == 0);
+            free(expected);
+            free(actual);
+        }
+    }
+    free(values);
+}
+
+static void test_grib_get_min_max()
+{
+    printf("Running %s ...\n", __func__);
+
+    double min = 0, max = 0;
+    const double vals1[] = { 3, -1, 7, 2, 7.5, -4, 0 };
+    grib_get_min_max(vals1, NUMBER(vals1), &min, &max);
+    ECCODES_ASSERT(min == -4 && max == 7.5);
+    grib_get_min_max(vals1, 1, &min, &max);
+    ECCODES_ASSERT(min == 3 && max == 3);
+
+    // First of two equal zeros is returned, as with a scalar scan
+    const double vals2[] = { -0.0, -3, 0.0, -2, -1, -5, -6, 0.0 };
+    grib_get_min_max(vals2, NUMBER(vals2), &min, &max);
+    ECCODES_ASSERT(min == -6 && max == 0 && signbit(max));
+
+    // NaNs are skipped unless they come first
+    const double vals3[] = { 1, NAN, 5, NAN, -2 };
+    grib_get_min_max(vals3, NUMBER(vals3), &min, &max);
+    ECCODES_ASSERT(min == -2 && max == 5);
+    const double vals4[] = { NAN, 1, 5, 9, -2 };
+    grib_get_min_max(vals4, NUMBER(vals4), &min, &max);
+    ECCODES_ASSERT(isnan(min) && isnan(max));
+}
+
 static void test_parse_keyval_string()
 {
     printf("Running %s ...\n", __func__);
@@ -871,6 +1816,238 @@ static void test_grib_get_binary_scale_fact()
     ECCODES_ASSERT(result == 0);
 }
 
+static void test_io_mmap()
+{
+    printf("Running %s ...\n", __func__);
+    grib_context* c   = grib_context_get_default();
+    const char* fname = "unit_tests_io_mmap.grib";
+    const void* msg   = NULL;
+    size_t size       = 0;
+    long centre       = 0;
+    int err           = 0;
+
+    grib_handle* h = grib_handle_new_from_samples(c, "GRIB2");
+    ECCODES_ASSERT(h);
+    GRIB_CHECK(grib_get_message(h, &msg, &size), 0);
+    FILE* f = fopen(fname, "wb");
+    ECCODES_ASSERT(f);
+    fwrite(msg, 1, size, f);
+    fwrite(msg, 1, size, f);
+    fclose(f);
+    grib_handle_delete(h);
+
+    codes_io_mmap_on(c);
+    f = fopen(fname, "rb");
+    grib_handle* h1 = grib_handle_new_from_file(c, f, &err);
+    ECCODES_ASSERT(h1 && h1->mapped_file);
+    GRIB_CHECK(grib_set_long(h1, "centre", 80), 0);
+
+    // Read again while the first handle is alive: the second copy is mapped, the first one is not
+    rewind(f);
+    grib_handle* h2 = grib_handle_new_from_file(c, f, &err);
+    grib_handle* h3 = grib_handle_new_from_file(c, f, &err);
+    ECCODES_ASSERT(h2 && !h2->mapped_file);
+    ECCODES_ASSERT(h3 && h3->mapped_file == h1->mapped_file);
+    GRIB_CHECK(grib_get_long(h2, "centre", &centre), 0);
+    ECCODES_ASSERT(centre == 98);
+    GRIB_CHECK(grib_get_long(h1, "centre", &centre), 0);
+    ECCODES_ASSERT(centre == 80);
+
+    grib_handle_delete(h1);
+    grib_handle_delete(h2);
+    grib_handle_delete(h3);
+    fclose(f);
+    codes_io_mmap_off(c);
+    remove(fname);
+}
+
+static int foreach_check_order(grib_handle* h, int index, void* data)
+{
+    int* next  = (int*)data;
+    long value = 0;
+    GRIB_CHECK(grib_get_long(h, "forecastTime", &value), 0);
+    ECCODES_ASSERT(value == index);
+    ECCODES_ASSERT(*next == index);
+    (*next)++;
+    return 0;
+}
+
+static int foreach_sum(grib_handle* h, int index, void* data)
+{
+    long value = 0;
+    GRIB_CHECK(grib_get_long(h, "forecastTime", &value), 0);
+    ECCODES_ASSERT(value == index);
+    ((std::atomic<long>*)data)->fetch_add(value);
+    return 0;
+}
+
+static int foreach_stop(grib_handle* h, int index, void* data)
+{
+    (*(int*)data)++;
+    return index == 10 ? GRIB_INTERNAL_ERROR : 0;
+}
+
+static void test_file_parallel_foreach()
+{
+    printf("Running %s ...\n", __func__);
+    grib_context* c   = grib_context_get_default();
+    const char* fname = "unit_tests_parallel_foreach.grib";
+    const int count   = 50;
+    const void* msg   = NULL;
+    size_t size       = 0;
+    int next          = 0;
+    std::atomic<long> sum{0};
+
+    grib_handle* h = grib_handle_new_from_samples(c, "GRIB2");
+    ECCODES_ASSERT(h);
+    FILE* f = fopen(fname, "wb");
+    ECCODES_ASSERT(f);
+    for (int i = 0; i < count; i++) {
+        GRIB_CHECK(grib_set_long(h, "forecastTime", i), 0);
+        GRIB_CHECK(grib_get_message(h, &msg, &size), 0);
+        fwrite(msg, 1, size, f);
+    }
+    fclose(f);
+    grib_handle_delete(h);
+
+    GRIB_CHECK(codes_file_parallel_foreach(c, fname, PRODUCT_GRIB, 4, /*ordered=*/1, foreach_check_order, &next), 0);
+    ECCODES_ASSERT(next == count);
+
+    GRIB_CHECK(codes_file_parallel_foreach(c, fname, PRODUCT_GRIB, 4, /*ordered=*/0, foreach_sum, &sum), 0);
+    ECCODES_ASSERT(sum.load() == count * (count - 1) / 2);
+
+    // The first error stops the processing of the file
+    next = 0;
+    ECCODES_ASSERT(codes_file_parallel_foreach(c, fname, PRODUCT_GRIB, 4, /*ordered=*/1, foreach_stop, &next) == GRIB_INTERNAL_ERROR);
+    ECCODES_ASSERT(next == 11);
+
+    ECCODES_ASSERT(codes_file_parallel_foreach(c, "nonexistent.grib", PRODUCT_GRIB, 4, 0, foreach_sum, &sum) != 0);
+    remove(fname);
+}
+
+// The value of a key as the index stores it, "undef" when the message does not have the key
+static std::string index_key_value(grib_handle* h, const char* name, int type)
+{
+    char buf[1024] = {0,};
+    size_t len     = sizeof(buf);
+    long lval      = 0;
+    int err        = 0;
+
+    if (type == GRIB_TYPE_LONG) {
+        err = grib_get_long(h, name, &lval);
+        snprintf(buf, sizeof(buf), "%ld", lval);
+    }
+    else {
+        err = grib_get_string(h, name, buf, &len);
+    }
+    if (err == GRIB_NOT_FOUND)
+        return "undef";
+    ECCODES_ASSERT(err == GRIB_SUCCESS);
+    return buf;
+}
+
+static void test_index_lookup()
+{
+    printf("Running %s ...\n", __func__);
+
+    grib_context* c          = grib_context_get_default();
+    const char* fname        = "unit_tests_index_lookup.grib";
+    const char* names[]      = { "shortName", "scaledValueOfFirstFixedSurface", "perturbationNumber" };
+    const int types[]        = { GRIB_TYPE_STRING, GRIB_TYPE_LONG, GRIB_TYPE_LONG };
+    const long param_ids[]   = { 130, 131, 132 };
+    const int count          = 48;
+    std::vector<std::vector<std::string>> message_values;
+    std::vector<long> offsets;
+    const void* msg = NULL;
+    size_t size     = 0;
+    int err         = 0;
+
+    // Perturbation numbers only in the messages with PDTN 1, some missing levels
+    grib_handle* h = grib_handle_new_from_samples(c, "GRIB2");
+    ECCODES_ASSERT(h);
+    FILE* f = fopen(fname, "wb");
+    ECCODES_ASSERT(f);
+    for (int i = 0; i < count; i++) {
+        GRIB_CHECK(grib_set_long(h, "paramId", param_ids[i % 3]), 0);
+        GRIB_CHECK(grib_set_long(h, "productDefinitionTemplateNumber", i % 2), 0);
+        if (i % 2)
+            GRIB_CHECK(grib_set_long(h, "perturbationNumber", i % 5), 0);
+        if (i % 7 == 0)
+            GRIB_CHECK(grib_set_missing(h, "scaledValueOfFirstFixedSurface"), 0);
+        else
+            GRIB_CHECK(grib_set_long(h, "scaledValueOfFirstFixedSurface", (i / 3) % 4), 0);
+        GRIB_CHECK(grib_get_message(h, &msg, &size), 0);
+        fwrite(msg, 1, size, f);
+    }
+    fclose(f);
+    grib_handle_delete(h);
+
+    // The values of the keys message by message, as the selection used to scan for them
+    f = fopen(fname, "rb");
+    ECCODES_ASSERT(f);
+    while ((h = grib_handle_new_from_file(c, f, &err)) != NULL) {
+        long offset = 0;
+        std::vector<std::string> values;
+        for (size_t k = 0; k < NUMBER(names); k++)
+            values.push_back(index_key_value(h, names[k], types[k]));
+        GRIB_CHECK(grib_get_long(h, "offset", &offset), 0);
+        message_values.push_back(values);
+        offsets.push_back(offset);
+        grib_handle_delete(h);
+    }
+    fclose(f);
+    ECCODES_ASSERT(message_values.size() == (size_t)count);
+
+    grib_index* index = grib_index_new(c, "shortName,scaledValueOfFirstFixedSurface:l,perturbationNumber:l", &err);
+    ECCODES_ASSERT(!err && index);
+    GRIB_CHECK(grib_index_add_file(index, fname), 0);
+
+    // Every combination of the values of the keys, plus one which is in no message
+    std::vector<std::string> key_values[NUMBER(names)];
+    for (size_t k = 0; k < NUMBER(names); k++) {
+        size_t n = 0;
+        GRIB_CHECK(grib_index_get_size(index, names[k], &n), 0);
+        std::vector<char*> values(n);
+        GRIB_CHECK(grib_index_get_string(index, names[k], values.data(), &n), 0);
+        for (char* v : values) {
+            key_values[k].push_back(v);
+            grib_context_free(c, v);
+        }
+        key_values[k].push_back("999");
+    }
+    ECCODES_ASSERT(std::find(key_values[1].begin(), key_values[1].end(), std::to_string(GRIB_MISSING_LONG)) != key_values[1].end());
+    ECCODES_ASSERT(std::find(key_values[2].begin(), key_values[2].end(), "undef") != key_values[2].end());
+
+    size_t num_found = 0;
+    for (const std::string& v0 : key_values[0]) {
+        for (const std::string& v1 : key_values[1]) {
+            for (const std::string& v2 : key_values[2]) {
+                std::vector<long> expected, found;
+                for (int i = 0; i < count; i++) {
+                    if (message_values[i][0] == v0 && message_values[i][1] == v1 && message_values[i][2] == v2)
+                        expected.push_back(offsets[i]);
+                }
+                GRIB_CHECK(grib_index_select_string(index, names[0], v0.c_str()), 0);
+                GRIB_CHECK(grib_index_select_string(index, names[1], v1.c_str()), 0);
+                GRIB_CHECK(grib_index_select_string(index, names[2], v2.c_str()), 0);
+                while ((h = grib_handle_new_from_index(index, &err)) != NULL) {
+                    long offset = 0;
+                    GRIB_CHECK(grib_get_long(h, "offset", &offset), 0);
+                    found.push_back(offset);
+                    grib_handle_delete(h);
+                }
+                ECCODES_ASSERT(err == GRIB_END_OF_INDEX);
+                ECCODES_ASSERT(found == expected);
+                num_found += found.size();
+            }
+        }
+    }
+    ECCODES_ASSERT(num_found == (size_t)count);
+
+    grib_index_delete(index);
+    remove(fname);
+}
+
 static void test_filepool()
 {
     printf("Running %s ...\n", __func__);
@@ -903,6 +2080,10 @@ int main(int argc, char** argv)
     test_logging_proc();
     test_print_proc();
     test_grib_binary_search();
+    test_grib_decode_array();
+    test_grib_decode_each();
+    test_grib_encode_double_array();
+    test_grib_get_min_max();
     test_parse_keyval_string();
 
     test_get_git_sha1();
@@ -914,6 +2095,7 @@ int main(int argc, char** argv)
     test_data_quality_checks();
 
     test_concept_condition_strings();
+    test_concept_match_index();
 
     test_assertion_catching();
 
@@ -933,9 +2115,23 @@ int main(int argc, char** argv)
     test_gaussian_latitudes(1024);
     test_gaussian_latitudes(1280);
     test_gaussian_latitudes(2000);
+    test_gaussian_latitudes_cache();
+    test_iterator_geometry_cache();
+    test_data_apply_bitmap_elements();
+    test_second_order_elements();
+    test_values_cache();
+    test_values_cache_multi_field();
+    test_statistics();
+    test_dependencies();
+    test_deferred_rebuilds();
+    test_key_ids();
+    test_bufr_elements_table();
+    test_template_cache();
+    test_handle_arena();
 
     test_grib_nearest_smaller_ibmfloat();
     test_grib_nearest_smaller_ieeefloat();
+    test_nearest_kdtree();
 
     test_string_splitting();
     test_string_ends_with();
@@ -948,7 +2144,10 @@ int main(int argc, char** argv)
     test_grib2_choose_PDTN();
     test_codes_is_feature_enabled();
     test_codes_get_features();
+    test_io_mmap();
+    test_file_parallel_foreach();
     test_filepool();
+    test_index_lookup();
 
     return 0;
 }
@@ -0,0 +1,39 @@
+/*
+ * (C) Copyright 2005- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities granted to it by
+ * virtue of its status as an intergovernmental organisation nor does it submit to any jurisdiction.
+ */
+
+#include "grib_api_internal.h"
+
+static void usage(const char* prog)
+{
+    printf("Usage: %s out_file\n", prog);
+    printf("       Write the parsed definition files found on the definitions path to out_file.\n");
+    printf("       Point the environment variable ECCODES_DEFINITION_CACHE to out_file to use it.\n");
+    printf("\n");
+    printf("       E.g., %s /path/to/definitions.cache\n", prog);
+    exit(1);
+}
+
+int main(int argc, char* argv[])
+{
+    grib_context* c = grib_context_get_default();
+    size_t count    = 0;
+    int err         = 0;
+
+    if (argc != 2) usage(argv[0]);
+
+    err = grib_definitions_cache_compile(c, argv[1], &count);
+    if (err) {
+        fprintf(stderr, "Error: Failed to compile definitions to '%s' (%s)\n", argv[1], grib_get_error_message(err));
+        return 1;
+    }
+
+    printf("Compiled %zu definition files to '%s'.\n", count, argv[1]);
+    return 0;
+}